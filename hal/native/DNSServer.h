@@ -0,0 +1,12 @@
+#pragma once
+#include "IPAddress.h"
+
+enum class DNSReplyCode { NoError = 0, ServerFailure = 2, NonExistentDomain = 3 };
+
+class DNSServer {
+public:
+    void setErrorReplyCode(DNSReplyCode code) { (void)code; }
+    bool start(uint16_t port, const String& domain, const IPAddress& ip) { (void)port; (void)domain; (void)ip; return true; }
+    void stop() {}
+    void processNextRequest() {}
+};
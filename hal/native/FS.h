@@ -0,0 +1,56 @@
+#pragma once
+// Files on a host directory (halSetFsRoot); File handles share one FILE* like the real ones.
+#include <memory>
+#include "Arduino.h"
+
+namespace fs {
+
+class File {
+    std::shared_ptr<FILE> _f;
+    String _name;
+
+public:
+    File() {}
+    File(FILE* f, const String& name) : _f(f, fclose), _name(name) {}
+
+    operator bool() const { return (bool)_f; }
+    size_t size() const;
+    String name() const { return _name; }
+    void close() { _f.reset(); }
+    void flush() { if (_f) fflush(_f.get()); }
+
+    size_t write(const uint8_t* buf, size_t n) { return _f ? fwrite(buf, 1, n, _f.get()) : 0; }
+    size_t write(uint8_t c) { return write(&c, 1); }
+    size_t print(const String& s) { return write((const uint8_t*)s.c_str(), s.length()); }
+    size_t print(const char* s) { return write((const uint8_t*)s, strlen(s)); }
+    size_t println(const String& s) { return print(s) + print("\n"); }
+    size_t printf(const char* fmt, ...) __attribute__((format(printf, 2, 3)));
+
+    int read() { return _f ? fgetc(_f.get()) : -1; }
+    size_t read(uint8_t* buf, size_t n) { return _f ? fread(buf, 1, n, _f.get()) : 0; }
+    size_t readBytes(char* buf, size_t n) { return read((uint8_t*)buf, n); }
+    String readString();
+    int available();
+    bool seek(uint32_t pos) { return _f && fseek(_f.get(), (long)pos, SEEK_SET) == 0; }
+    size_t position() const { return _f ? (size_t)ftell(_f.get()) : 0; }
+};
+
+class FS {
+protected:
+    String _root;  // host directory, empty until mounted
+    String hostPath(const char* path) const { return _root + path; }
+
+public:
+    File open(const char* path, const char* mode = "r");
+    File open(const String& path, const char* mode = "r") { return open(path.c_str(), mode); }
+    bool exists(const char* path);
+    bool exists(const String& path) { return exists(path.c_str()); }
+    bool remove(const char* path);
+    bool remove(const String& path) { return remove(path.c_str()); }
+    bool rename(const char* from, const char* to);
+};
+
+}  // namespace fs
+
+using fs::File;
+using fs::FS;
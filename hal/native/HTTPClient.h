@@ -0,0 +1,25 @@
+#pragma once
+// HTTP client answered by a host handler or fixture files (halSetHttpHandler/halSetHttpFixtures).
+#include "Arduino.h"
+#include "WiFiClientSecure.h"
+
+#define HTTP_CODE_OK 200
+#define HTTP_CODE_NOT_FOUND 404
+#define HTTPC_ERROR_CONNECTION_REFUSED (-1)
+#define HTTPC_ERROR_READ_TIMEOUT (-11)
+
+class HTTPClient {
+    String _url;
+    String _payload;
+
+public:
+    bool begin(WiFiClient& client, const String& url) { (void)client; _url = url; return true; }
+    bool begin(const String& url) { _url = url; return true; }
+    void setTimeout(uint16_t ms) { (void)ms; }
+    void setConnectTimeout(int32_t ms) { (void)ms; }
+    void setReuse(bool reuse) { (void)reuse; }
+    int GET();
+    String getString() { return _payload; }
+    int getSize() { return (int)_payload.length(); }
+    void end() {}
+};
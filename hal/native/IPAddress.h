@@ -0,0 +1,31 @@
+#pragma once
+#include <cstdint>
+#include "WString.h"
+
+class IPAddress {
+    uint8_t _b[4] = {0, 0, 0, 0};
+
+public:
+    IPAddress() {}
+    IPAddress(uint8_t a, uint8_t b, uint8_t c, uint8_t d) { _b[0] = a; _b[1] = b; _b[2] = c; _b[3] = d; }
+    IPAddress(uint32_t v) { memcpy(_b, &v, 4); }
+    operator uint32_t() const { uint32_t v; memcpy(&v, _b, 4); return v; }
+    uint8_t operator[](int i) const { return _b[i]; }
+    uint8_t& operator[](int i) { return _b[i]; }
+    bool operator==(const IPAddress& o) const { return memcmp(_b, o._b, 4) == 0; }
+    bool operator!=(const IPAddress& o) const { return !(*this == o); }
+    bool fromString(const char* s) {
+        unsigned a, b, c, d;
+        if (sscanf(s, "%u.%u.%u.%u", &a, &b, &c, &d) != 4 || a > 255 || b > 255 || c > 255 || d > 255) return false;
+        _b[0] = (uint8_t)a; _b[1] = (uint8_t)b; _b[2] = (uint8_t)c; _b[3] = (uint8_t)d;
+        return true;
+    }
+    bool fromString(const String& s) { return fromString(s.c_str()); }
+    String toString() const {
+        char buf[16];
+        snprintf(buf, sizeof(buf), "%u.%u.%u.%u", _b[0], _b[1], _b[2], _b[3]);
+        return String(buf);
+    }
+};
+
+#define INADDR_NONE IPAddress(0, 0, 0, 0)
@@ -0,0 +1,18 @@
+#pragma once
+#include "FS.h"
+
+namespace fs {
+
+class LittleFSFS : public FS {
+public:
+    bool begin(bool formatOnFail = false, const char* basePath = "/littlefs", uint8_t maxOpenFiles = 10,
+               const char* partitionLabel = "spiffs");
+    void end() { _root = String(); }
+    bool format();
+    size_t totalBytes() { return 0xE0000; }  // spiffs partition in huge_app.csv
+    size_t usedBytes();
+};
+
+}  // namespace fs
+
+extern fs::LittleFSFS LittleFS;
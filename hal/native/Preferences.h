@@ -0,0 +1,35 @@
+#pragma once
+// NVS emulation: namespaces live in a process-wide map, optionally mirrored to a file
+// (halSetNvsFile).
+#include "Arduino.h"
+
+class Preferences {
+    String _ns;
+    bool _open = false;
+    bool _readOnly = false;
+
+public:
+    bool begin(const char* name, bool readOnly = false, const char* partition = nullptr);
+    void end();
+    bool clear();
+    bool remove(const char* key);
+    bool isKey(const char* key);
+
+    size_t putString(const char* key, const String& value);
+    size_t putString(const char* key, const char* value) { return putString(key, String(value)); }
+    size_t putFloat(const char* key, float value);
+    size_t putInt(const char* key, int32_t value);
+    size_t putUInt(const char* key, uint32_t value);
+    size_t putUChar(const char* key, uint8_t value);
+    size_t putBool(const char* key, bool value);
+    size_t putBytes(const char* key, const void* value, size_t len);
+
+    String getString(const char* key, const String& defaultValue = String());
+    float getFloat(const char* key, float defaultValue = 0.0f);
+    int32_t getInt(const char* key, int32_t defaultValue = 0);
+    uint32_t getUInt(const char* key, uint32_t defaultValue = 0);
+    uint8_t getUChar(const char* key, uint8_t defaultValue = 0);
+    bool getBool(const char* key, bool defaultValue = false);
+    size_t getBytesLength(const char* key);
+    size_t getBytes(const char* key, void* buf, size_t maxLen);
+};
@@ -0,0 +1,18 @@
+#pragma once
+#include "Arduino.h"
+
+#define VSPI 3
+#define HSPI 2
+
+class SPIClass {
+public:
+    explicit SPIClass(uint8_t bus = HSPI) : _bus(bus) {}
+    void begin(int8_t sck = -1, int8_t miso = -1, int8_t mosi = -1, int8_t ss = -1) {
+        (void)sck; (void)miso; (void)mosi; (void)ss;
+    }
+    void end() {}
+
+private:
+    uint8_t _bus;
+};
+extern SPIClass SPI;
@@ -0,0 +1,65 @@
+#pragma once
+// Headless TFT_eSPI: drawing calls are counted (halDisplayStats) but nothing is rasterised.
+#include "Arduino.h"
+#include "SPI.h"
+
+#define TFT_BLACK 0x0000
+#define TFT_NAVY 0x000F
+#define TFT_DARKGREEN 0x03E0
+#define TFT_DARKCYAN 0x03EF
+#define TFT_MAROON 0x7800
+#define TFT_PURPLE 0x780F
+#define TFT_OLIVE 0x7BE0
+#define TFT_LIGHTGREY 0xD69A
+#define TFT_DARKGREY 0x7BEF
+#define TFT_BLUE 0x001F
+#define TFT_GREEN 0x07E0
+#define TFT_CYAN 0x07FF
+#define TFT_RED 0xF800
+#define TFT_MAGENTA 0xF81F
+#define TFT_YELLOW 0xFFE0
+#define TFT_WHITE 0xFFFF
+#define TFT_ORANGE 0xFDA0
+
+#ifndef TFT_BL
+#define TFT_BL 21
+#endif
+
+#define TFT_SLPIN 0x10
+#define TFT_SLPOUT 0x11
+#define TFT_DISPOFF 0x28
+#define TFT_DISPON 0x29
+
+class TFT_eSPI {
+public:
+    TFT_eSPI(int16_t w = 240, int16_t h = 320) : _w(w), _h(h) {}
+    void init();
+    void setRotation(uint8_t r);
+    int16_t width() const { return _w; }
+    int16_t height() const { return _h; }
+    void setSwapBytes(bool swap) { (void)swap; }
+    void fillScreen(uint32_t color);
+    void fillRect(int32_t x, int32_t y, int32_t w, int32_t h, uint32_t color);
+    void drawRect(int32_t x, int32_t y, int32_t w, int32_t h, uint32_t color);
+    void drawFastHLine(int32_t x, int32_t y, int32_t w, uint32_t color);
+    void drawFastVLine(int32_t x, int32_t y, int32_t h, uint32_t color);
+    void drawPixel(int32_t x, int32_t y, uint32_t color);
+    void drawLine(int32_t x0, int32_t y0, int32_t x1, int32_t y1, uint32_t color);
+    void drawCircle(int32_t x, int32_t y, int32_t r, uint32_t color);
+    void fillCircle(int32_t x, int32_t y, int32_t r, uint32_t color);
+    void setTextColor(uint16_t fg, uint16_t bg) { (void)fg; (void)bg; }
+    void setTextColor(uint16_t fg) { (void)fg; }
+    void setTextSize(uint8_t s) { (void)s; }
+    void setTextDatum(uint8_t d) { (void)d; }
+    int16_t drawString(const String& s, int32_t x, int32_t y, uint8_t font);
+    int16_t drawString(const char* s, int32_t x, int32_t y, uint8_t font);
+    int16_t drawCentreString(const String& s, int32_t x, int32_t y, uint8_t font);
+    int16_t drawCentreString(const char* s, int32_t x, int32_t y, uint8_t font);
+    void pushImage(int32_t x, int32_t y, int32_t w, int32_t h, const uint16_t* data);
+    void writecommand(uint8_t c);
+    void startWrite() {}
+    void endWrite() {}
+
+private:
+    int16_t _w, _h;
+};
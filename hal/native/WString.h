@@ -0,0 +1,146 @@
+#pragma once
+// Minimal Arduino String replacement backed by std::string (host builds only).
+#include <string>
+#include <cstring>
+#include <cstdlib>
+#include <cstdio>
+#include <cctype>
+#include <cstdint>
+
+#ifndef DEC
+#define DEC 10
+#define HEX 16
+#define OCT 8
+#define BIN 2
+#endif
+
+class String {
+    std::string _s;
+
+    static std::string fromUnsigned(unsigned long long v, unsigned char base) {
+        if (v == 0) return "0";
+        std::string out;
+        while (v) {
+            unsigned d = (unsigned)(v % base);
+            out.insert(out.begin(), (char)(d < 10 ? '0' + d : 'a' + d - 10));
+            v /= base;
+        }
+        return out;
+    }
+    static std::string fromSigned(long long v, unsigned char base) {
+        if (base == 10 && v < 0) return "-" + fromUnsigned((unsigned long long)(-v), base);
+        return fromUnsigned((unsigned long long)v, base);
+    }
+    static std::string fromDouble(double v, unsigned int decimals) {
+        char buf[64];
+        snprintf(buf, sizeof(buf), "%.*f", decimals, v);
+        return buf;
+    }
+
+public:
+    String() {}
+    String(const char* s) : _s(s ? s : "") {}
+    String(const std::string& s) : _s(s) {}
+    String(char c) : _s(1, c) {}
+    String(unsigned char v, unsigned char base = 10) : _s(fromUnsigned(v, base)) {}
+    String(int v, unsigned char base = 10) : _s(fromSigned(v, base)) {}
+    String(unsigned int v, unsigned char base = 10) : _s(fromUnsigned(v, base)) {}
+    String(long v, unsigned char base = 10) : _s(fromSigned(v, base)) {}
+    String(unsigned long v, unsigned char base = 10) : _s(fromUnsigned(v, base)) {}
+    String(long long v, unsigned char base = 10) : _s(fromSigned(v, base)) {}
+    String(unsigned long long v, unsigned char base = 10) : _s(fromUnsigned(v, base)) {}
+    String(float v, unsigned int decimals = 2) : _s(fromDouble(v, decimals)) {}
+    String(double v, unsigned int decimals = 2) : _s(fromDouble(v, decimals)) {}
+
+    unsigned int length() const { return (unsigned int)_s.size(); }
+    const char* c_str() const { return _s.c_str(); }
+    bool reserve(unsigned int n) { _s.reserve(n); return true; }
+
+    char operator[](unsigned int i) const { return i < _s.size() ? _s[i] : '\0'; }
+    char& operator[](unsigned int i) { return _s[i]; }
+    char charAt(unsigned int i) const { return (*this)[i]; }
+
+    String& operator+=(const String& o) { _s += o._s; return *this; }
+    String& operator+=(const char* o) { if (o) _s += o; return *this; }
+    String& operator+=(char c) { _s += c; return *this; }
+    String& operator+=(int v) { _s += fromSigned(v, 10); return *this; }
+    String& operator+=(unsigned int v) { _s += fromUnsigned(v, 10); return *this; }
+    String& operator+=(long v) { _s += fromSigned(v, 10); return *this; }
+    String& operator+=(unsigned long v) { _s += fromUnsigned(v, 10); return *this; }
+    bool concat(const String& o) { _s += o._s; return true; }
+    bool concat(const char* o) { if (o) _s += o; return true; }
+    bool concat(char c) { _s += c; return true; }
+
+    friend String operator+(const String& a, const String& b) { return String(a._s + b._s); }
+    friend String operator+(const String& a, const char* b) { return String(a._s + (b ? b : "")); }
+    friend String operator+(const char* a, const String& b) { return String(std::string(a ? a : "") + b._s); }
+    friend String operator+(const String& a, char c) { return String(a._s + c); }
+
+    bool operator==(const String& o) const { return _s == o._s; }
+    bool operator==(const char* o) const { return _s == (o ? o : ""); }
+    bool operator!=(const String& o) const { return _s != o._s; }
+    bool operator!=(const char* o) const { return !(*this == o); }
+    bool operator<(const String& o) const { return _s < o._s; }
+    bool equals(const String& o) const { return _s == o._s; }
+    bool equalsIgnoreCase(const String& o) const {
+        if (_s.size() != o._s.size()) return false;
+        for (size_t i = 0; i < _s.size(); i++) {
+            if (tolower((unsigned char)_s[i]) != tolower((unsigned char)o._s[i])) return false;
+        }
+        return true;
+    }
+    bool startsWith(const String& p) const { return _s.compare(0, p._s.size(), p._s) == 0; }
+    bool startsWith(const String& p, unsigned int offset) const {
+        return offset <= _s.size() && _s.compare(offset, p._s.size(), p._s) == 0;
+    }
+    bool endsWith(const String& p) const {
+        return p._s.size() <= _s.size() && _s.compare(_s.size() - p._s.size(), p._s.size(), p._s) == 0;
+    }
+
+    int indexOf(char c, unsigned int from = 0) const {
+        size_t p = _s.find(c, from);
+        return p == std::string::npos ? -1 : (int)p;
+    }
+    int indexOf(const String& s, unsigned int from = 0) const {
+        size_t p = _s.find(s._s, from);
+        return p == std::string::npos ? -1 : (int)p;
+    }
+    int lastIndexOf(char c) const {
+        size_t p = _s.rfind(c);
+        return p == std::string::npos ? -1 : (int)p;
+    }
+    String substring(unsigned int from) const {
+        return from >= _s.size() ? String() : String(_s.substr(from));
+    }
+    String substring(unsigned int from, unsigned int to) const {
+        if (from > to) { unsigned int t = from; from = to; to = t; }
+        if (from >= _s.size()) return String();
+        if (to > _s.size()) to = (unsigned int)_s.size();
+        return String(_s.substr(from, to - from));
+    }
+    void trim() {
+        size_t b = 0, e = _s.size();
+        while (b < e && isspace((unsigned char)_s[b])) b++;
+        while (e > b && isspace((unsigned char)_s[e - 1])) e--;
+        _s = _s.substr(b, e - b);
+    }
+    void toLowerCase() { for (auto& c : _s) c = (char)tolower((unsigned char)c); }
+    void toUpperCase() { for (auto& c : _s) c = (char)toupper((unsigned char)c); }
+    void replace(const String& from, const String& to) {
+        if (from._s.empty()) return;
+        size_t p = 0;
+        while ((p = _s.find(from._s, p)) != std::string::npos) {
+            _s.replace(p, from._s.size(), to._s);
+            p += to._s.size();
+        }
+    }
+    void remove(unsigned int index, unsigned int count = (unsigned int)-1) {
+        if (index < _s.size()) _s.erase(index, count);
+    }
+    long toInt() const { return strtol(_s.c_str(), nullptr, 10); }
+    float toFloat() const { return strtof(_s.c_str(), nullptr); }
+    double toDouble() const { return strtod(_s.c_str(), nullptr); }
+    bool isEmpty() const { return _s.empty(); }
+
+    const std::string& std() const { return _s; }
+};
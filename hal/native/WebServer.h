@@ -0,0 +1,51 @@
+#pragma once
+// In-process WebServer: no socket; requests are run against the routes with halWebRequest().
+#include <functional>
+#include <vector>
+#include <utility>
+#include "Arduino.h"
+#include "FS.h"
+
+typedef enum { HTTP_ANY, HTTP_GET, HTTP_HEAD, HTTP_POST, HTTP_PUT, HTTP_PATCH, HTTP_DELETE, HTTP_OPTIONS } HTTPMethod;
+
+class WebServer {
+public:
+    typedef std::function<void(void)> THandlerFunction;
+
+    explicit WebServer(int port = 80);
+    ~WebServer();
+    void begin();
+    void stop();
+    void handleClient() {}
+    void on(const String& uri, HTTPMethod method, THandlerFunction fn);
+    void on(const String& uri, THandlerFunction fn) { on(uri, HTTP_ANY, fn); }
+    void onNotFound(THandlerFunction fn) { _notFound = fn; }
+
+    bool hasArg(const String& name) const;
+    String arg(const String& name) const;
+    String uri() const { return _uri; }
+    HTTPMethod method() const { return _method; }
+
+    void sendHeader(const String& name, const String& value, bool first = false);
+    void send(int code, const char* contentType = nullptr, const String& content = String());
+    void send(int code, const String& contentType, const String& content) { send(code, contentType.c_str(), content); }
+    void setContentLength(size_t len) { (void)len; }
+    void sendContent(const String& content) { _body += content; }
+    size_t streamFile(fs::File& file, const String& contentType);
+
+    // Runs one request through the routes (halWebRequest)
+    int dispatch(HTTPMethod method, const String& uri, const std::vector<std::pair<String, String>>& args,
+                 String* outBody = nullptr);
+    static WebServer* active();
+
+private:
+    struct Route { String uri; HTTPMethod method; THandlerFunction fn; };
+    std::vector<Route> _routes;
+    THandlerFunction _notFound;
+    std::vector<std::pair<String, String>> _args;
+    std::vector<std::pair<String, String>> _headers;
+    String _uri;
+    HTTPMethod _method = HTTP_GET;
+    int _code = 0;
+    String _body;
+};
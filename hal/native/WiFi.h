@@ -0,0 +1,81 @@
+#pragma once
+// Simulated WiFi station/AP; the radio environment is set up with halAddAccessPoint() and
+// halSetWifiLink() (hal_native.h).
+#include "Arduino.h"
+#include "IPAddress.h"
+
+typedef enum {
+    WL_NO_SHIELD = 255,
+    WL_IDLE_STATUS = 0,
+    WL_NO_SSID_AVAIL = 1,
+    WL_SCAN_COMPLETED = 2,
+    WL_CONNECTED = 3,
+    WL_CONNECT_FAILED = 4,
+    WL_CONNECTION_LOST = 5,
+    WL_DISCONNECTED = 6
+} wl_status_t;
+
+typedef enum { WIFI_OFF = 0, WIFI_STA = 1, WIFI_AP = 2, WIFI_AP_STA = 3 } wifi_mode_t;
+typedef enum { WIFI_PS_NONE, WIFI_PS_MIN_MODEM, WIFI_PS_MAX_MODEM } wifi_ps_type_t;
+typedef enum { WIFI_AUTH_OPEN = 0, WIFI_AUTH_WEP, WIFI_AUTH_WPA_PSK, WIFI_AUTH_WPA2_PSK } wifi_auth_mode_t;
+
+#define WIFI_SCAN_RUNNING (-1)
+#define WIFI_SCAN_FAILED (-2)
+
+typedef enum {
+    ARDUINO_EVENT_WIFI_STA_START = 2,
+    ARDUINO_EVENT_WIFI_STA_CONNECTED = 4,
+    ARDUINO_EVENT_WIFI_STA_DISCONNECTED = 5,
+    ARDUINO_EVENT_WIFI_STA_GOT_IP = 7,
+    ARDUINO_EVENT_WIFI_STA_LOST_IP = 8,
+} arduino_event_id_t;
+typedef arduino_event_id_t WiFiEvent_t;
+
+class WiFiClass {
+public:
+    wl_status_t status();
+    bool mode(wifi_mode_t m);
+    wifi_mode_t getMode();
+    bool setHostname(const char* name);
+    wl_status_t begin(const char* ssid, const char* pass = nullptr, int32_t channel = 0,
+                      const uint8_t* bssid = nullptr, bool connect = true);
+    bool config(IPAddress local, IPAddress gateway, IPAddress subnet,
+                IPAddress dns1 = IPAddress(), IPAddress dns2 = IPAddress());
+    bool disconnect(bool wifioff = false, bool eraseap = false);
+    bool reconnect();
+    bool setAutoReconnect(bool autoReconnect);
+    bool setSleep(bool enabled);
+    bool setSleep(wifi_ps_type_t type);
+    bool persistent(bool persistent);
+
+    int16_t scanNetworks(bool async = false, bool showHidden = false, bool passive = false,
+                         uint32_t maxMsPerChan = 300, uint8_t channel = 0);
+    int16_t scanComplete();
+    void scanDelete();
+    String SSID(uint8_t i);
+    int32_t RSSI(uint8_t i);
+    int32_t channel(uint8_t i);
+    wifi_auth_mode_t encryptionType(uint8_t i);
+    uint8_t* BSSID(uint8_t i);
+
+    String SSID();
+    int8_t RSSI();
+    int32_t channel();
+    uint8_t* BSSID();
+    String BSSIDstr();
+    IPAddress localIP();
+    IPAddress gatewayIP();
+    IPAddress subnetMask();
+    IPAddress dnsIP(uint8_t i = 0);
+
+    bool softAP(const char* ssid, const char* pass = nullptr, int channel = 1, int hidden = 0,
+                int maxConnection = 4, bool ftmResponder = false);
+    bool softAPdisconnect(bool wifioff = false);
+    IPAddress softAPIP();
+    String softAPSSID();
+    void enableProv(bool enable);
+
+    typedef void (*WiFiEventCb)(WiFiEvent_t event);
+    int onEvent(WiFiEventCb cb);
+};
+extern WiFiClass WiFi;
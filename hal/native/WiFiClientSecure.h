@@ -0,0 +1,15 @@
+#pragma once
+#include "Arduino.h"
+
+class WiFiClient {
+public:
+    virtual ~WiFiClient() {}
+    void stop() {}
+};
+
+class WiFiClientSecure : public WiFiClient {
+public:
+    void setInsecure() {}
+    void setCACert(const char* cert) { (void)cert; }
+    void setTimeout(uint32_t seconds) { (void)seconds; }
+};
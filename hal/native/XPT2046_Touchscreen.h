@@ -0,0 +1,24 @@
+#pragma once
+// Touch controller fake: getPoint() returns whatever halSetTouchPoint() last set.
+#include "Arduino.h"
+#include "SPI.h"
+
+class TS_Point {
+public:
+    TS_Point() : x(0), y(0), z(0) {}
+    TS_Point(int16_t x, int16_t y, int16_t z) : x(x), y(y), z(z) {}
+    int16_t x, y, z;
+};
+
+class XPT2046_Touchscreen {
+public:
+    XPT2046_Touchscreen(uint8_t cs, uint8_t irq = 255) : _cs(cs), _irq(irq) {}
+    bool begin(SPIClass& spi) { (void)spi; return true; }
+    void setRotation(uint8_t r) { (void)r; }
+    bool tirqTouched();
+    bool touched();
+    TS_Point getPoint();
+
+private:
+    uint8_t _cs, _irq;
+};
@@ -0,0 +1,578 @@
+// Host implementations of the Arduino/ESP-IDF calls TouchClock uses: clock, Serial, CPU and
+// heap, FreeRTOS tasks/notifications/queues, GPIO and I2S. Peripherals, networking and
+// storage live in hal_periph.cpp, hal_net.cpp and hal_storage.cpp, so offline tools that
+// only need these can link this file alone.
+#include <Arduino.h>
+#include <driver/i2s.h>
+#include <malloc.h>
+#include <unistd.h>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include "hal_native.h"
+
+HardwareSerial Serial;
+EspClass ESP;
+
+// --- Clock ---
+static std::atomic<bool> s_virtualClock{false};
+static std::atomic<uint64_t> s_virtualUs{0};
+static const auto s_bootTime = std::chrono::steady_clock::now();
+
+// Lockstep scheduling (below): set once tasks run on the virtual clock
+static std::atomic<bool> s_lockstep{false};
+static std::atomic<bool> s_lockstepActive{false};  // a task has been created in lockstep mode
+static void lockstepWait(uint64_t wakeUs, std::function<bool()> ready);
+static void updateLockstep();
+
+void halUseVirtualClock(bool enabled) {
+    s_virtualClock = enabled;
+    updateLockstep();
+}
+void halSetMicros(uint64_t us) { s_virtualUs = us; }
+void halAdvanceMicros(uint64_t us) { s_virtualUs += us; }
+
+uint64_t halMicros() {
+    if (s_virtualClock) return s_virtualUs;
+    return (uint64_t)std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::steady_clock::now() - s_bootTime).count();
+}
+
+unsigned long millis() { return (unsigned long)(halMicros() / 1000); }
+unsigned long micros() { return (unsigned long)halMicros(); }
+
+static void sleepMicros(uint64_t us) {
+    if (s_lockstepActive) {
+        lockstepWait(s_virtualUs + us, nullptr);
+    } else if (s_virtualClock) {
+        s_virtualUs += us;
+    } else {
+        std::this_thread::sleep_for(std::chrono::microseconds(us));
+    }
+}
+
+void delay(uint32_t ms) { sleepMicros((uint64_t)ms * 1000); }
+void delayMicroseconds(uint32_t us) { sleepMicros(us); }
+
+void yield() {}
+
+// --- Wall clock ---
+// time() = wall offset + uptime. The offset is 0 until SNTP (configTime) sets it.
+static std::atomic<int64_t> s_wallOffsetUs{0};
+static std::atomic<bool> s_wallSet{false};
+static std::atomic<int64_t> s_realOffsetUs{(int64_t)std::chrono::duration_cast<std::chrono::microseconds>(
+    std::chrono::system_clock::now().time_since_epoch()).count()};
+
+static std::atomic<int32_t> s_driftPpm{0};
+
+// Uptime as the outside world measures it, for a board crystal that runs fast by s_driftPpm
+static int64_t trueUptimeUs() {
+    int64_t us = (int64_t)halMicros();
+    return us - us / 1000000 * s_driftPpm - us % 1000000 * s_driftPpm / 1000000;
+}
+
+void halSetRealTime(time_t epoch) { s_realOffsetUs = (int64_t)epoch * 1000000 - trueUptimeUs(); }
+time_t halRealTime() { return (time_t)((s_realOffsetUs + trueUptimeUs()) / 1000000); }
+
+void halSetClockDriftPpm(int32_t ppm) {
+    time_t now = halRealTime();
+    s_driftPpm = ppm;
+    halSetRealTime(now);
+}
+
+void halSetWallClock(time_t epoch) {
+    s_wallOffsetUs = (int64_t)epoch * 1000000 - (int64_t)halMicros();
+    s_wallSet = true;
+}
+
+bool halWallClockSet() { return s_wallSet; }
+
+// Set by configTime() in hal_net.cpp: lets SNTP's periodic re-sync catch up before each read
+void (*halSntpPoll)() = nullptr;
+
+// Replaces the C library's time() for the whole program, as newlib's reads the RTC on the device
+time_t time(time_t* out) noexcept {
+    if (halSntpPoll) halSntpPoll();
+    time_t now = (time_t)((s_wallOffsetUs + (int64_t)halMicros()) / 1000000);
+    if (out) *out = now;
+    return now;
+}
+
+bool getLocalTime(struct tm* info, uint32_t ms) {
+    // Same as the Arduino core: poll until the clock looks set, for up to ms
+    uint32_t start = millis();
+    do {
+        time_t now = time(nullptr);
+        localtime_r(&now, info);
+        if (info->tm_year > (2016 - 1900)) return true;
+        delay(10);
+    } while (millis() - start <= ms);
+    return false;
+}
+
+// --- Serial and trace ---
+static FILE* s_serialOut = stdout;
+static FILE* s_traceOut = nullptr;
+
+void halSetSerialOutput(FILE* out) { s_serialOut = out; }
+void halSetTrace(FILE* out) { s_traceOut = out; }
+
+void halTracef(const char* fmt, ...) {
+    if (!s_traceOut) return;
+    char buf[512];
+    va_list ap;
+    va_start(ap, fmt);
+    vsnprintf(buf, sizeof(buf), fmt, ap);
+    va_end(ap);
+    fprintf(s_traceOut, "[HAL %8.3f] %s\n", halMicros() / 1e6, buf);
+}
+
+size_t HardwareSerial::write(const uint8_t* buf, size_t n) {
+    if (!s_serialOut) return n;
+    return fwrite(buf, 1, n, s_serialOut);
+}
+
+// --- CPU ---
+// Host time scaled to a 240 MHz cycle count: comparable between host runs, not with the ESP32
+uint32_t EspClass::getCycleCount() {
+    uint64_t ns = (uint64_t)std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now() - s_bootTime).count();
+    return (uint32_t)(ns * 240 / 1000);
+}
+
+// The clock only changes what the firmware reads back; host code runs at host speed
+static std::atomic<uint32_t> s_cpuMhz{240};
+uint32_t EspClass::getCpuFreqMHz() { return s_cpuMhz; }
+uint32_t getCpuFrequencyMhz() { return s_cpuMhz; }
+bool setCpuFrequencyMhz(uint32_t mhz) {
+    if (mhz != 80 && mhz != 160 && mhz != 240) return false;  // the PLL settings WiFi allows
+    if (mhz != s_cpuMhz) halTracef("CPU %u -> %u MHz", (unsigned)s_cpuMhz.load(), (unsigned)mhz);
+    s_cpuMhz = mhz;
+    return true;
+}
+
+void EspClass::restart() {
+    Serial.println("[HAL] ESP.restart(): exiting");
+    fflush(nullptr);
+    _exit(0);
+}
+
+// --- Heap ---
+// Host allocations made since start-up, against the ~320 KB the ESP32 has free at boot
+static const uint32_t HEAP_SIZE = 327680;
+static const size_t s_heapBaseline = mallinfo2().uordblks;
+static std::atomic<uint32_t> s_minFreeHeap{HEAP_SIZE};
+
+uint32_t EspClass::getHeapSize() { return HEAP_SIZE; }
+
+uint32_t EspClass::getFreeHeap() {
+    size_t used = mallinfo2().uordblks;
+    used = used > s_heapBaseline ? used - s_heapBaseline : 0;
+    uint32_t free = used < HEAP_SIZE ? (uint32_t)(HEAP_SIZE - used) : 0;
+    uint32_t min = s_minFreeHeap;
+    while (free < min && !s_minFreeHeap.compare_exchange_weak(min, free)) {}
+    return free;
+}
+
+uint32_t EspClass::getMinFreeHeap() {
+    getFreeHeap();
+    return s_minFreeHeap;
+}
+
+uint32_t EspClass::getMaxAllocHeap() { return getFreeHeap(); }
+
+bool psramFound() { return false; }
+
+long random(long max) { return max > 0 ? ::random() % max : 0; }
+long random(long min, long max) { return min < max ? min + ::random() % (max - min) : min; }
+
+// --- FreeRTOS: critical sections ---
+static std::recursive_mutex s_criticalMutex;
+
+void vPortEnterCritical(portMUX_TYPE* mux) {
+    s_criticalMutex.lock();
+    mux->locked++;
+}
+
+void vPortExitCritical(portMUX_TYPE* mux) {
+    mux->locked--;
+    s_criticalMutex.unlock();
+}
+
+// --- FreeRTOS: tasks and notifications ---
+struct HalTask {
+    TaskFunction_t fn;
+    void* param;
+    std::string name;
+    bool threaded;
+    UBaseType_t priority;
+    std::mutex mutex;
+    std::condition_variable cv;
+    uint32_t notifications = 0;
+
+    // Lockstep state, guarded by s_stepMutex
+    bool lockstep = false;
+    bool blocked = false;
+    uint64_t wakeUs = UINT64_MAX;
+    std::function<bool()> ready;
+
+    HalTask(TaskFunction_t fn, void* param, const char* name, bool threaded, UBaseType_t priority)
+        : fn(fn), param(param), name(name ? name : ""), threaded(threaded), priority(priority) {}
+};
+
+static std::atomic<bool> s_runTasks{false};
+static std::atomic<uint32_t> s_taskCount{0};
+static HalTask s_loopTask(nullptr, nullptr, "loopTask", false, 1);
+static thread_local HalTask* t_currentTask = nullptr;
+
+void halRunTasks(bool enabled) {
+    s_runTasks = enabled;
+    updateLockstep();
+}
+
+uint32_t halCreatedTaskCount() { return s_taskCount; }
+
+static HalTask* currentTask() { return t_currentTask ? t_currentTask : &s_loopTask; }
+
+// --- Lockstep scheduling ---
+// With tasks running on the virtual clock, their threads take turns like tasks on one core:
+// exactly one runs at a time, until it blocks. A blocked thread names a deadline and/or a
+// condition; when nothing is runnable the clock jumps straight to the earliest deadline.
+// Runs are repeatable, and idle time costs nothing.
+static std::mutex s_stepMutex;
+static std::condition_variable s_stepCv;
+static std::vector<HalTask*> s_stepTasks;  // creation order, loopTask first
+static HalTask* s_stepTurn = nullptr;      // the thread allowed to run
+
+static void updateLockstep() { s_lockstep = s_runTasks && s_virtualClock; }
+
+// Highest-priority runnable task (earliest created on a tie), advancing the clock if needed
+static HalTask* lockstepPick() {
+    for (;;) {
+        HalTask* best = nullptr;
+        uint64_t now = s_virtualUs;
+        uint64_t nextWake = UINT64_MAX;
+        for (HalTask* t : s_stepTasks) {
+            if (!t->blocked) continue;
+            bool runnable = t->wakeUs <= now || (t->ready && t->ready());
+            if (runnable && (!best || t->priority > best->priority)) best = t;
+            nextWake = std::min(nextWake, t->wakeUs);
+        }
+        if (best) return best;
+        if (nextWake == UINT64_MAX) {
+            fprintf(stderr, "[HAL] lockstep: every task is blocked with no timeout\n");
+            fflush(nullptr);
+            _exit(3);
+        }
+        s_virtualUs = nextWake;
+    }
+}
+
+static void lockstepWait(uint64_t wakeUs, std::function<bool()> ready) {
+    HalTask* self = currentTask();
+    std::unique_lock<std::mutex> lock(s_stepMutex);
+    self->wakeUs = wakeUs;
+    self->ready = std::move(ready);
+    self->blocked = true;
+    s_stepTurn = lockstepPick();
+    s_stepCv.notify_all();
+    s_stepCv.wait(lock, [self] { return s_stepTurn == self; });
+    self->blocked = false;
+    self->ready = nullptr;
+}
+
+// Blocking waits only make sense once other threads exist to end them
+template <typename Pred>
+static bool waitFor(std::condition_variable& cv, std::unique_lock<std::mutex>& lock, TickType_t ticks, Pred pred) {
+    if (!s_runTasks || ticks == 0) return pred();
+    if (s_lockstepActive) {
+        if (pred()) return true;
+        uint64_t wakeUs = ticks == portMAX_DELAY ? UINT64_MAX : s_virtualUs + (uint64_t)ticks * portTICK_PERIOD_MS * 1000;
+        lock.unlock();
+        lockstepWait(wakeUs, pred);  // evaluated by whichever thread yields; nothing else runs meanwhile
+        lock.lock();
+        return pred();
+    }
+    if (ticks == portMAX_DELAY) {
+        cv.wait(lock, pred);
+        return true;
+    }
+    return cv.wait_for(lock, std::chrono::milliseconds(ticks * portTICK_PERIOD_MS), pred);
+}
+
+BaseType_t xTaskCreatePinnedToCore(TaskFunction_t fn, const char* name, uint32_t stackDepth,
+                                   void* param, UBaseType_t priority, TaskHandle_t* outHandle,
+                                   BaseType_t coreId) {
+    (void)stackDepth;
+    (void)coreId;
+    bool threaded = s_runTasks;
+    HalTask* task = new HalTask(fn, param, name, threaded, priority);
+    s_taskCount++;
+    if (outHandle) *outHandle = task;
+    if (!threaded) return pdPASS;
+
+    if (s_lockstep) {
+        // The new task is runnable at once, and starts when the creator next blocks
+        std::lock_guard<std::mutex> lock(s_stepMutex);
+        if (s_stepTasks.empty()) {
+            s_stepTasks.push_back(&s_loopTask);
+            s_loopTask.lockstep = true;
+            s_stepTurn = currentTask();
+        }
+        task->lockstep = true;
+        task->blocked = true;
+        task->wakeUs = s_virtualUs;
+        s_stepTasks.push_back(task);
+        s_lockstepActive = true;
+    }
+    std::thread([task]() {
+        t_currentTask = task;
+        if (task->lockstep) {
+            std::unique_lock<std::mutex> lock(s_stepMutex);
+            s_stepCv.wait(lock, [task] { return s_stepTurn == task; });
+            task->blocked = false;
+        }
+        task->fn(task->param);
+        if (task->lockstep) {
+            // Returned after vTaskDelete(nullptr): hand the turn on for good
+            std::lock_guard<std::mutex> lock(s_stepMutex);
+            s_stepTasks.erase(std::find(s_stepTasks.begin(), s_stepTasks.end(), task));
+            s_stepTurn = lockstepPick();
+            s_stepCv.notify_all();
+        }
+    }).detach();
+    return pdPASS;
+}
+
+BaseType_t xTaskCreate(TaskFunction_t fn, const char* name, uint32_t stackDepth, void* param,
+                       UBaseType_t priority, TaskHandle_t* outHandle) {
+    return xTaskCreatePinnedToCore(fn, name, stackDepth, param, priority, outHandle, tskNO_AFFINITY);
+}
+
+void vTaskDelete(TaskHandle_t task) {
+    if (!task) task = currentTask();
+    if (task == &s_loopTask) return;
+    s_taskCount--;
+    if (!task->threaded) {
+        delete task;
+    } else if (task != t_currentTask) {
+        // A host thread cannot be stopped from outside; it keeps its record and runs on
+        halTracef("task %s deleted but still running", task->name.c_str());
+    }
+    // A task deleting itself finishes when its function returns
+}
+
+void vTaskDelay(TickType_t ticks) { delay(ticks * portTICK_PERIOD_MS); }
+
+void vTaskDelayUntil(TickType_t* previousWake, TickType_t increment) {
+    TickType_t target = *previousWake + increment;
+    int32_t wait = (int32_t)(target - xTaskGetTickCount());
+    if (wait > 0) vTaskDelay((TickType_t)wait);
+    *previousWake = target;
+}
+
+TickType_t xTaskGetTickCount() { return (TickType_t)(millis() / portTICK_PERIOD_MS); }
+TaskHandle_t xTaskGetCurrentTaskHandle() { return currentTask(); }
+
+UBaseType_t uxTaskGetStackHighWaterMark(TaskHandle_t task) {
+    (void)task;
+    return 0;  // not measurable on the host
+}
+
+const char* pcTaskGetName(TaskHandle_t task) { return (task ? task : currentTask())->name.c_str(); }
+
+uint32_t ulTaskNotifyTake(BaseType_t clearOnExit, TickType_t ticksToWait) {
+    HalTask* task = currentTask();
+    std::unique_lock<std::mutex> lock(task->mutex);
+    if (!waitFor(task->cv, lock, ticksToWait, [task] { return task->notifications > 0; })) return 0;
+    uint32_t value = task->notifications;
+    task->notifications = clearOnExit ? 0 : value - 1;
+    return value;
+}
+
+BaseType_t xTaskNotifyGive(TaskHandle_t task) {
+    {
+        std::lock_guard<std::mutex> lock(task->mutex);
+        task->notifications++;
+    }
+    task->cv.notify_all();
+    return pdPASS;
+}
+
+void vTaskNotifyGiveFromISR(TaskHandle_t task, BaseType_t* higherPriorityTaskWoken) {
+    xTaskNotifyGive(task);
+    if (higherPriorityTaskWoken) *higherPriorityTaskWoken = pdFALSE;
+}
+
+// --- FreeRTOS: queues ---
+struct HalQueue {
+    std::mutex mutex;
+    std::condition_variable changed;
+    std::vector<uint8_t> storage;
+    UBaseType_t length, itemSize;
+    UBaseType_t head = 0, count = 0;
+
+    HalQueue(UBaseType_t length, UBaseType_t itemSize)
+        : storage((size_t)length * itemSize), length(length), itemSize(itemSize) {}
+};
+
+QueueHandle_t xQueueCreate(UBaseType_t length, UBaseType_t itemSize) {
+    if (length == 0 || itemSize == 0) return nullptr;
+    return new HalQueue(length, itemSize);
+}
+
+void vQueueDelete(QueueHandle_t q) { delete q; }
+
+BaseType_t xQueueSend(QueueHandle_t q, const void* item, TickType_t ticksToWait) {
+    std::unique_lock<std::mutex> lock(q->mutex);
+    if (!waitFor(q->changed, lock, ticksToWait, [q] { return q->count < q->length; })) return pdFALSE;
+    UBaseType_t tail = (q->head + q->count) % q->length;
+    memcpy(&q->storage[(size_t)tail * q->itemSize], item, q->itemSize);
+    q->count++;
+    lock.unlock();
+    q->changed.notify_all();
+    return pdTRUE;
+}
+
+BaseType_t xQueueSendFromISR(QueueHandle_t q, const void* item, BaseType_t* higherPriorityTaskWoken) {
+    if (higherPriorityTaskWoken) *higherPriorityTaskWoken = pdFALSE;
+    return xQueueSend(q, item, 0);
+}
+
+BaseType_t xQueueReceive(QueueHandle_t q, void* item, TickType_t ticksToWait) {
+    std::unique_lock<std::mutex> lock(q->mutex);
+    if (!waitFor(q->changed, lock, ticksToWait, [q] { return q->count > 0; })) return pdFALSE;
+    memcpy(item, &q->storage[(size_t)q->head * q->itemSize], q->itemSize);
+    q->head = (q->head + 1) % q->length;
+    q->count--;
+    lock.unlock();
+    q->changed.notify_all();
+    return pdTRUE;
+}
+
+UBaseType_t uxQueueMessagesWaiting(QueueHandle_t q) {
+    std::lock_guard<std::mutex> lock(q->mutex);
+    return q->count;
+}
+
+BaseType_t xQueueReset(QueueHandle_t q) {
+    {
+        std::lock_guard<std::mutex> lock(q->mutex);
+        q->head = 0;
+        q->count = 0;
+    }
+    q->changed.notify_all();
+    return pdPASS;
+}
+
+// --- GPIO ---
+static const uint8_t PIN_COUNT = 40;
+
+struct HalPin {
+    std::atomic<int> level{HIGH};
+    void (*isr)(void*) = nullptr;
+    void (*isrNoArg)() = nullptr;
+    void* arg = nullptr;
+    int mode = 0;
+};
+static HalPin s_pins[PIN_COUNT];
+
+void pinMode(uint8_t pin, uint8_t mode) { (void)pin; (void)mode; }
+
+void digitalWrite(uint8_t pin, uint8_t val) {
+    if (pin < PIN_COUNT) s_pins[pin].level = val ? HIGH : LOW;
+}
+
+int digitalRead(uint8_t pin) { return pin < PIN_COUNT ? s_pins[pin].level.load() : LOW; }
+int halPinLevel(uint8_t pin) { return digitalRead(pin); }
+
+void attachInterruptArg(uint8_t pin, void (*isr)(void*), void* arg, int mode) {
+    if (pin >= PIN_COUNT) return;
+    s_pins[pin].isr = isr;
+    s_pins[pin].isrNoArg = nullptr;
+    s_pins[pin].arg = arg;
+    s_pins[pin].mode = mode;
+}
+
+void attachInterrupt(uint8_t pin, void (*isr)(), int mode) {
+    if (pin >= PIN_COUNT) return;
+    s_pins[pin].isr = nullptr;
+    s_pins[pin].isrNoArg = isr;
+    s_pins[pin].mode = mode;
+}
+
+void detachInterrupt(uint8_t pin) {
+    if (pin >= PIN_COUNT) return;
+    s_pins[pin].isr = nullptr;
+    s_pins[pin].isrNoArg = nullptr;
+}
+
+void halSetPin(uint8_t pin, int level) {
+    if (pin >= PIN_COUNT) return;
+    HalPin& p = s_pins[pin];
+    level = level ? HIGH : LOW;
+    int old = p.level.exchange(level);
+    if (old == level) return;
+    bool fire = p.mode == CHANGE || (p.mode == FALLING && level == LOW) || (p.mode == RISING && level == HIGH);
+    if (!fire) return;
+    if (p.isr) p.isr(p.arg);
+    if (p.isrNoArg) p.isrNoArg();
+}
+
+// --- I2S DAC ---
+// Samples are counted, not played. With tasks running, writes block like a full DMA queue
+// would, so the audio task keeps to the sample rate (host or virtual time) instead of spinning.
+static uint32_t s_i2sSampleRate = 0;
+static size_t s_i2sBytesPerFrame = 4;
+static uint64_t s_i2sQueueFrames = 0;  // DMA depth
+static uint64_t s_i2sPlayheadUs = 0;   // when the DAC runs out of queued audio
+static HalDacStats s_dacStats = {};
+
+HalDacStats halDacStats() { return s_dacStats; }
+
+esp_err_t i2s_driver_install(i2s_port_t, const i2s_config_t* cfg, int, void*) {
+    s_i2sSampleRate = cfg->sample_rate;
+    s_i2sBytesPerFrame = (cfg->bits_per_sample / 8) * 2;
+    s_i2sQueueFrames = (uint64_t)cfg->dma_buf_count * cfg->dma_buf_len;
+    return ESP_OK;
+}
+
+esp_err_t i2s_driver_uninstall(i2s_port_t) { return ESP_OK; }
+esp_err_t i2s_set_pin(i2s_port_t, const void*) { return ESP_OK; }
+esp_err_t i2s_set_dac_mode(i2s_dac_mode_t) { return ESP_OK; }
+esp_err_t i2s_start(i2s_port_t) { return ESP_OK; }
+esp_err_t i2s_zero_dma_buffer(i2s_port_t) { return ESP_OK; }
+
+esp_err_t i2s_stop(i2s_port_t) {
+    s_i2sPlayheadUs = 0;
+    return ESP_OK;
+}
+
+esp_err_t i2s_write(i2s_port_t, const void* src, size_t size, size_t* bytesWritten, TickType_t) {
+    size_t frames = size / s_i2sBytesPerFrame;
+    if (s_i2sBytesPerFrame == 4) {
+        // Built-in DAC mode: the code is the high byte of each 16-bit slot
+        const uint16_t* slots = (const uint16_t*)src;
+        for (size_t i = 0; i < frames * 2; i++) {
+            int code = slots[i] >> 8;
+            uint8_t dev = (uint8_t)(code >= 128 ? code - 128 : 128 - code);
+            if (dev > s_dacStats.peak) s_dacStats.peak = dev;
+        }
+    }
+    s_dacStats.frames += frames;
+
+    if (s_runTasks && s_i2sSampleRate) {
+        uint64_t now = halMicros();
+        if (s_i2sPlayheadUs < now) s_i2sPlayheadUs = now;
+        s_i2sPlayheadUs += frames * 1000000ULL / s_i2sSampleRate;
+        uint64_t queuedUs = s_i2sQueueFrames * 1000000ULL / s_i2sSampleRate;
+        if (s_i2sPlayheadUs > now + queuedUs) delayMicroseconds((uint32_t)(s_i2sPlayheadUs - now - queuedUs));
+    }
+    if (bytesWritten) *bytesWritten = size;
+    return ESP_OK;
+}
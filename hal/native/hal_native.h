@@ -0,0 +1,105 @@
+#pragma once
+// Controls for host builds that have no counterpart on the device.
+#include <cstdint>
+#include <cstdio>
+#include <ctime>
+
+class String;
+
+// Clock behind millis()/micros(). Real time by default; in virtual mode time only
+// moves when the host program advances it (offline renders, simulations).
+void halUseVirtualClock(bool enabled);
+void halSetMicros(uint64_t us);
+void halAdvanceMicros(uint64_t us);
+uint64_t halMicros();
+
+// Wall clock behind time(). Like the ESP32's RTC it counts up from the epoch at boot
+// until SNTP sets it: configTime() copies the "real" time below into it when the
+// network is up and NTP is reachable. The real time defaults to the host's clock.
+void halSetRealTime(time_t epoch);
+time_t halRealTime();
+void halSetWallClock(time_t epoch);
+bool halWallClockSet();
+// The board's crystal runs fast by this much against real time, so the wall clock drifts
+// between SNTP syncs (10-20 ppm is typical for the CYD's 40 MHz crystal)
+void halSetClockDriftPpm(int32_t ppm);
+// SNTP requests made so far: configTime()'s first, retries every 15 s until one succeeds,
+// then the IDF's hourly re-sync
+uint32_t halSntpRequestCount();
+
+// Where Serial output goes (stdout by default, nullptr to discard)
+void halSetSerialOutput(FILE* out);
+
+// HAL diagnostics ("[HAL] ..." lines: HTTP fetches, NTP, panel power, web requests).
+// Off (nullptr) by default.
+void halSetTrace(FILE* out);
+void halTracef(const char* fmt, ...) __attribute__((format(printf, 1, 2)));
+
+// FreeRTOS tasks. By default xTaskCreatePinnedToCore() only records them and the host
+// program calls the owner's pump/render entry points itself. With halRunTasks(true)
+// every task created afterwards runs on its own thread, and notifications, queues and
+// delays block for real (host time). Combined with the virtual clock the threads run in
+// lockstep instead: one at a time, each until it blocks, with the clock jumping to the next
+// deadline whenever all of them wait. Pick both modes before any task is created.
+void halRunTasks(bool enabled);
+uint32_t halCreatedTaskCount();
+
+// GPIO inputs read HIGH until set. Changing a level runs any interrupt attached to the
+// pin on the calling thread, as if it were the ISR.
+void halSetPin(uint8_t pin, int level);
+int halPinLevel(uint8_t pin);  // last level written or set
+
+// ADC1: the voltage on a channel (mV); reads map it linearly to 12 bits over 0..3300 mV
+void halSetAdcMilliVolts(uint8_t channel, uint16_t mv);
+
+// XPT2046: raw reading returned by getPoint() (z = 0 means no touch)
+void halSetTouchPoint(int16_t x, int16_t y, int16_t z);
+
+// LEDC (IDF driver): duty a channel is at now, following any fade in progress
+uint32_t halLedcDuty(uint8_t channel);
+
+// Headless TFT_eSPI counters
+struct HalDisplayStats {
+    uint32_t fills;         // fillScreen/fillRect
+    uint32_t lines;         // lines, rects, circles, pixels
+    uint32_t texts;         // drawString/drawCentreString
+    uint32_t images;        // pushImage
+    uint64_t pixelsFilled;  // area covered by fills and images
+    uint32_t commands;      // writecommand()
+    bool sleeping;          // SLPIN sent without a later SLPOUT
+    bool displayOn;         // DISPON/DISPOFF
+};
+HalDisplayStats halDisplayStats();
+
+// I2S DAC: frames written, and the largest distance of any DAC code from mid-scale
+struct HalDacStats {
+    uint64_t frames;
+    uint8_t peak;
+};
+HalDacStats halDacStats();
+
+// WiFi: access points in range. status() reports WL_CONNECTED connectDelayMs after
+// WiFi.begin() with a matching SSID and password, as long as the radio link is up.
+void halAddAccessPoint(const char* ssid, const char* pass, uint8_t channel = 6, int8_t rssi = -55);
+void halSetWifiLink(bool up);      // false: every AP out of range (router off, outage)
+void halSetInternet(bool up);      // false: associated, but HTTP and NTP fail
+void halSetWifiConnectDelayMs(uint32_t ms);
+
+// HTTPClient: a handler gets first go at every GET (return 0 to decline); otherwise the
+// body comes from <fixtures>/<host>/<path> (query ignored), or 404 if there is no file.
+// halSetHttpFixtures() returns false (and keeps none) if dir is not a directory.
+typedef int (*HalHttpHandler)(const char* url, String& body, void* ctx);
+void halSetHttpHandler(HalHttpHandler handler, void* ctx);
+bool halSetHttpFixtures(const char* dir);
+void halSetHttpLatencyMs(uint32_t ms);  // time each GET takes, answered or not (default 0)
+uint32_t halHttpRequestCount();
+
+// WebServer: run one request against the started server's routes on the calling thread
+// (call it between loop() passes). Args are "a=1&b=2". Returns the status code, or -1
+// when no server is running.
+int halWebRequest(const char* method, const char* uri, const char* args = nullptr, String* body = nullptr);
+
+// Preferences: NVS contents are loaded from this file now and rewritten on every change
+bool halSetNvsFile(const char* path);
+// LittleFS is a host directory; begin() fails until one is set
+void halSetFsRoot(const char* dir);
@@ -0,0 +1,557 @@
+// Host networking: a simulated WiFi radio, HTTP fetches answered from fixtures, the
+// in-process WebServer, and SNTP.
+#include <Arduino.h>
+#include <HTTPClient.h>
+#include <WebServer.h>
+#include <WiFi.h>
+#include <sys/stat.h>
+#include <atomic>
+#include <mutex>
+#include <string>
+#include <vector>
+#include "hal_native.h"
+
+WiFiClass WiFi;
+
+// --- Radio environment ---
+struct HalAccessPoint {
+    String ssid, pass;
+    uint8_t channel;
+    int8_t rssi;
+    uint8_t bssid[6];
+};
+
+static std::recursive_mutex s_wifiMutex;
+static std::vector<HalAccessPoint> s_aps;
+static bool s_linkUp = true;
+static bool s_internetUp = true;
+static uint32_t s_connectDelayMs = 2000;  // scan, association and DHCP
+
+void halAddAccessPoint(const char* ssid, const char* pass, uint8_t channel, int8_t rssi) {
+    std::lock_guard<std::recursive_mutex> lock(s_wifiMutex);
+    HalAccessPoint ap{ssid, pass ? pass : "", channel, rssi, {0x24, 0x0A, 0xC4, 0x00, 0x00, 0x00}};
+    ap.bssid[5] = (uint8_t)(s_aps.size() + 1);
+    s_aps.push_back(ap);
+}
+
+void halSetWifiLink(bool up) {
+    std::lock_guard<std::recursive_mutex> lock(s_wifiMutex);
+    if (up != s_linkUp) halTracef("WiFi link %s", up ? "up" : "down");
+    s_linkUp = up;
+}
+
+void halSetInternet(bool up) {
+    std::lock_guard<std::recursive_mutex> lock(s_wifiMutex);
+    if (up != s_internetUp) halTracef("internet %s", up ? "up" : "down");
+    s_internetUp = up;
+}
+
+void halSetWifiConnectDelayMs(uint32_t ms) { s_connectDelayMs = ms; }
+
+// --- Station and soft AP ---
+static wifi_mode_t s_mode = WIFI_OFF;
+static wl_status_t s_status = WL_DISCONNECTED;
+static bool s_joining = false;
+static unsigned long s_joinDoneMs = 0;
+static String s_joinSsid, s_joinPass;
+static int32_t s_joinChannel = 0;
+static uint8_t s_joinBssid[6];
+static bool s_joinHasBssid = false;
+static int s_apIndex = -1;  // associated AP
+static bool s_autoReconnect = true;
+static IPAddress s_staticIp, s_staticGateway, s_staticSubnet, s_staticDns;
+static String s_softApSsid;
+
+static const HalAccessPoint* joinedAp() {
+    return s_status == WL_CONNECTED && s_apIndex >= 0 ? &s_aps[s_apIndex] : nullptr;
+}
+
+static void startJoin(uint32_t delayMs) {
+    s_joining = true;
+    s_joinDoneMs = millis() + delayMs;
+    s_status = WL_DISCONNECTED;
+    s_apIndex = -1;
+}
+
+wl_status_t WiFiClass::status() {
+    std::lock_guard<std::recursive_mutex> lock(s_wifiMutex);
+    if (s_joining && (long)(millis() - s_joinDoneMs) >= 0) {
+        s_joining = false;
+        s_status = WL_NO_SSID_AVAIL;
+        for (size_t i = 0; s_linkUp && i < s_aps.size(); i++) {
+            const HalAccessPoint& ap = s_aps[i];
+            if (ap.ssid != s_joinSsid) continue;
+            if (s_joinChannel && ap.channel != s_joinChannel) continue;
+            if (s_joinHasBssid && memcmp(ap.bssid, s_joinBssid, 6) != 0) continue;
+            s_status = ap.pass == s_joinPass ? WL_CONNECTED : WL_CONNECT_FAILED;
+            s_apIndex = (int)i;
+            break;
+        }
+        halTracef("WiFi join '%s': status %d", s_joinSsid.c_str(), (int)s_status);
+    }
+    if (s_status == WL_CONNECTED && !s_linkUp) {
+        s_status = WL_CONNECTION_LOST;
+        s_apIndex = -1;
+    } else if (s_status == WL_CONNECTION_LOST && s_linkUp && s_autoReconnect && !s_joining) {
+        startJoin(s_connectDelayMs);
+    }
+    return s_status;
+}
+
+bool WiFiClass::mode(wifi_mode_t m) {
+    std::lock_guard<std::recursive_mutex> lock(s_wifiMutex);
+    s_mode = m;
+    if (!(m & WIFI_STA)) {
+        s_joining = false;
+        s_status = WL_DISCONNECTED;
+        s_apIndex = -1;
+    }
+    return true;
+}
+
+wifi_mode_t WiFiClass::getMode() { return s_mode; }
+bool WiFiClass::setHostname(const char*) { return true; }
+
+wl_status_t WiFiClass::begin(const char* ssid, const char* pass, int32_t channel, const uint8_t* bssid, bool connect) {
+    std::lock_guard<std::recursive_mutex> lock(s_wifiMutex);
+    s_mode = (wifi_mode_t)(s_mode | WIFI_STA);
+    s_joinSsid = ssid;
+    s_joinPass = pass ? pass : "";
+    s_joinChannel = channel;
+    s_joinHasBssid = bssid != nullptr;
+    if (bssid) memcpy(s_joinBssid, bssid, 6);
+    if (!connect) return WL_DISCONNECTED;
+    // A known channel and BSSID skip the scan; a static lease skips DHCP
+    uint32_t delayMs = s_connectDelayMs;
+    if (channel && bssid) delayMs /= 3;
+    if ((uint32_t)s_staticIp != 0) delayMs /= 2;
+    startJoin(delayMs);
+    return WL_DISCONNECTED;
+}
+
+bool WiFiClass::config(IPAddress local, IPAddress gateway, IPAddress subnet, IPAddress dns1, IPAddress dns2) {
+    (void)dns2;
+    std::lock_guard<std::recursive_mutex> lock(s_wifiMutex);
+    s_staticIp = local;
+    s_staticGateway = gateway;
+    s_staticSubnet = subnet;
+    s_staticDns = dns1;
+    return true;
+}
+
+bool WiFiClass::disconnect(bool wifioff, bool eraseap) {
+    (void)eraseap;
+    std::lock_guard<std::recursive_mutex> lock(s_wifiMutex);
+    s_joining = false;
+    s_status = WL_DISCONNECTED;
+    s_apIndex = -1;
+    if (wifioff) s_mode = (wifi_mode_t)(s_mode & ~WIFI_STA);
+    return true;
+}
+
+bool WiFiClass::reconnect() {
+    std::lock_guard<std::recursive_mutex> lock(s_wifiMutex);
+    startJoin(s_connectDelayMs);
+    return true;
+}
+
+bool WiFiClass::setAutoReconnect(bool autoReconnect) {
+    s_autoReconnect = autoReconnect;
+    return true;
+}
+
+bool WiFiClass::setSleep(bool) { return true; }
+bool WiFiClass::setSleep(wifi_ps_type_t) { return true; }
+bool WiFiClass::persistent(bool) { return true; }
+void WiFiClass::enableProv(bool) {}
+int WiFiClass::onEvent(WiFiEventCb) { return 0; }
+
+String WiFiClass::SSID() {
+    std::lock_guard<std::recursive_mutex> lock(s_wifiMutex);
+    const HalAccessPoint* ap = joinedAp();
+    return ap ? ap->ssid : String();
+}
+
+int8_t WiFiClass::RSSI() {
+    std::lock_guard<std::recursive_mutex> lock(s_wifiMutex);
+    const HalAccessPoint* ap = joinedAp();
+    return ap ? ap->rssi : 0;
+}
+
+int32_t WiFiClass::channel() {
+    std::lock_guard<std::recursive_mutex> lock(s_wifiMutex);
+    const HalAccessPoint* ap = joinedAp();
+    return ap ? ap->channel : 0;
+}
+
+uint8_t* WiFiClass::BSSID() {
+    std::lock_guard<std::recursive_mutex> lock(s_wifiMutex);
+    const HalAccessPoint* ap = joinedAp();
+    return ap ? const_cast<uint8_t*>(ap->bssid) : nullptr;
+}
+
+String WiFiClass::BSSIDstr() {
+    const uint8_t* b = BSSID();
+    if (!b) return String();
+    char buf[18];
+    snprintf(buf, sizeof(buf), "%02X:%02X:%02X:%02X:%02X:%02X", b[0], b[1], b[2], b[3], b[4], b[5]);
+    return String(buf);
+}
+
+IPAddress WiFiClass::localIP() {
+    std::lock_guard<std::recursive_mutex> lock(s_wifiMutex);
+    if (!joinedAp()) return IPAddress();
+    return (uint32_t)s_staticIp ? s_staticIp : IPAddress(192, 168, 1, 50);
+}
+
+IPAddress WiFiClass::gatewayIP() {
+    std::lock_guard<std::recursive_mutex> lock(s_wifiMutex);
+    if (!joinedAp()) return IPAddress();
+    return (uint32_t)s_staticGateway ? s_staticGateway : IPAddress(192, 168, 1, 1);
+}
+
+IPAddress WiFiClass::subnetMask() {
+    std::lock_guard<std::recursive_mutex> lock(s_wifiMutex);
+    if (!joinedAp()) return IPAddress();
+    return (uint32_t)s_staticSubnet ? s_staticSubnet : IPAddress(255, 255, 255, 0);
+}
+
+IPAddress WiFiClass::dnsIP(uint8_t) {
+    std::lock_guard<std::recursive_mutex> lock(s_wifiMutex);
+    if (!joinedAp()) return IPAddress();
+    return (uint32_t)s_staticDns ? s_staticDns : IPAddress(192, 168, 1, 1);
+}
+
+bool WiFiClass::softAP(const char* ssid, const char*, int, int, int, bool) {
+    std::lock_guard<std::recursive_mutex> lock(s_wifiMutex);
+    s_mode = (wifi_mode_t)(s_mode | WIFI_AP);
+    s_softApSsid = ssid;
+    halTracef("soft AP '%s' up", ssid);
+    return true;
+}
+
+bool WiFiClass::softAPdisconnect(bool) {
+    std::lock_guard<std::recursive_mutex> lock(s_wifiMutex);
+    s_mode = (wifi_mode_t)(s_mode & ~WIFI_AP);
+    s_softApSsid = String();
+    return true;
+}
+
+IPAddress WiFiClass::softAPIP() { return (s_mode & WIFI_AP) ? IPAddress(192, 168, 4, 1) : IPAddress(); }
+String WiFiClass::softAPSSID() { return s_softApSsid; }
+
+// --- Scans ---
+static const uint32_t SCAN_MS = 2000;  // all 13 channels
+static std::vector<HalAccessPoint> s_scanResults;
+static bool s_scanRunning = false, s_scanDone = false;
+static unsigned long s_scanDoneMs = 0;
+
+int16_t WiFiClass::scanNetworks(bool async, bool, bool, uint32_t, uint8_t) {
+    std::lock_guard<std::recursive_mutex> lock(s_wifiMutex);
+    s_scanRunning = true;
+    s_scanDone = false;
+    s_scanDoneMs = millis() + SCAN_MS;
+    if (async) return WIFI_SCAN_RUNNING;
+    delay(SCAN_MS);
+    return scanComplete();
+}
+
+int16_t WiFiClass::scanComplete() {
+    std::lock_guard<std::recursive_mutex> lock(s_wifiMutex);
+    if (s_scanRunning && (long)(millis() - s_scanDoneMs) >= 0) {
+        s_scanRunning = false;
+        s_scanDone = true;
+        s_scanResults = s_linkUp ? s_aps : std::vector<HalAccessPoint>();
+    }
+    if (s_scanRunning) return WIFI_SCAN_RUNNING;
+    return s_scanDone ? (int16_t)s_scanResults.size() : WIFI_SCAN_FAILED;
+}
+
+void WiFiClass::scanDelete() {
+    std::lock_guard<std::recursive_mutex> lock(s_wifiMutex);
+    s_scanResults.clear();
+    s_scanDone = false;
+}
+
+static const HalAccessPoint* scanResult(uint8_t i) { return i < s_scanResults.size() ? &s_scanResults[i] : nullptr; }
+
+String WiFiClass::SSID(uint8_t i) { return scanResult(i) ? scanResult(i)->ssid : String(); }
+int32_t WiFiClass::RSSI(uint8_t i) { return scanResult(i) ? scanResult(i)->rssi : 0; }
+int32_t WiFiClass::channel(uint8_t i) { return scanResult(i) ? scanResult(i)->channel : 0; }
+uint8_t* WiFiClass::BSSID(uint8_t i) { return scanResult(i) ? s_scanResults[i].bssid : nullptr; }
+
+wifi_auth_mode_t WiFiClass::encryptionType(uint8_t i) {
+    return scanResult(i) && scanResult(i)->pass.length() ? WIFI_AUTH_WPA2_PSK : WIFI_AUTH_OPEN;
+}
+
+// --- SNTP ---
+extern void (*halSntpPoll)();  // hal_native.cpp: polled from time()
+
+static bool internetReachable() {
+    std::lock_guard<std::recursive_mutex> lock(s_wifiMutex);
+    return WiFi.status() == WL_CONNECTED && s_internetUp;
+}
+
+// lwIP's SNTP client: retries every 15 s until a reply, then re-syncs hourly (IDF default)
+static const uint64_t SNTP_RETRY_US = 15ULL * 1000000;
+static const uint64_t SNTP_INTERVAL_US = 3600ULL * 1000000;
+static std::mutex s_sntpMutex;
+static std::string s_sntpServer;
+static std::atomic<bool> s_sntpSynced{false};
+static std::atomic<uint64_t> s_sntpLastUs{0};
+static std::atomic<uint32_t> s_sntpRequests{0};
+
+uint32_t halSntpRequestCount() { return s_sntpRequests; }
+
+static void sntpRequest() {
+    s_sntpRequests++;
+    s_sntpLastUs = halMicros();
+    std::lock_guard<std::mutex> lock(s_sntpMutex);
+    if (internetReachable()) {
+        halSetWallClock(halRealTime());
+        s_sntpSynced = true;
+        halTracef("SNTP %s: clock set", s_sntpServer.c_str());
+    } else {
+        halTracef("SNTP %s: unreachable", s_sntpServer.c_str());
+    }
+}
+
+static void sntpPoll() {
+    uint64_t interval = s_sntpSynced ? SNTP_INTERVAL_US : SNTP_RETRY_US;
+    if (halMicros() - s_sntpLastUs >= interval) sntpRequest();
+}
+
+void configTime(long gmtOffset_sec, int daylightOffset_sec, const char* server1, const char*, const char*) {
+    // Same POSIX TZ string the Arduino core builds from the two offsets
+    long offset = -gmtOffset_sec;
+    char cst[32] = {0};
+    char cdt[32] = "DST";
+    char tz[64] = {0};
+    if (offset % 3600) {
+        snprintf(cst, sizeof(cst), "UTC%ld:%02ld:%02ld", offset / 3600, labs((offset % 3600) / 60), labs(offset % 60));
+    } else {
+        snprintf(cst, sizeof(cst), "UTC%ld", offset / 3600);
+    }
+    if (daylightOffset_sec != 3600) {
+        long dst = offset - daylightOffset_sec;
+        if (dst % 3600) {
+            snprintf(cdt, sizeof(cdt), "DST%ld:%02ld:%02ld", dst / 3600, labs((dst % 3600) / 60), labs(dst % 60));
+        } else {
+            snprintf(cdt, sizeof(cdt), "DST%ld", dst / 3600);
+        }
+    }
+    snprintf(tz, sizeof(tz), "%s%s", cst, cdt);
+    configTzTime(tz, server1, nullptr, nullptr);
+}
+
+void configTzTime(const char* tz, const char* server1, const char*, const char*) {
+    setenv("TZ", tz, 1);
+    tzset();
+    halTracef("SNTP configured, TZ=%s", tz);
+
+    // Answer the first request at once; TimeManager sees the clock set on its next pass
+    {
+        std::lock_guard<std::mutex> lock(s_sntpMutex);
+        s_sntpServer = server1 ? server1 : "-";
+        s_sntpSynced = false;
+    }
+    sntpRequest();
+    halSntpPoll = sntpPoll;
+}
+
+// --- HTTPClient ---
+static HalHttpHandler s_httpHandler = nullptr;
+static void* s_httpCtx = nullptr;
+static std::string s_fixtureDir;
+static std::atomic<uint32_t> s_httpRequests{0};
+static std::atomic<uint32_t> s_httpLatencyMs{0};
+
+void halSetHttpHandler(HalHttpHandler handler, void* ctx) {
+    s_httpHandler = handler;
+    s_httpCtx = ctx;
+}
+
+bool halSetHttpFixtures(const char* dir) {
+    struct stat st;
+    bool ok = dir && stat(dir, &st) == 0 && S_ISDIR(st.st_mode);
+    s_fixtureDir = ok ? dir : "";
+    return ok;
+}
+void halSetHttpLatencyMs(uint32_t ms) { s_httpLatencyMs = ms; }
+uint32_t halHttpRequestCount() { return s_httpRequests; }
+
+// https://host/path?query -> <fixtures>/host/path
+static int readFixture(const String& url, String& body) {
+    if (s_fixtureDir.empty()) return HTTP_CODE_NOT_FOUND;
+    std::string u = url.c_str();
+    size_t start = u.find("://");
+    start = start == std::string::npos ? 0 : start + 3;
+    size_t end = u.find('?', start);
+    std::string path = s_fixtureDir + "/" + u.substr(start, end == std::string::npos ? std::string::npos : end - start);
+
+    FILE* f = fopen(path.c_str(), "rb");
+    if (!f) return HTTP_CODE_NOT_FOUND;
+    std::string data;
+    char buf[4096];
+    size_t n;
+    while ((n = fread(buf, 1, sizeof(buf), f)) > 0) data.append(buf, n);
+    fclose(f);
+    body = String(data);
+    return HTTP_CODE_OK;
+}
+
+int HTTPClient::GET() {
+    s_httpRequests++;
+    _payload = String();
+    if (s_httpLatencyMs) delay(s_httpLatencyMs);
+    if (!internetReachable()) {
+        halTracef("GET %s -> connection refused", _url.c_str());
+        return HTTPC_ERROR_CONNECTION_REFUSED;
+    }
+    int code = s_httpHandler ? s_httpHandler(_url.c_str(), _payload, s_httpCtx) : 0;
+    if (code == 0) code = readFixture(_url, _payload);
+    halTracef("GET %s -> %d (%u bytes)", _url.c_str(), code, _payload.length());
+    return code;
+}
+
+// --- WebServer ---
+static WebServer* s_activeServer = nullptr;
+
+WebServer::WebServer(int port) { (void)port; }
+
+WebServer::~WebServer() {
+    if (s_activeServer == this) s_activeServer = nullptr;
+}
+
+void WebServer::begin() { s_activeServer = this; }
+
+void WebServer::stop() {
+    if (s_activeServer == this) s_activeServer = nullptr;
+}
+
+WebServer* WebServer::active() { return s_activeServer; }
+
+void WebServer::on(const String& uri, HTTPMethod method, THandlerFunction fn) {
+    _routes.push_back({uri, method, fn});
+}
+
+bool WebServer::hasArg(const String& name) const {
+    for (const auto& a : _args) {
+        if (a.first == name) return true;
+    }
+    return false;
+}
+
+String WebServer::arg(const String& name) const {
+    for (const auto& a : _args) {
+        if (a.first == name) return a.second;
+    }
+    return String();
+}
+
+void WebServer::sendHeader(const String& name, const String& value, bool first) {
+    if (first) {
+        _headers.insert(_headers.begin(), {name, value});
+    } else {
+        _headers.push_back({name, value});
+    }
+}
+
+void WebServer::send(int code, const char* contentType, const String& content) {
+    (void)contentType;
+    _code = code;
+    _body = content;
+}
+
+size_t WebServer::streamFile(fs::File& file, const String& contentType) {
+    (void)contentType;
+    _code = 200;
+    _body = file.readString();
+    return _body.length();
+}
+
+int WebServer::dispatch(HTTPMethod method, const String& uri, const std::vector<std::pair<String, String>>& args,
+                        String* outBody) {
+    _uri = uri;
+    _method = method;
+    _args = args;
+    _headers.clear();
+    _code = 0;
+    _body = String();
+
+    bool handled = false;
+    for (const Route& r : _routes) {
+        if (r.uri == uri && (r.method == HTTP_ANY || r.method == method)) {
+            r.fn();
+            handled = true;
+            break;
+        }
+    }
+    if (!handled) {
+        if (_notFound) {
+            _notFound();
+        } else {
+            send(404, "text/plain", "Not found");
+        }
+    }
+    if (outBody) *outBody = _body;
+    return _code;
+}
+
+static String urlDecode(const std::string& s) {
+    std::string out;
+    for (size_t i = 0; i < s.size(); i++) {
+        if (s[i] == '+') {
+            out += ' ';
+        } else if (s[i] == '%' && i + 2 < s.size() && isxdigit((unsigned char)s[i + 1]) &&
+                   isxdigit((unsigned char)s[i + 2])) {
+            out += (char)strtol(s.substr(i + 1, 2).c_str(), nullptr, 16);
+            i += 2;
+        } else {
+            out += s[i];
+        }
+    }
+    return String(out);
+}
+
+static void parseArgs(const std::string& query, std::vector<std::pair<String, String>>& out) {
+    size_t pos = 0;
+    while (pos < query.size()) {
+        size_t amp = query.find('&', pos);
+        std::string pair = query.substr(pos, amp == std::string::npos ? std::string::npos : amp - pos);
+        size_t eq = pair.find('=');
+        if (!pair.empty()) {
+            out.push_back({urlDecode(pair.substr(0, eq)), eq == std::string::npos ? String() : urlDecode(pair.substr(eq + 1))});
+        }
+        if (amp == std::string::npos) break;
+        pos = amp + 1;
+    }
+}
+
+int halWebRequest(const char* method, const char* uri, const char* args, String* body) {
+    WebServer* server = WebServer::active();
+    if (!server) return -1;
+
+    static const struct { const char* name; HTTPMethod method; } METHODS[] = {
+        {"GET", HTTP_GET}, {"POST", HTTP_POST}, {"PUT", HTTP_PUT}, {"DELETE", HTTP_DELETE},
+        {"HEAD", HTTP_HEAD}, {"PATCH", HTTP_PATCH}, {"OPTIONS", HTTP_OPTIONS}};
+    HTTPMethod m = HTTP_GET;
+    for (const auto& entry : METHODS) {
+        if (strcasecmp(method, entry.name) == 0) m = entry.method;
+    }
+
+    std::string path = uri;
+    std::vector<std::pair<String, String>> parsed;
+    size_t q = path.find('?');
+    if (q != std::string::npos) {
+        parseArgs(path.substr(q + 1), parsed);
+        path.resize(q);
+    }
+    if (args) parseArgs(args, parsed);
+
+    String out;
+    int code = server->dispatch(m, String(path), parsed, &out);
+    halTracef("%s %s -> %d (%u bytes)", method, uri, code, out.length());
+    if (body) *body = out;
+    return code;
+}
@@ -0,0 +1,254 @@
+// Host peripherals: the headless display, the touch controller, ADC1 and LEDC.
+#include <Arduino.h>
+#include <SPI.h>
+#include <TFT_eSPI.h>
+#include <XPT2046_Touchscreen.h>
+#include <driver/adc.h>
+#include <driver/ledc.h>
+#include <esp_adc_cal.h>
+#include <atomic>
+#include <mutex>
+#include "hal_native.h"
+
+SPIClass SPI(VSPI);
+
+// --- TFT_eSPI ---
+static HalDisplayStats s_display = {0, 0, 0, 0, 0, 0, true, false};
+static std::mutex s_displayMutex;
+
+HalDisplayStats halDisplayStats() {
+    std::lock_guard<std::mutex> lock(s_displayMutex);
+    return s_display;
+}
+
+static uint64_t clippedArea(int32_t w, int32_t h) { return w > 0 && h > 0 ? (uint64_t)w * h : 0; }
+
+void TFT_eSPI::init() {
+    std::lock_guard<std::mutex> lock(s_displayMutex);
+    s_display.sleeping = false;
+    s_display.displayOn = true;
+}
+
+void TFT_eSPI::setRotation(uint8_t r) {
+    if ((r & 1) != (_w > _h)) std::swap(_w, _h);
+}
+
+void TFT_eSPI::fillScreen(uint32_t color) { fillRect(0, 0, _w, _h, color); }
+
+void TFT_eSPI::fillRect(int32_t x, int32_t y, int32_t w, int32_t h, uint32_t color) {
+    (void)x; (void)y; (void)color;
+    std::lock_guard<std::mutex> lock(s_displayMutex);
+    s_display.fills++;
+    s_display.pixelsFilled += clippedArea(w, h);
+}
+
+void TFT_eSPI::pushImage(int32_t x, int32_t y, int32_t w, int32_t h, const uint16_t* data) {
+    (void)x; (void)y; (void)data;
+    std::lock_guard<std::mutex> lock(s_displayMutex);
+    s_display.images++;
+    s_display.pixelsFilled += clippedArea(w, h);
+}
+
+static void countLine() {
+    std::lock_guard<std::mutex> lock(s_displayMutex);
+    s_display.lines++;
+}
+
+void TFT_eSPI::drawRect(int32_t, int32_t, int32_t, int32_t, uint32_t) { countLine(); }
+void TFT_eSPI::drawFastHLine(int32_t, int32_t, int32_t, uint32_t) { countLine(); }
+void TFT_eSPI::drawFastVLine(int32_t, int32_t, int32_t, uint32_t) { countLine(); }
+void TFT_eSPI::drawPixel(int32_t, int32_t, uint32_t) { countLine(); }
+void TFT_eSPI::drawLine(int32_t, int32_t, int32_t, int32_t, uint32_t) { countLine(); }
+void TFT_eSPI::drawCircle(int32_t, int32_t, int32_t, uint32_t) { countLine(); }
+void TFT_eSPI::fillCircle(int32_t, int32_t, int32_t, uint32_t) { countLine(); }
+
+// Glyphs are not rendered; width is estimated from a fixed advance per font
+static int16_t textWidth(const char* s, uint8_t font) {
+    static const uint8_t ADVANCE[9] = {6, 6, 8, 8, 14, 14, 32, 32, 32};
+    return (int16_t)(strlen(s) * ADVANCE[font < 9 ? font : 1]);
+}
+
+int16_t TFT_eSPI::drawString(const char* s, int32_t x, int32_t y, uint8_t font) {
+    {
+        std::lock_guard<std::mutex> lock(s_displayMutex);
+        s_display.texts++;
+    }
+    halTracef("text (%d,%d) f%u \"%s\"", (int)x, (int)y, font, s);
+    return textWidth(s, font);
+}
+
+int16_t TFT_eSPI::drawString(const String& s, int32_t x, int32_t y, uint8_t font) {
+    return drawString(s.c_str(), x, y, font);
+}
+
+int16_t TFT_eSPI::drawCentreString(const char* s, int32_t x, int32_t y, uint8_t font) {
+    return drawString(s, x - textWidth(s, font) / 2, y, font);
+}
+
+int16_t TFT_eSPI::drawCentreString(const String& s, int32_t x, int32_t y, uint8_t font) {
+    return drawCentreString(s.c_str(), x, y, font);
+}
+
+void TFT_eSPI::writecommand(uint8_t c) {
+    std::lock_guard<std::mutex> lock(s_displayMutex);
+    s_display.commands++;
+    switch (c) {
+        case TFT_SLPIN: s_display.sleeping = true; break;
+        case TFT_SLPOUT: s_display.sleeping = false; break;
+        case TFT_DISPOFF: s_display.displayOn = false; break;
+        case TFT_DISPON: s_display.displayOn = true; break;
+        default: return;
+    }
+    halTracef("panel command 0x%02X", c);
+}
+
+// --- XPT2046 ---
+static std::mutex s_touchMutex;
+static TS_Point s_touchPoint;
+
+void halSetTouchPoint(int16_t x, int16_t y, int16_t z) {
+    std::lock_guard<std::mutex> lock(s_touchMutex);
+    s_touchPoint = TS_Point(x, y, z);
+}
+
+TS_Point XPT2046_Touchscreen::getPoint() {
+    std::lock_guard<std::mutex> lock(s_touchMutex);
+    return s_touchPoint;
+}
+
+bool XPT2046_Touchscreen::touched() { return getPoint().z > 0; }
+bool XPT2046_Touchscreen::tirqTouched() { return _irq == 255 || digitalRead(_irq) == LOW; }
+
+// --- ADC1 ---
+static std::atomic<uint16_t> s_adcMv[ADC1_CHANNEL_MAX];
+static const uint32_t ADC_FULL_SCALE_MV = 3300;
+
+void halSetAdcMilliVolts(uint8_t channel, uint16_t mv) {
+    if (channel < ADC1_CHANNEL_MAX) s_adcMv[channel] = mv;
+}
+
+esp_err_t adc1_config_width(adc_bits_width_t) { return ESP_OK; }
+esp_err_t adc1_config_channel_atten(adc1_channel_t, adc_atten_t) { return ESP_OK; }
+
+int adc1_get_raw(adc1_channel_t channel) {
+    if (channel >= ADC1_CHANNEL_MAX) return -1;
+    uint32_t mv = s_adcMv[channel];
+    return (int)(mv >= ADC_FULL_SCALE_MV ? 4095 : (mv * 4095 + ADC_FULL_SCALE_MV / 2) / ADC_FULL_SCALE_MV);
+}
+
+esp_adc_cal_value_t esp_adc_cal_characterize(adc_unit_t unit, adc_atten_t atten, adc_bits_width_t width,
+                                             uint32_t defaultVref, esp_adc_cal_characteristics_t* chars) {
+    *chars = {};
+    chars->adc_num = unit;
+    chars->atten = atten;
+    chars->bit_width = width;
+    chars->vref = defaultVref;
+    return ESP_ADC_CAL_VAL_DEFAULT_VREF;
+}
+
+uint32_t esp_adc_cal_raw_to_voltage(uint32_t raw, const esp_adc_cal_characteristics_t*) {
+    return (raw * ADC_FULL_SCALE_MV + 2047) / 4095;
+}
+
+// GPIO to ADC1 channel
+uint16_t analogRead(uint8_t pin) {
+    static const int8_t CHANNEL[40] = {-1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+                                       -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, 4,  5,  6,  7,  0,  1,  2,  3};
+    if (pin >= 40 || CHANNEL[pin] < 0) return 0;
+    return (uint16_t)adc1_get_raw((adc1_channel_t)CHANNEL[pin]);
+}
+
+uint32_t analogReadMilliVolts(uint8_t pin) {
+    return esp_adc_cal_raw_to_voltage(analogRead(pin), nullptr);
+}
+
+void analogSetAttenuation(adc_attenuation_t) {}
+void analogSetPinAttenuation(uint8_t, adc_attenuation_t) {}
+void analogSetWidth(uint8_t) {}
+void analogReadResolution(uint8_t) {}
+void dacWrite(uint8_t, uint8_t) {}
+void analogWrite(uint8_t, int) {}
+
+// --- LEDC ---
+// Each channel holds a linear fade from one duty to another over a span of host time
+struct HalLedcChannel {
+    uint32_t from = 0, to = 0;
+    uint32_t fadeMs = 0;
+    uint64_t startUs = 0;
+    uint32_t pending = 0, pendingFadeMs = 0;  // set by set_duty/set_fade, applied by update_duty/fade_start
+};
+static HalLedcChannel s_ledc[LEDC_CHANNEL_MAX];
+static std::mutex s_ledcMutex;
+
+static uint32_t ledcDutyAt(const HalLedcChannel& c, uint64_t nowUs) {
+    uint64_t spanUs = (uint64_t)c.fadeMs * 1000;
+    if (spanUs == 0 || nowUs >= c.startUs + spanUs) return c.to;
+    int64_t delta = (int64_t)c.to - (int64_t)c.from;
+    return (uint32_t)((int64_t)c.from + delta * (int64_t)(nowUs - c.startUs) / (int64_t)spanUs);
+}
+
+uint32_t halLedcDuty(uint8_t channel) {
+    if (channel >= LEDC_CHANNEL_MAX) return 0;
+    std::lock_guard<std::mutex> lock(s_ledcMutex);
+    return ledcDutyAt(s_ledc[channel], halMicros());
+}
+
+esp_err_t ledc_timer_config(const ledc_timer_config_t*) { return ESP_OK; }
+esp_err_t ledc_fade_func_install(int) { return ESP_OK; }
+
+esp_err_t ledc_channel_config(const ledc_channel_config_t* cfg) {
+    if (cfg->channel >= LEDC_CHANNEL_MAX) return ESP_ERR_INVALID_ARG;
+    std::lock_guard<std::mutex> lock(s_ledcMutex);
+    s_ledc[cfg->channel] = HalLedcChannel();
+    s_ledc[cfg->channel].from = s_ledc[cfg->channel].to = s_ledc[cfg->channel].pending = cfg->duty;
+    return ESP_OK;
+}
+
+esp_err_t ledc_set_duty(ledc_mode_t, ledc_channel_t channel, uint32_t duty) {
+    if (channel >= LEDC_CHANNEL_MAX) return ESP_ERR_INVALID_ARG;
+    std::lock_guard<std::mutex> lock(s_ledcMutex);
+    s_ledc[channel].pending = duty;
+    s_ledc[channel].pendingFadeMs = 0;
+    return ESP_OK;
+}
+
+esp_err_t ledc_update_duty(ledc_mode_t, ledc_channel_t channel) {
+    if (channel >= LEDC_CHANNEL_MAX) return ESP_ERR_INVALID_ARG;
+    std::lock_guard<std::mutex> lock(s_ledcMutex);
+    HalLedcChannel& c = s_ledc[channel];
+    c.from = c.to = c.pending;
+    c.fadeMs = 0;
+    return ESP_OK;
+}
+
+uint32_t ledc_get_duty(ledc_mode_t, ledc_channel_t channel) { return halLedcDuty(channel); }
+
+esp_err_t ledc_set_fade_with_time(ledc_mode_t, ledc_channel_t channel, uint32_t targetDuty, int maxFadeTimeMs) {
+    if (channel >= LEDC_CHANNEL_MAX) return ESP_ERR_INVALID_ARG;
+    std::lock_guard<std::mutex> lock(s_ledcMutex);
+    s_ledc[channel].pending = targetDuty;
+    s_ledc[channel].pendingFadeMs = maxFadeTimeMs > 0 ? (uint32_t)maxFadeTimeMs : 0;
+    return ESP_OK;
+}
+
+esp_err_t ledc_fade_start(ledc_mode_t, ledc_channel_t channel, ledc_fade_mode_t) {
+    if (channel >= LEDC_CHANNEL_MAX) return ESP_ERR_INVALID_ARG;
+    std::lock_guard<std::mutex> lock(s_ledcMutex);
+    HalLedcChannel& c = s_ledc[channel];
+    uint64_t now = halMicros();
+    c.from = ledcDutyAt(c, now);
+    c.to = c.pending;
+    c.fadeMs = c.pendingFadeMs;
+    c.startUs = now;
+    return ESP_OK;
+}
+
+// Arduino LEDC API on the same channels
+uint32_t ledcSetup(uint8_t channel, uint32_t freq, uint8_t) { return channel < LEDC_CHANNEL_MAX ? freq : 0; }
+void ledcAttachPin(uint8_t, uint8_t) {}
+
+void ledcWrite(uint8_t channel, uint32_t duty) {
+    if (channel >= LEDC_CHANNEL_MAX) return;
+    ledc_set_duty(LEDC_HIGH_SPEED_MODE, (ledc_channel_t)channel, duty);
+    ledc_update_duty(LEDC_HIGH_SPEED_MODE, (ledc_channel_t)channel);
+}
@@ -0,0 +1,293 @@
+// Host storage: NVS (Preferences) in memory with an optional backing file, and LittleFS
+// on a host directory.
+#include <Arduino.h>
+#include <FS.h>
+#include <LittleFS.h>
+#include <Preferences.h>
+#include <dirent.h>
+#include <sys/stat.h>
+#include <map>
+#include <mutex>
+#include <string>
+#include "hal_native.h"
+
+// --- NVS ---
+// Values keep their type like real NVS: reading a key as another type returns the default
+struct NvsValue {
+    char type;  // s string, f float, i int32, u uint32, c uint8/bool, x blob
+    std::string data;
+};
+typedef std::map<std::string, std::map<std::string, NvsValue>> NvsStore;
+
+static NvsStore s_nvs;
+static std::recursive_mutex s_nvsMutex;
+static std::string s_nvsFile;
+
+// One line per key: <namespace> <key> <type> <value>; strings escape \ and newlines, blobs are hex
+static void saveNvs() {
+    if (s_nvsFile.empty()) return;
+    FILE* f = fopen(s_nvsFile.c_str(), "w");
+    if (!f) return;
+    for (const auto& ns : s_nvs) {
+        for (const auto& kv : ns.second) {
+            const NvsValue& v = kv.second;
+            fprintf(f, "%s %s %c ", ns.first.c_str(), kv.first.c_str(), v.type);
+            switch (v.type) {
+                case 's':
+                    for (char c : v.data) {
+                        if (c == '\\') fputs("\\\\", f);
+                        else if (c == '\n') fputs("\\n", f);
+                        else fputc(c, f);
+                    }
+                    break;
+                case 'f': { float x; memcpy(&x, v.data.data(), 4); fprintf(f, "%.9g", x); break; }
+                case 'i': { int32_t x; memcpy(&x, v.data.data(), 4); fprintf(f, "%ld", (long)x); break; }
+                case 'u': { uint32_t x; memcpy(&x, v.data.data(), 4); fprintf(f, "%lu", (unsigned long)x); break; }
+                case 'c': fprintf(f, "%u", (uint8_t)v.data[0]); break;
+                default:
+                    for (char c : v.data) fprintf(f, "%02x", (uint8_t)c);
+                    break;
+            }
+            fputc('\n', f);
+        }
+    }
+    fclose(f);
+}
+
+static bool parseNvsLine(const std::string& line) {
+    char ns[32], key[32], type;
+    int consumed = 0;
+    if (sscanf(line.c_str(), "%31s %31s %c %n", ns, key, &type, &consumed) < 3) return false;
+    std::string value = line.substr(consumed < (int)line.size() ? consumed : line.size());
+    NvsValue v{type, std::string()};
+    switch (type) {
+        case 's':
+            for (size_t i = 0; i < value.size(); i++) {
+                if (value[i] == '\\' && i + 1 < value.size()) {
+                    v.data += value[++i] == 'n' ? '\n' : value[i];
+                } else {
+                    v.data += value[i];
+                }
+            }
+            break;
+        case 'f': { float x = strtof(value.c_str(), nullptr); v.data.assign((const char*)&x, 4); break; }
+        case 'i': { int32_t x = (int32_t)strtol(value.c_str(), nullptr, 10); v.data.assign((const char*)&x, 4); break; }
+        case 'u': { uint32_t x = (uint32_t)strtoul(value.c_str(), nullptr, 10); v.data.assign((const char*)&x, 4); break; }
+        case 'c': v.data.assign(1, (char)strtoul(value.c_str(), nullptr, 10)); break;
+        case 'x':
+            for (size_t i = 0; i + 1 < value.size(); i += 2) v.data += (char)strtoul(value.substr(i, 2).c_str(), nullptr, 16);
+            break;
+        default:
+            return false;
+    }
+    s_nvs[ns][key] = v;
+    return true;
+}
+
+bool halSetNvsFile(const char* path) {
+    std::lock_guard<std::recursive_mutex> lock(s_nvsMutex);
+    s_nvsFile = path ? path : "";
+    if (s_nvsFile.empty()) return true;
+    FILE* f = fopen(path, "r");
+    if (!f) return false;  // created on the first write
+    char buf[1024];
+    while (fgets(buf, sizeof(buf), f)) {
+        std::string line = buf;
+        while (!line.empty() && (line.back() == '\n' || line.back() == '\r')) line.pop_back();
+        if (!line.empty() && line[0] != '#') parseNvsLine(line);
+    }
+    fclose(f);
+    return true;
+}
+
+bool Preferences::begin(const char* name, bool readOnly, const char* partition) {
+    (void)partition;
+    std::lock_guard<std::recursive_mutex> lock(s_nvsMutex);
+    // Like nvs_open(): a namespace that was never written cannot be opened read-only
+    if (readOnly && s_nvs.find(name) == s_nvs.end()) return false;
+    _ns = name;
+    _readOnly = readOnly;
+    _open = true;
+    return true;
+}
+
+void Preferences::end() { _open = false; }
+
+static const NvsValue* findValue(const String& ns, const char* key, char type) {
+    auto n = s_nvs.find(ns.c_str());
+    if (n == s_nvs.end()) return nullptr;
+    auto k = n->second.find(key);
+    if (k == n->second.end() || k->second.type != type) return nullptr;
+    return &k->second;
+}
+
+static size_t putValue(bool writable, const String& ns, const char* key, char type, const void* data, size_t len) {
+    if (!writable) return 0;
+    std::lock_guard<std::recursive_mutex> lock(s_nvsMutex);
+    s_nvs[ns.c_str()][key] = NvsValue{type, std::string((const char*)data, len)};
+    saveNvs();
+    return len;
+}
+
+bool Preferences::clear() {
+    if (!_open || _readOnly) return false;
+    std::lock_guard<std::recursive_mutex> lock(s_nvsMutex);
+    s_nvs[_ns.c_str()].clear();
+    saveNvs();
+    return true;
+}
+
+bool Preferences::remove(const char* key) {
+    if (!_open || _readOnly) return false;
+    std::lock_guard<std::recursive_mutex> lock(s_nvsMutex);
+    bool removed = s_nvs[_ns.c_str()].erase(key) > 0;
+    if (removed) saveNvs();
+    return removed;
+}
+
+bool Preferences::isKey(const char* key) {
+    if (!_open) return false;
+    std::lock_guard<std::recursive_mutex> lock(s_nvsMutex);
+    auto n = s_nvs.find(_ns.c_str());
+    return n != s_nvs.end() && n->second.count(key) > 0;
+}
+
+size_t Preferences::putString(const char* key, const String& value) {
+    return putValue(_open && !_readOnly, _ns, key, 's', value.c_str(), value.length());
+}
+size_t Preferences::putFloat(const char* key, float value) { return putValue(_open && !_readOnly, _ns, key, 'f', &value, 4); }
+size_t Preferences::putInt(const char* key, int32_t value) { return putValue(_open && !_readOnly, _ns, key, 'i', &value, 4); }
+size_t Preferences::putUInt(const char* key, uint32_t value) { return putValue(_open && !_readOnly, _ns, key, 'u', &value, 4); }
+size_t Preferences::putUChar(const char* key, uint8_t value) { return putValue(_open && !_readOnly, _ns, key, 'c', &value, 1); }
+size_t Preferences::putBool(const char* key, bool value) { return putUChar(key, value ? 1 : 0); }
+size_t Preferences::putBytes(const char* key, const void* value, size_t len) {
+    return putValue(_open && !_readOnly, _ns, key, 'x', value, len);
+}
+
+template <typename T>
+static T getScalar(bool open, const String& ns, const char* key, char type, T defaultValue) {
+    if (!open) return defaultValue;
+    std::lock_guard<std::recursive_mutex> lock(s_nvsMutex);
+    const NvsValue* v = findValue(ns, key, type);
+    if (!v || v->data.size() != sizeof(T)) return defaultValue;
+    T out;
+    memcpy(&out, v->data.data(), sizeof(T));
+    return out;
+}
+
+String Preferences::getString(const char* key, const String& defaultValue) {
+    if (!_open) return defaultValue;
+    std::lock_guard<std::recursive_mutex> lock(s_nvsMutex);
+    const NvsValue* v = findValue(_ns, key, 's');
+    return v ? String(v->data) : defaultValue;
+}
+
+float Preferences::getFloat(const char* key, float defaultValue) { return getScalar(_open, _ns, key, 'f', defaultValue); }
+int32_t Preferences::getInt(const char* key, int32_t defaultValue) { return getScalar(_open, _ns, key, 'i', defaultValue); }
+uint32_t Preferences::getUInt(const char* key, uint32_t defaultValue) { return getScalar(_open, _ns, key, 'u', defaultValue); }
+uint8_t Preferences::getUChar(const char* key, uint8_t defaultValue) { return getScalar(_open, _ns, key, 'c', defaultValue); }
+bool Preferences::getBool(const char* key, bool defaultValue) { return getUChar(key, defaultValue ? 1 : 0) != 0; }
+
+size_t Preferences::getBytesLength(const char* key) {
+    if (!_open) return 0;
+    std::lock_guard<std::recursive_mutex> lock(s_nvsMutex);
+    const NvsValue* v = findValue(_ns, key, 'x');
+    return v ? v->data.size() : 0;
+}
+
+size_t Preferences::getBytes(const char* key, void* buf, size_t maxLen) {
+    if (!_open) return 0;
+    std::lock_guard<std::recursive_mutex> lock(s_nvsMutex);
+    const NvsValue* v = findValue(_ns, key, 'x');
+    if (!v || v->data.size() > maxLen) return 0;
+    memcpy(buf, v->data.data(), v->data.size());
+    return v->data.size();
+}
+
+// --- LittleFS ---
+fs::LittleFSFS LittleFS;
+static std::string s_fsRoot;
+
+void halSetFsRoot(const char* dir) { s_fsRoot = dir ? dir : ""; }
+
+bool fs::LittleFSFS::begin(bool formatOnFail, const char*, uint8_t, const char*) {
+    (void)formatOnFail;
+    if (s_fsRoot.empty()) return false;
+    struct stat st;
+    if (stat(s_fsRoot.c_str(), &st) != 0 && mkdir(s_fsRoot.c_str(), 0755) != 0) return false;
+    _root = String(s_fsRoot);
+    return true;
+}
+
+bool fs::LittleFSFS::format() {
+    if (_root.length() == 0) return false;
+    DIR* d = opendir(_root.c_str());
+    if (!d) return false;
+    while (struct dirent* e = readdir(d)) {
+        if (e->d_type == DT_REG) ::remove((std::string(_root.c_str()) + "/" + e->d_name).c_str());
+    }
+    closedir(d);
+    return true;
+}
+
+size_t fs::LittleFSFS::usedBytes() {
+    size_t used = 0;
+    DIR* d = _root.length() ? opendir(_root.c_str()) : nullptr;
+    if (!d) return 0;
+    while (struct dirent* e = readdir(d)) {
+        struct stat st;
+        std::string path = std::string(_root.c_str()) + "/" + e->d_name;
+        if (e->d_type == DT_REG && stat(path.c_str(), &st) == 0) used += (size_t)st.st_size;
+    }
+    closedir(d);
+    return used;
+}
+
+fs::File fs::FS::open(const char* path, const char* mode) {
+    if (_root.length() == 0 || !path || path[0] != '/') return File();
+    const char* hostMode = mode[0] == 'w' ? "wb" : mode[0] == 'a' ? "ab" : "rb";
+    FILE* f = fopen(hostPath(path).c_str(), hostMode);
+    return f ? File(f, String(path)) : File();
+}
+
+bool fs::FS::exists(const char* path) {
+    struct stat st;
+    return _root.length() && stat(hostPath(path).c_str(), &st) == 0;
+}
+
+bool fs::FS::remove(const char* path) { return _root.length() && ::remove(hostPath(path).c_str()) == 0; }
+
+bool fs::FS::rename(const char* from, const char* to) {
+    return _root.length() && ::rename(hostPath(from).c_str(), hostPath(to).c_str()) == 0;
+}
+
+size_t fs::File::size() const {
+    struct stat st;
+    if (!_f) return 0;
+    fflush(_f.get());
+    return fstat(fileno(_f.get()), &st) == 0 ? (size_t)st.st_size : 0;
+}
+
+int fs::File::available() {
+    if (!_f) return 0;
+    size_t pos = position();
+    size_t total = size();
+    return total > pos ? (int)(total - pos) : 0;
+}
+
+String fs::File::readString() {
+    std::string data;
+    char buf[1024];
+    size_t n;
+    while ((n = read((uint8_t*)buf, sizeof(buf))) > 0) data.append(buf, n);
+    return String(data);
+}
+
+size_t fs::File::printf(const char* fmt, ...) {
+    if (!_f) return 0;
+    va_list ap;
+    va_start(ap, fmt);
+    int n = vfprintf(_f.get(), fmt, ap);
+    va_end(ap);
+    return n > 0 ? (size_t)n : 0;
+}
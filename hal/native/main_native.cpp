@@ -0,0 +1,183 @@
+// Host entry point: runs the firmware's setup()/loop() as a Linux process on the native HAL.
+//
+//   touchclock [--duration S] [--wifi SSID:PASS] [--nvs FILE] [--fs DIR] [--fixtures DIR]
+//              [--light MV] [--touch FILE] [--request "[@MS ]METHOD URI"]... [--trace]
+//
+// Every FreeRTOS task runs on its own thread against the host clock. --wifi puts an access
+// point in range and, unless the NVS file already has credentials, stores them so the
+// firmware joins it on boot. --request runs a web request against the config server once
+// the firmware has been up for MS milliseconds and prints the response.
+#include <Arduino.h>
+#include <Preferences.h>
+#include <WiFi.h>
+#include <unistd.h>
+#include <string>
+#include <thread>
+#include <vector>
+#include "hal_native.h"
+
+void setup();
+void loop();
+
+struct ScheduledRequest {
+    uint32_t atMs;
+    std::string method;
+    std::string uri;
+    bool done;
+};
+
+// Replays a TouchRecorder trace (see src/TouchRecorder.h) through the XPT2046 and PENIRQ
+// shims at its recorded pace, starting at the first record
+static void replayTouchTrace(std::string path) {
+    FILE* f = fopen(path.c_str(), "r");
+    if (!f) {
+        fprintf(stderr, "touchclock: cannot open %s\n", path.c_str());
+        return;
+    }
+    char line[128];
+    long firstUs = -1;
+    uint64_t startUs = halMicros();
+    while (fgets(line, sizeof(line), f)) {
+        int x, y, z, pen;
+        long us;
+        char kind = line[0];
+        if (kind == 'D' && sscanf(line + 1, "%ld", &us) == 1) {
+            pen = 1;
+            x = y = z = -1;
+        } else if (kind == 'S' && sscanf(line + 1, "%d %d %d %d %ld", &x, &y, &z, &pen, &us) == 5) {
+        } else {
+            continue;
+        }
+        if (firstUs < 0) firstUs = us;
+        uint64_t due = startUs + (uint64_t)(us - firstUs);
+        uint64_t now = halMicros();
+        if (due > now) std::this_thread::sleep_for(std::chrono::microseconds(due - now));
+        if (z >= 0) halSetTouchPoint((int16_t)x, (int16_t)y, (int16_t)z);
+        halSetPin(36, pen ? LOW : HIGH);  // PENIRQ
+    }
+    fclose(f);
+    halSetTouchPoint(0, 0, 0);
+    halSetPin(36, HIGH);
+}
+
+// hal/native/fixtures, found from where this file was compiled so the default does not
+// depend on the working directory when the build used absolute paths
+static std::string fixturesBesideSource() {
+    std::string src = __FILE__;
+    size_t slash = src.rfind('/');
+    return (slash == std::string::npos ? std::string(".") : src.substr(0, slash)) + "/fixtures";
+}
+
+static void usage() {
+    fprintf(stderr,
+            "usage: touchclock [--duration S] [--wifi SSID:PASS] [--nvs FILE] [--fs DIR]\n"
+            "                  [--fixtures DIR] [--light MV] [--touch FILE]\n"
+            "                  [--request \"[@MS ]METHOD URI\"]... [--trace]\n");
+}
+
+int main(int argc, char** argv) {
+    double durationSec = 0;  // 0: run until killed
+    std::string wifi, nvsFile, fsRoot, touchFile;
+    std::string fixtures = fixturesBesideSource();
+    int lightMv = 1800;  // indoor daylight on the CYD's LDR divider
+    bool trace = false;
+    std::vector<ScheduledRequest> requests;
+
+    for (int i = 1; i < argc; i++) {
+        std::string a = argv[i];
+        bool hasValue = i + 1 < argc;
+        if (a == "--duration" && hasValue) {
+            durationSec = atof(argv[++i]);
+        } else if (a == "--wifi" && hasValue) {
+            wifi = argv[++i];
+        } else if (a == "--nvs" && hasValue) {
+            nvsFile = argv[++i];
+        } else if (a == "--fs" && hasValue) {
+            fsRoot = argv[++i];
+        } else if (a == "--fixtures" && hasValue) {
+            fixtures = argv[++i];
+        } else if (a == "--light" && hasValue) {
+            lightMv = atoi(argv[++i]);
+        } else if (a == "--touch" && hasValue) {
+            touchFile = argv[++i];
+        } else if (a == "--request" && hasValue) {
+            std::string spec = argv[++i];
+            ScheduledRequest r{0, "GET", "", false};
+            if (spec[0] == '@') {
+                size_t sp = spec.find(' ');
+                r.atMs = (uint32_t)atol(spec.c_str() + 1);
+                spec = sp == std::string::npos ? "" : spec.substr(sp + 1);
+            }
+            size_t sp = spec.find(' ');
+            if (sp != std::string::npos) {
+                r.method = spec.substr(0, sp);
+                r.uri = spec.substr(sp + 1);
+            } else {
+                r.uri = spec;
+            }
+            requests.push_back(r);
+        } else if (a == "--trace") {
+            trace = true;
+        } else {
+            usage();
+            return 2;
+        }
+    }
+
+    if (trace) halSetTrace(stdout);
+    if (!nvsFile.empty()) halSetNvsFile(nvsFile.c_str());
+    if (!fsRoot.empty()) halSetFsRoot(fsRoot.c_str());
+    if (!fixtures.empty() && !halSetHttpFixtures(fixtures.c_str())) {
+        fprintf(stderr, "touchclock: no fixtures directory at %s (pass --fixtures DIR, or \"\" for none)\n",
+                fixtures.c_str());
+        return 2;
+    }
+    halSetAdcMilliVolts(6, (uint16_t)lightMv);  // ADC1_CHANNEL_6: light sensor on GPIO34
+
+    if (!wifi.empty()) {
+        size_t colon = wifi.find(':');
+        std::string ssid = wifi.substr(0, colon);
+        std::string pass = colon == std::string::npos ? "" : wifi.substr(colon + 1);
+        halAddAccessPoint(ssid.c_str(), pass.c_str());
+        Preferences prefs;
+        prefs.begin("wifi", false);
+        if (!prefs.isKey("ssid")) {
+            prefs.putString("ssid", ssid.c_str());
+            prefs.putString("pass", pass.c_str());
+        }
+        prefs.end();
+    }
+
+    halRunTasks(true);
+    setup();
+
+    if (!touchFile.empty()) std::thread(replayTouchTrace, touchFile).detach();
+
+    uint64_t loops = 0;
+    while (durationSec <= 0 || millis() < durationSec * 1000.0) {
+        loop();
+        loops++;
+        for (auto& r : requests) {
+            if (r.done || millis() < r.atMs) continue;
+            r.done = true;
+            String body;
+            int code = halWebRequest(r.method.c_str(), r.uri.c_str(), nullptr, &body);
+            printf("--- %s %s -> %d\n%s\n---\n", r.method.c_str(), r.uri.c_str(), code, body.c_str());
+        }
+    }
+
+    HalDisplayStats d = halDisplayStats();
+    HalDacStats dac = halDacStats();
+    printf("\n=== touchclock (native) after %.1f s, %llu loop passes ===\n", millis() / 1000.0,
+           (unsigned long long)loops);
+    printf("display: %u fills, %u lines, %u texts, %u images, %llu px filled, panel %s\n", d.fills, d.lines,
+           d.texts, d.images, (unsigned long long)d.pixelsFilled, d.sleeping ? "asleep" : "awake");
+    printf("network: %u HTTP requests, WiFi %s\n", halHttpRequestCount(),
+           WiFi.status() == WL_CONNECTED ? "connected" : "down");
+    printf("audio:   %llu DAC frames, peak %u\n", (unsigned long long)dac.frames, dac.peak);
+    printf("heap:    %u free, %u min free, %u tasks\n", ESP.getFreeHeap(), ESP.getMinFreeHeap(),
+           halCreatedTaskCount());
+    fflush(stdout);
+    // Task threads never return; skip static destructors that would tear objects down under them
+    _exit(0);
+}
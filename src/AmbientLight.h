@@ -0,0 +1,79 @@
+#pragma once
+#include <stdint.h>
+#include "StreamStats.h"
+
+// Ambient light model fed with one calibrated reading (mV) every 500 ms. The LDR divider
+// reads lower when it is brighter, so a flashlight on the sensor is a sharp drop.
+//
+// For the first CALIBRATION_SAMPLES readings the baseline is the plain 10-second mean.
+// After that it adapts with a time constant of a few minutes, so dawn, dusk and room
+// lamps move it instead of blanking the screen. A reading held below ENTER_PCT of the
+// baseline for ENTER_SAMPLES in a row (2 s) is a "bright light" event, and it does not
+// fire again until the light has come back above EXIT_PCT (or rearm() is called).
+// Detection runs on a 5-reading median, so single-sample ADC glitches never count.
+//
+// Platform-free: LightSensorManager runs it on the device and tools/light_replay.cpp
+// replays recorded traces through it.
+class AmbientLight {
+public:
+    static const uint16_t SAMPLE_INTERVAL_MS = 500;
+    static const uint8_t CALIBRATION_SAMPLES = 20;  // 10 s
+    static const uint8_t ADAPT_SHIFT = 9;           // alpha 1/512: ~4.3 min time constant
+    static const uint8_t ENTER_PCT = 50;            // bright: below half the baseline...
+    static const uint8_t EXIT_PCT = 70;             // ...until back above 70%
+    static const uint8_t ENTER_SAMPLES = 4;         // 2 s
+
+    enum Event : uint8_t { NONE, CALIBRATED, BRIGHT_LIGHT, BRIGHT_LIGHT_GONE };
+
+private:
+    RunningWindow<uint16_t, 10> _avg5s;
+    RunningWindow<uint16_t, 20> _avg10s;
+    WindowMinMax<uint16_t, 20> _range10s;
+    MedianWindow<uint16_t, 5> _median;
+    BaselineDetector<ADAPT_SHIFT, ENTER_PCT, EXIT_PCT, ENTER_SAMPLES> _detector;
+    uint16_t _latest = 0;
+    uint8_t _calibrationLeft = CALIBRATION_SAMPLES;
+
+public:
+    // Start (or restart) with the first reading
+    void begin(uint16_t mv) {
+        _avg5s.fill(mv);
+        _avg10s.fill(mv);
+        _detector.seed(mv);
+        _latest = mv;
+        _calibrationLeft = CALIBRATION_SAMPLES;
+    }
+
+    Event add(uint16_t mv) {
+        _latest = mv;
+        _avg5s.push(mv);
+        _avg10s.push(mv);
+        _range10s.push(mv);
+        _median.push(mv);
+
+        if (_calibrationLeft > 0) {
+            _detector.seed(_avg10s.mean());
+            return --_calibrationLeft == 0 ? CALIBRATED : NONE;
+        }
+
+        switch (_detector.update(_median.median())) {
+            case decltype(_detector)::ENTERED: return BRIGHT_LIGHT;
+            case decltype(_detector)::EXITED: return BRIGHT_LIGHT_GONE;
+            default: return NONE;
+        }
+    }
+
+    // Let a light that is still on trigger again (e.g. after a touch woke the screen)
+    void rearm() { _detector.rearm(); }
+
+    bool isCalibrating() const { return _calibrationLeft > 0; }
+    bool isBright() const { return _detector.active(); }
+    uint16_t latest() const { return _latest; }
+    uint16_t average5s() const { return _avg5s.mean(); }
+    uint16_t average10s() const { return _avg10s.mean(); }
+    uint16_t min10s() const { return _range10s.min(); }
+    uint16_t max10s() const { return _range10s.max(); }
+    uint16_t median() const { return _median.median(); }
+    uint16_t baseline() const { return (uint16_t)_detector.baseline(); }
+    uint16_t threshold() const { return (uint16_t)_detector.enterThreshold(); }
+};
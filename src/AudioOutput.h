@@ -0,0 +1,197 @@
+#pragma once
+#include <Arduino.h>
+#include <atomic>
+#include <driver/i2s.h>
+#include "Metrics.h"
+
+// Speaker output through I2S0 in built-in DAC mode (CYD speaker on GPIO26 = DAC channel 2).
+// A low-priority task pulls fixed-size blocks from a render callback and queues them for
+// DMA. The peripheral is only clocked between start() and the callback reporting the end
+// of playback, so an idle clock takes no audio interrupts at all.
+class AudioOutput {
+public:
+    static constexpr uint32_t SAMPLE_RATE = 22050;  // speaker rolls off well below 11 kHz
+    static constexpr size_t BLOCK_FRAMES = 256;     // ~11.6 ms per block
+    static constexpr int DMA_BUF_COUNT = 4;         // ~46 ms queued ahead of the DAC
+
+    // Fills `frames` signed 16-bit mono samples; returns false once playback has finished
+    typedef bool (*RenderCallback)(void* ctx, int16_t* out, size_t frames);
+    // true as a playback is requested, false once the DAC is parked again (e.g. power locks)
+    typedef void (*PlaybackCallback)(void* ctx, bool playing);
+
+private:
+    static constexpr i2s_port_t PORT = I2S_NUM_0;  // built-in DAC is only wired to I2S0
+
+    TaskHandle_t _taskHandle = nullptr;
+    RenderCallback _render = nullptr;
+    void* _renderCtx = nullptr;
+    volatile bool _running = false;
+    PlaybackCallback _playback = nullptr;
+    void* _playbackCtx = nullptr;
+    std::atomic<bool> _playbackHeld{false};  // the callback last reported playing
+
+    // Reports each transition once, whichever of start() and the task gets there first
+    void notePlayback(bool playing) {
+        if (_playbackHeld.exchange(playing) != playing && _playback) _playback(_playbackCtx, playing);
+    }
+
+    int16_t _mono[BLOCK_FRAMES];
+    uint16_t _frames[BLOCK_FRAMES * 2];  // DAC mode consumes 16-bit L/R pairs, upper byte only
+
+    // Stats for the last playback (written by the audio task)
+    uint32_t _blocks = 0;
+    uint64_t _renderUs = 0;
+    uint32_t _maxRenderUs = 0;
+    uint32_t _playbackMs = 0;
+
+    static void audioTaskWrapper(void* param) {
+        static_cast<AudioOutput*>(param)->audioTask();
+    }
+
+    // Signed 16-bit mono -> 8-bit DAC code in the high byte of both slots
+    void packFrames(const int16_t* in, size_t frames) {
+        for (size_t i = 0; i < frames; i++) {
+            uint16_t dac = (uint16_t)dacCode(in[i]) << 8;
+            _frames[2 * i] = dac;
+            _frames[2 * i + 1] = dac;
+        }
+    }
+
+    void writeFrames() {
+        size_t written = 0;
+        i2s_write(PORT, _frames, sizeof(_frames), &written, portMAX_DELAY);
+    }
+
+    // Park the DAC at mid-scale: flush every DMA buffer with silence so the last
+    // value latched when the clock stops is the centre voltage (no click)
+    void writeSilence() {
+        memset(_mono, 0, sizeof(_mono));
+        packFrames(_mono, BLOCK_FRAMES);
+        for (int i = 0; i < DMA_BUF_COUNT; i++) {
+            writeFrames();
+        }
+    }
+
+    void audioTask() {
+        writeSilence();
+        i2s_stop(PORT);
+
+        for (;;) {
+            // Sleep until start(); nothing runs while the clock is idle
+            ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+            notePlayback(true);  // normally already done by start()
+
+            _running = true;
+            _blocks = 0;
+            _renderUs = 0;
+            _maxRenderUs = 0;
+            unsigned long startMs = millis();
+            i2s_start(PORT);
+
+            bool more = true;
+            while (more) {
+                uint32_t t0 = micros();
+                more = _render(_renderCtx, _mono, BLOCK_FRAMES);
+                packFrames(_mono, BLOCK_FRAMES);
+                uint32_t dt = micros() - t0;
+
+                _blocks++;
+                _renderUs += dt;
+                if (dt > _maxRenderUs) _maxRenderUs = dt;
+                metricAudioRenderDuration.observe(dt);
+
+                // Blocks here until a DMA buffer frees up
+                writeFrames();
+            }
+
+            writeSilence();
+            i2s_stop(PORT);
+            _playbackMs = millis() - startMs;
+            _running = false;
+            notePlayback(false);
+
+            Serial.printf("[Audio] Played %lu ms: %lu blocks, render avg %lu us / max %lu us per block, %.2f%% CPU\n",
+                          (unsigned long)_playbackMs, (unsigned long)_blocks,
+                          (unsigned long)(_blocks ? _renderUs / _blocks : 0), (unsigned long)_maxRenderUs,
+                          renderCpuPercent());
+        }
+    }
+
+public:
+    // Offset-binary code the built-in DAC outputs for a signed 16-bit sample
+    static inline uint8_t dacCode(int16_t sample) {
+        return (uint8_t)((uint16_t)(sample + 32768) >> 8);
+    }
+
+    ~AudioOutput() {
+        if (_taskHandle) {
+            vTaskDelete(_taskHandle);
+            i2s_driver_uninstall(PORT);
+        }
+    }
+
+    bool begin(RenderCallback render, void* ctx) {
+        _render = render;
+        _renderCtx = ctx;
+
+        i2s_config_t cfg = {};
+        cfg.mode = (i2s_mode_t)(I2S_MODE_MASTER | I2S_MODE_TX | I2S_MODE_DAC_BUILT_IN);
+        cfg.sample_rate = SAMPLE_RATE;
+        cfg.bits_per_sample = I2S_BITS_PER_SAMPLE_16BIT;
+        cfg.channel_format = I2S_CHANNEL_FMT_RIGHT_LEFT;
+        cfg.communication_format = I2S_COMM_FORMAT_STAND_MSB;
+        cfg.intr_alloc_flags = 0;
+        cfg.dma_buf_count = DMA_BUF_COUNT;
+        cfg.dma_buf_len = BLOCK_FRAMES;
+        cfg.use_apll = false;
+        cfg.tx_desc_auto_clear = false;  // underrun would repeat audio, but we always refill
+
+        if (i2s_driver_install(PORT, &cfg, 0, nullptr) != ESP_OK) {
+            Serial.println("ERROR: Failed to install I2S driver for DAC audio");
+            return false;
+        }
+        i2s_set_dac_mode(I2S_DAC_CHANNEL_LEFT_EN);  // GPIO26 only; GPIO25 stays free
+
+        // Create and pin audio task to Core 0, away from the UI tasks on Core 1
+        xTaskCreatePinnedToCore(
+            audioTaskWrapper,
+            "AudioTask",
+            3072,                  // Stack size (bytes)
+            this,                  // Task parameter
+            1,                     // Priority (low; DMA queue absorbs scheduling jitter)
+            &_taskHandle,
+            0                      // Core 0
+        );
+
+        Serial.printf("AudioOutput initialized (I2S DAC, %lu Hz, %u-frame blocks)\n",
+                      (unsigned long)SAMPLE_RATE, (unsigned)BLOCK_FRAMES);
+        return true;
+    }
+
+    // Begin pulling blocks from the render callback; harmless if already playing
+    void start() {
+        if (_taskHandle) {
+            notePlayback(true);  // in the caller's task, before the first block
+            xTaskNotifyGive(_taskHandle);
+        }
+    }
+
+    bool isRunning() const { return _running; }
+
+    // Set before the first start(); the false report comes from the audio task
+    void setPlaybackCallback(PlaybackCallback callback, void* ctx) {
+        _playback = callback;
+        _playbackCtx = ctx;
+    }
+
+    // Render time as a share of real time for the last playback
+    float renderCpuPercent() const {
+        uint64_t audioUs = (uint64_t)_blocks * BLOCK_FRAMES * 1000000ULL / SAMPLE_RATE;
+        return audioUs ? (float)(_renderUs * 100.0 / audioUs) : 0.0f;
+    }
+
+    uint32_t lastPlaybackMs() const { return _playbackMs; }
+    uint32_t stackHighWaterMark() const {
+        return _taskHandle ? uxTaskGetStackHighWaterMark(_taskHandle) : 0;
+    }
+};
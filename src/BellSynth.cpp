@@ -0,0 +1,242 @@
+#include "BellSynth.h"
+#include <cmath>
+
+// Church-bell partial series relative to the struck (prime) note. The tierce is a minor
+// third and the superquint sits slightly sharp of a harmonic, which gives the inharmonic
+// "clang"; higher partials die away first, leaving the hum ringing on.
+const BellSynth::Partial BellSynth::BELL_PARTIALS[PARTIALS] = {
+    // ratio  weight  tau (s)
+    {0.500f, 0.22f, 3.20f},  // hum
+    {1.000f, 0.30f, 2.20f},  // prime (strike note)
+    {1.189f, 0.16f, 1.60f},  // tierce
+    {1.505f, 0.10f, 1.20f},  // quint
+    {2.000f, 0.14f, 0.90f},  // nominal
+    {2.664f, 0.08f, 0.50f},  // superquint
+};
+
+void BellSynth::begin(uint32_t sampleRate, size_t blockFrames) {
+    _sampleRate = sampleRate;
+    _blockFrames = blockFrames > MAX_BLOCK ? MAX_BLOCK : blockFrames;
+    memset(_voices, 0, sizeof(_voices));
+    Strike dropped;
+    while (_strikes.pop(dropped)) {
+    }
+    _releaseRequested = false;
+    _activeVoices = 0;
+}
+
+bool BellSynth::strike(float freqHz, float level, float ringScale, uint16_t offset) {
+    if (freqHz <= 0.0f || level <= 0.0f) return false;
+    if (level > 1.0f) level = 1.0f;
+    if (ringScale <= 0.0f) ringScale = 1.0f;
+
+    // Float setup runs here, once per strike, on the striking task: the sequencer's, so
+    // the audio task for chimes. The per-sample render loop only sees integers.
+    Strike s;
+    s.offset = offset;
+    for (uint8_t k = 0; k < PARTIALS; k++) {
+        const Partial& p = BELL_PARTIALS[k];
+        float f = freqHz * p.ratio;
+        if (f >= _sampleRate * 0.5f) {
+            // Above Nyquist: drop the partial rather than alias it
+            s.inc[k] = 0;
+            s.amp[k] = 0;
+            s.decay[k] = 0;
+            continue;
+        }
+        s.inc[k] = (uint32_t)((double)f / _sampleRate * 4294967296.0);
+        s.amp[k] = (int32_t)(level * p.weight * 32767.0f);
+        float perBlock = expf(-(float)_blockFrames / (_sampleRate * p.tauSec * ringScale));
+        uint32_t decay = (uint32_t)(perBlock * 65536.0f);
+        s.decay[k] = (uint16_t)(decay > 65535 ? 65535 : decay);
+    }
+
+    bool queued = _strikes.push(s);
+    if (!queued) {
+        Serial.println("[BellSynth] Strike queue full, dropping strike");
+    }
+    return queued;
+}
+
+void BellSynth::setVolume(uint8_t percent) {
+    if (percent > 100) percent = 100;
+    // ~1.4x per percent matches the loudness of the old single-sine chime
+    _masterGain = (int32_t)percent * 458;
+}
+
+void BellSynth::startVoice(const Strike& s) {
+    // Free voice first; otherwise steal the quietest (normally a strike that has all but
+    // died away, so the cut is inaudible). Voices already taken over in this block are
+    // left alone.
+    Voice* target = nullptr;
+    int32_t quietest = INT32_MAX;
+    for (uint8_t i = 0; i < MAX_VOICES; i++) {
+        Voice& v = _voices[i];
+        if (v.restart) continue;
+        if (!v.active) {
+            target = &v;
+            break;
+        }
+        int32_t level = 0;
+        for (uint8_t k = 0; k < PARTIALS; k++) level += v.osc[k].amp;
+        level = (int32_t)(((int64_t)level * v.env) >> 15);
+        if (level < quietest) {
+            quietest = level;
+            target = &v;
+        }
+    }
+    if (!target) return;  // more strikes in one block than voices
+
+    target->next = s;
+    target->restart = true;
+}
+
+void BellSynth::loadVoice(Voice& v) {
+    for (uint8_t k = 0; k < PARTIALS; k++) {
+        Oscillator& o = v.osc[k];
+        o.phase = 0;
+        o.inc = v.next.inc[k];
+        o.amp = v.next.amp[k];
+        o.decay = v.next.decay[k];
+    }
+    v.env = 0;
+    v.envStep = 32767 / ATTACK_SAMPLES;
+    v.active = true;
+    v.restart = false;
+}
+
+void BellSynth::renderSpan(Voice& v, size_t from, size_t to) {
+    memset(_voiceBuf + from, 0, (to - from) * sizeof(int32_t));
+
+    bool audible = false;
+    for (uint8_t k = 0; k < PARTIALS; k++) {
+        Oscillator& o = v.osc[k];
+        if (o.amp <= SILENT_AMP) {
+            o.amp = 0;
+            continue;
+        }
+        audible = true;
+
+        // Exponential decay per block, linearly interpolated across it (no zipper steps).
+        // A voice cut short by a steal squeezes its last block's decay into the span, which
+        // only matters for a strike that is about to be replaced anyway.
+        int32_t ampEnd = (int32_t)(((uint32_t)o.amp * o.decay) >> 16);
+        int32_t ampStep = (ampEnd - o.amp) / (int32_t)(to - from);
+        uint32_t phase = o.phase;
+        const uint32_t inc = o.inc;
+        int32_t amp = o.amp;
+        for (size_t i = from; i < to; i++) {
+            _voiceBuf[i] += (Sine::sample(phase) * amp) >> 15;
+            phase += inc;
+            amp += ampStep;
+        }
+        o.phase = phase;
+        o.amp = ampEnd;
+    }
+
+    // Attack/release envelope, then into the mix
+    int32_t env = v.env;
+    int32_t step = v.envStep;
+    bool released = false;
+    for (size_t i = from; i < to; i++) {
+        if (step != 0) {
+            env += step;
+            if (env >= 32767) {
+                env = 32767;
+                step = 0;
+            } else if (env <= 0) {
+                env = 0;
+                step = 0;
+                released = true;
+            }
+        }
+        _mixBuf[i] += (_voiceBuf[i] * env) >> 15;
+    }
+    v.env = env;
+    v.envStep = step;
+
+    if (!audible || released) {
+        v.active = false;
+    }
+}
+
+void BellSynth::renderVoice(Voice& v, size_t frames) {
+    size_t from = 0;
+    if (v.restart) {
+        // The old strike (if any) rings up to the new onset, then the new one takes over
+        size_t onset = v.next.offset < frames ? v.next.offset : frames;
+        if (v.active && onset > 0) renderSpan(v, 0, onset);
+        if (onset == frames) {
+            v.next.offset -= frames;
+            return;
+        }
+        loadVoice(v);
+        from = onset;
+    }
+    renderSpan(v, from, frames);
+}
+
+void BellSynth::render(int16_t* out, size_t frames) {
+    uint32_t startCycles = ESP.getCycleCount();
+    if (frames > MAX_BLOCK) frames = MAX_BLOCK;
+
+    // Release first, then pick up strikes queued since the last block
+    if (_releaseRequested.exchange(false)) {
+        for (uint8_t i = 0; i < MAX_VOICES; i++) {
+            if (_voices[i].active) _voices[i].envStep = -(32767 / RELEASE_SAMPLES);
+        }
+    }
+    Strike incoming;
+    while (_strikes.pop(incoming)) {
+        startVoice(incoming);
+    }
+
+    memset(_mixBuf, 0, frames * sizeof(int32_t));
+    uint8_t active = 0;
+    for (uint8_t i = 0; i < MAX_VOICES; i++) {
+        if (!_voices[i].active && !_voices[i].restart) continue;
+        renderVoice(_voices[i], frames);
+        if (_voices[i].active) active++;
+    }
+    _activeVoices = active;
+
+    // Master gain and saturation to 16 bits
+    for (size_t i = 0; i < frames; i++) {
+        int32_t s = (int32_t)(((int64_t)_mixBuf[i] * _masterGain) >> 15);
+        if (s > 32767) {
+            s = 32767;
+            _clipCount++;
+        } else if (s < -32768) {
+            s = -32768;
+            _clipCount++;
+        }
+        out[i] = (int16_t)s;
+    }
+
+    _renderCycles += (uint32_t)(ESP.getCycleCount() - startCycles);
+    _renderedSamples += frames;
+}
+
+uint32_t BellSynth::benchmark(uint16_t blocks) {
+    // Worst case: every voice ringing, none decaying out during the run
+    int16_t scratch[MAX_BLOCK];
+    for (uint8_t v = 0; v < MAX_VOICES; v++) {
+        if (_strikes.size() == MAX_PENDING) render(scratch, _blockFrames);
+        strike(165.0f * (1.0f + 0.5f * v), 1.0f, 20.0f);
+    }
+    render(scratch, _blockFrames);
+
+    _renderCycles = 0;
+    _renderedSamples = 0;
+    for (uint16_t b = 0; b < blocks; b++) {
+        render(scratch, _blockFrames);
+    }
+    uint32_t cycles = cyclesPerSample();
+
+    memset(_voices, 0, sizeof(_voices));
+    _activeVoices = 0;
+    _clipCount = 0;
+    _renderCycles = 0;
+    _renderedSamples = 0;
+    return cycles;
+}
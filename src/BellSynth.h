@@ -0,0 +1,117 @@
+#pragma once
+#include <Arduino.h>
+#include <atomic>
+#include "SpscRing.h"
+#include "Wavetable.h"
+
+// Block-rendered, fixed-point bell synthesiser.
+// Each voice is one bell strike made of inharmonic partials (hum, prime, tierce, quint,
+// nominal, superquint) that decay exponentially at their own rate, under a short attack
+// ramp and an optional release ramp. Strikes go through a lock-free ring and land at a
+// sample offset within the next block; when all voices are busy the quietest one is stolen
+// at that sample, so successive strikes ring over each other like a real tower.
+//
+// The render path is integer-only: 32-bit phase accumulators, an interpolated Q15 DRAM
+// wavetable, Q15 amplitudes interpolated across the block and one Q16 decay multiply per
+// partial per block.
+class BellSynth {
+public:
+    static const uint8_t MAX_VOICES = 6;
+    static const uint8_t PARTIALS = 6;
+    static const size_t MAX_BLOCK = 256;
+    // Interpolated 256-entry table: THD+N about -91 dB, far below the 8-bit DAC. The
+    // 1024-entry table only gains ~4 dB for 1.5 KB more DRAM (tools/wavetable_bench.cpp)
+    typedef Wavetable<256> Sine;
+    static const uint8_t MAX_PENDING = 4;
+
+    struct Partial {
+        float ratio;   // frequency relative to the struck note
+        float weight;  // share of the voice amplitude
+        float tauSec;  // exponential decay time constant
+    };
+    static const Partial BELL_PARTIALS[PARTIALS];
+
+private:
+    static const uint16_t ATTACK_SAMPLES = 48;     // ~2 ms: softens the hammer click
+    static const uint16_t RELEASE_SAMPLES = 1024;  // ~46 ms fade for releaseAll()
+    static const int32_t SILENT_AMP = 32;          // partial amplitude (Q15) treated as silent (-60 dB)
+
+    struct Oscillator {
+        uint32_t phase;
+        uint32_t inc;
+        int32_t amp;     // Q15
+        uint16_t decay;  // Q16 multiplier applied once per block
+    };
+
+    // Strike prepared by the caller (floats) and handed to the render task as integers
+    struct Strike {
+        uint32_t inc[PARTIALS];
+        int32_t amp[PARTIALS];
+        uint16_t decay[PARTIALS];
+        uint16_t offset;
+    };
+
+    struct Voice {
+        Oscillator osc[PARTIALS];
+        int32_t env;      // Q15 attack/release envelope
+        int32_t envStep;  // per-sample change
+        bool active;
+        // Strike taking over this voice at next.offset in the current block; whatever the
+        // voice was playing keeps sounding until then (sample-accurate onset and steal)
+        bool restart;
+        Strike next;
+    };
+
+    uint32_t _sampleRate = 22050;
+    size_t _blockFrames = MAX_BLOCK;
+    int32_t _masterGain = 32767;  // Q15
+
+    Voice _voices[MAX_VOICES];
+    int32_t _voiceBuf[MAX_BLOCK];
+    int32_t _mixBuf[MAX_BLOCK];
+
+    SpscRing<Strike, MAX_PENDING> _strikes;  // strike() -> render()
+    std::atomic<bool> _releaseRequested{false};
+
+    // Render statistics
+    volatile uint8_t _activeVoices = 0;
+    uint32_t _clipCount = 0;
+    uint64_t _renderCycles = 0;
+    uint64_t _renderedSamples = 0;
+
+    void startVoice(const Strike& s);
+    void loadVoice(Voice& v);
+    void renderSpan(Voice& v, size_t from, size_t to);
+    void renderVoice(Voice& v, size_t frames);
+
+public:
+    // blockFrames must match the caller's render size so decay rates are exact
+    void begin(uint32_t sampleRate, size_t blockFrames);
+
+    // Queue a strike (one producer task at a time). level is 0..1 of the voice's full scale;
+    // ringScale stretches every partial's decay (e.g. a heavier hour bell);
+    // offset delays the onset by that many samples into the next rendered block
+    bool strike(float freqHz, float level = 1.0f, float ringScale = 1.0f, uint16_t offset = 0);
+
+    // Fade every ringing voice out over ~46 ms
+    void releaseAll() { _releaseRequested = true; }
+
+    // Master output level, 0-100 %
+    void setVolume(uint8_t percent);
+
+    // Render task only: mixes all voices into frames signed 16-bit samples
+    void render(int16_t* out, size_t frames);
+
+    bool isActive() const { return _activeVoices > 0 || !_strikes.empty(); }
+    uint8_t activeVoices() const { return _activeVoices; }
+    uint32_t clipCount() const { return _clipCount; }
+
+    // Average CPU cycles spent per output sample since boot (0 before the first render)
+    uint32_t cyclesPerSample() const {
+        return _renderedSamples ? (uint32_t)(_renderCycles / _renderedSamples) : 0;
+    }
+
+    // Render `blocks` blocks with every voice ringing and return cycles/sample.
+    // Call before the audio task starts; voices and statistics are reset afterwards.
+    uint32_t benchmark(uint16_t blocks);
+};
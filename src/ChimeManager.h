@@ -1,246 +1,148 @@
 #pragma once
 #include <Arduino.h>
 #include <cmath>
-
-// Forward declarations for interrupt handler
-extern volatile bool chimeTimerActive;
-extern volatile uint32_t chimePhaseAccumulator;
-extern volatile uint32_t chimePhaseIncrement;
-extern volatile uint8_t chimeAmplitude;
-extern volatile uint32_t chimeSampleCount;
-extern volatile uint32_t chimeNoteSampleTarget;
-extern volatile bool chimeNoteCompleted;
-
-// Global interrupt handler
-void chimeTimerHandler();
+#include "AudioOutput.h"
+#include "BellSynth.h"
+#include "ChimeSequencer.h"
+#include "SpscRing.h"
 
 // Non-blocking Westminster/Big Ben style chimes using DAC output
-// CYD speaker is on GPIO26 (DAC_CHANNEL_2)
+// CYD speaker is on GPIO26 (DAC_CHANNEL_2), driven by I2S DMA through AudioOutput.
+// Chimes are bytecode programs (ChimeSequencer.h) interpreted inside the audio task, so
+// every strike lands on its exact sample no matter how long loop() blocks.
+// loop() and the audio task share no state beyond two lock-free rings: whole play commands
+// go down, started/finished reports come back.
 class ChimeManager {
-    int _speakerPin = 26;  // CYD speaker on GPIO26 (DAC_CHANNEL_2)
-    int _lastChimedHour = -1;
-
-    // DAC and timer config
-    hw_timer_t* _timer;
-    static constexpr uint32_t SAMPLE_RATE = 44000; // 44kHz sample rate for smooth sine interpolation
-    static constexpr uint8_t DC_OFFSET = 128; // DAC center point
+    int _lastChimeSlot = -1;      // hour * 4 + quarter of the last chime played
+    bool _quarterChimes = false;  // also chime at :15, :30 and :45
+    uint32_t _benchmarkCyclesPerSample = 0;
+
+    // Audio output: samples are rendered in blocks only while a chime is playing
+    AudioOutput _audio;
+    BellSynth _synth;  // each note is a bell strike that rings on under the next
+    ChimeSequencer _sequencer;
+    static constexpr uint32_t SAMPLE_RATE = AudioOutput::SAMPLE_RATE;
     mutable uint8_t _volumePercent = 5; // Volume as percentage 0-100
 
-    struct Note { uint16_t freq; uint16_t ms; };
-
-    // Westminster Quarters full-hour sequence (E Major, Big Ben authentic)
-    static const Note WESTMINSTER_SEQUENCE[16];
-    static const uint16_t HOUR_STRIKE_FREQ;
-    static const uint16_t HOUR_STRIKE_DURATION;
-
-    // Non-blocking playback state machine
-    enum PlaybackState {
-        IDLE,
-        PLAYING_NOTE,
-        NOTE_GAP
+    // loop() -> audio task, picked up at the start of the next block
+    struct PlayCommand {
+        const ChimeOp* program;
+        uint8_t strikes;
+        uint32_t queuedMs;
     };
-
-    volatile PlaybackState _state = IDLE; // shared across cores
-    const Note* _currentSequence = nullptr;
-    volatile int _sequenceLength = 0;
-    volatile int _sequenceIndex = 0;
-    volatile int _strikeCount = 0;
-    volatile int _strikeIndex = 0;
-    volatile bool _inStrikeMode = false;
-    
-    // Current note playback state
-    volatile uint16_t _currentFreq = 0;
-    volatile unsigned long _noteStartMs = 0;
-    volatile unsigned long _noteDurationMs = 0;
-    
-    // Chime sequence tracking
-    enum ChimePhase {
-        PHASE_NONE,
-        PHASE_WESTMINSTER,           // Playing full Westminster Quarters sequence
-        PHASE_PAUSE_BEFORE_STRIKES,  // 1.5 second pause before hour gongs
-        PHASE_STRIKES,
-        PHASE_COMPLETE
+    // audio task -> loop(), drained by update()
+    struct ChimeStatus {
+        enum Type : uint8_t { STARTED, FINISHED };
+        Type type;
+        uint32_t value;  // STARTED: ms from request to first block; FINISHED: ms played
     };
-    volatile ChimePhase _chimePhase = PHASE_NONE; // accessed from multiple cores
-
-    void startNote(uint16_t freq, uint16_t durationMs) {
-        _currentFreq = freq;
-        _noteStartMs = millis();
-        _noteDurationMs = durationMs;
-        _state = PLAYING_NOTE;
-        
-        // Calculate phase increment for frequency
-        // phaseIncrement = (freq * 2^32) / sampleRate
-        chimePhaseIncrement = ((uint64_t)freq << 32) / SAMPLE_RATE;
-        
-        // Set amplitude based on volume (0-100% maps to 0-127 for sine wave)
-        chimeAmplitude = map(_volumePercent, 0, 100, 0, 127);
-        
-        // Initialize failsafe sample-count target
-        chimeSampleCount = 0;
-        chimeNoteSampleTarget = ((uint32_t)durationMs * SAMPLE_RATE) / 1000;
-        chimeNoteCompleted = false;
-        
-        // Start timer
-        chimeTimerActive = true;
+    // Only one chime is in flight at a time (see startProgram), so each ring holds at most
+    // one command / two reports
+    SpscRing<PlayCommand, 2> _commands;
+    SpscRing<ChimeStatus, 4> _status;
+    bool _playing = false;    // loop() side: sent, finish not yet reported
+    bool _rendering = false;  // audio side: program or its ring-out in progress
+
+    // Called from the audio task as each strike is rendered; keep it to a flag or a push
+    void (*_strikeCallback)(void*) = nullptr;
+    void* _strikeCtx = nullptr;
+
+    bool startProgram(const ChimeOp* program, uint8_t strikes) {
+        if (isPlaying()) return false; // Already playing
+        if (!_commands.push({program, strikes, (uint32_t)millis()})) return false;
+        _playing = true;
+        _audio.start();
+        return true;
     }
 
-    // Timer interrupt handler for DAC sample generation
-    void stopNote() {
-        chimeTimerActive = false;
-        chimePhaseAccumulator = 0;
-        dacWrite(26, DC_OFFSET); // Return to center voltage
+    // Sequencer strike sink (audio task)
+    static void strikeBell(void* ctx, uint16_t hz, float ring, uint16_t offset) {
+        ChimeManager* self = static_cast<ChimeManager*>(ctx);
+        self->_synth.strike(hz, 1.0f, ring, offset);
+        if (self->_strikeCallback) self->_strikeCallback(self->_strikeCtx);
     }
 
-    void startNextNote() {
-        if (_inStrikeMode) {
-            if (_strikeIndex < _strikeCount) {
-                startNote(HOUR_STRIKE_FREQ, HOUR_STRIKE_DURATION); // E3 Big Ben strike
-                _strikeIndex++;
-                return;
-            } else {
-                // Strikes complete
-                _chimePhase = PHASE_COMPLETE;
-                _state = IDLE;
-                stopNote();
-                return;
-            }
-        }
-
-        // Westminster sequence playback
-        if (_sequenceIndex < _sequenceLength) {
-            const Note& note = _currentSequence[_sequenceIndex];
-            startNote(note.freq, note.ms);
-            _sequenceIndex++;
-        } else {
-            // Westminster sequence complete, move to pause before strikes
-            advanceChimePhase();
-        }
-    }
-
-    void advanceChimePhase() {
-        switch (_chimePhase) {
-            case PHASE_WESTMINSTER:
-                // Westminster complete, start pause before hour strikes
-                _chimePhase = PHASE_PAUSE_BEFORE_STRIKES;
-                _state = NOTE_GAP;
-                _noteStartMs = millis();  // Start the 1.5 second pause
-                // Don't call startNextNote() yet - pause first
-                break;
-            case PHASE_PAUSE_BEFORE_STRIKES:
-                // Pause complete, transition to strikes
-                _chimePhase = PHASE_STRIKES;
-                _inStrikeMode = true;
-                _strikeIndex = 0;
-                startNextNote();
-                break;
-            default:
-                _chimePhase = PHASE_COMPLETE;
-                _state = IDLE;
-                stopNote();
-                break;
-        }
-    }
-
-    void startChimeSequence(int strikes) {
-        if (_state != IDLE) return; // Already playing
-        
-        _chimePhase = PHASE_WESTMINSTER;
-        _currentSequence = WESTMINSTER_SEQUENCE;
-        _sequenceLength = 16;  // Full-hour Westminster sequence (phrases 2-5)
-        _sequenceIndex = 0;
-        _strikeCount = strikes;
-        _inStrikeMode = false;
-        startNextNote();
+    // AudioOutput render callback (audio task)
+    static bool renderBlock(void* ctx, int16_t* out, size_t frames) {
+        return static_cast<ChimeManager*>(ctx)->render(out, frames);
     }
 
 public:
-    void begin(int speakerPin = 26) {
-        _speakerPin = speakerPin;
-        
-        // Initialize DAC
-        dacWrite(_speakerPin, DC_OFFSET);
-        
-        // Setup hardware timer (Timer 0, prescaler 80 for 1MHz)
-        _timer = timerBegin(0, 80, true);
-        timerAttachInterrupt(_timer, &chimeTimerHandler, true);
-        timerAlarmWrite(_timer, 1000000 / SAMPLE_RATE, true); // Fire at SAMPLE_RATE Hz
-        timerAlarmEnable(_timer);
-        
-        chimeTimerActive = false;
-        chimePhaseAccumulator = 0;
-        chimePhaseIncrement = 0;
-        chimeAmplitude = 0;
+    // The built-in DAC on GPIO26 is fixed to I2S0, so there is no pin to choose
+    void begin() {
+        _synth.begin(SAMPLE_RATE, AudioOutput::BLOCK_FRAMES);
+        _synth.setVolume(_volumePercent);
+
+        // Worst-case synth cost, measured once before the audio task owns the synth
+        uint32_t cps = _synth.benchmark(32);
+        Serial.printf("[Chime] Bell synth: %u voices x %u partials = %lu cycles/sample (%.1f%% of one core at %lu Hz)\n",
+                      BellSynth::MAX_VOICES, BellSynth::PARTIALS, (unsigned long)cps,
+                      cps * (float)SAMPLE_RATE * 100.0f / (getCpuFrequencyMhz() * 1000000.0f),
+                      (unsigned long)SAMPLE_RATE);
+        _benchmarkCyclesPerSample = cps;
+
+        _sequencer.begin(SAMPLE_RATE, strikeBell, this);
+
+        // I2S DAC + DMA; the audio task sleeps until a chime starts
+        _audio.begin(renderBlock, this);
     }
 
-    // Must be called frequently from main loop for non-blocking audio generation
+    // Called from loop(); timing lives in the audio task, this only collects its reports
     void update() {
-        static unsigned long lastIdleLog = 0;
-        unsigned long nowMs = millis();
-
-        // Handle ISR signaled completion regardless of state
-        if (chimeNoteCompleted) {
-            chimeNoteCompleted = false;
-            stopNote();
-            _state = NOTE_GAP;
-            _noteStartMs = nowMs;
-        }
-
-        // Failsafe: if audio is active but state machine is idle and duration passed, stop and enter gap
-        if (chimeTimerActive && (_state == IDLE)) {
-            if (nowMs - _noteStartMs >= _noteDurationMs && _noteDurationMs > 0) {
-                stopNote();
-                _state = NOTE_GAP;
-                _noteStartMs = nowMs;
+        ChimeStatus status;
+        while (_status.pop(status)) {
+            if (status.type == ChimeStatus::STARTED) {
+                Serial.printf("[Chime] Started %lu ms after request\n", (unsigned long)status.value);
+            } else {
+                _playing = false;
+                Serial.printf("[Chime] Finished after %lu ms\n", (unsigned long)status.value);
             }
         }
+    }
 
-        if (_state == IDLE) {
-            return;
-        }
+    // Render the next block: called by the audio task, or directly by offline renderers
+    // (tools/chime_render.cpp). Returns false once the program is done and has rung out.
+    bool render(int16_t* out, size_t frames);
 
-        
+    // loop() side view: true from the request until update() sees the finish report
+    bool isPlaying() const { return _playing; }
 
-        if (_state == PLAYING_NOTE) {
-            // Check if note duration complete
-            if (nowMs - _noteStartMs >= _noteDurationMs) {
-                stopNote();
-                _state = NOTE_GAP;
-                _noteStartMs = nowMs;
-                return;
-            }
-        } else if (_state == NOTE_GAP) {
-            // Gap between notes in phrases (80ms for rhythm), between strikes (1000ms), before strikes (1500ms)
-            unsigned long gapMs;
-            if (_chimePhase == PHASE_PAUSE_BEFORE_STRIKES) {
-                gapMs = 1500; // 1.5 second pause before hour gongs
-            } else if (_inStrikeMode) {
-                gapMs = 1000; // gap between hour strikes
-            } else {
-                gapMs = 80; // normal inter-note gap in Westminster sequence
-            }
-            if (nowMs - _noteStartMs >= gapMs) {
-                startNextNote();
-            }
-        }
+    // Render CPU share of the last chime, synth cost and audio task stack headroom
+    float lastRenderCpuPercent() const { return _audio.renderCpuPercent(); }
+    uint32_t synthCyclesPerSample() const { return _synth.cyclesPerSample(); }
+    uint32_t benchmarkCyclesPerSample() const { return _benchmarkCyclesPerSample; }
+    uint32_t clipCount() const { return _synth.clipCount(); }
+    uint32_t stackHighWaterMark() const { return _audio.stackHighWaterMark(); }
+
+    // Set before the first chime; the callback runs in the audio task
+    void setStrikeCallback(void (*callback)(void*), void* ctx) {
+        _strikeCallback = callback;
+        _strikeCtx = ctx;
     }
 
-    bool isPlaying() const {
-        return _state != IDLE;
+    // Playback start (loop task) and end (audio task), e.g. to hold a power lock
+    void setPlaybackCallback(AudioOutput::PlaybackCallback callback, void* ctx) {
+        _audio.setPlaybackCallback(callback, ctx);
     }
 
     // Set volume (0-100 percentage)
     void setVolume(uint8_t percent) {
         if (percent > 100) percent = 100;
         _volumePercent = percent;
+        _synth.setVolume(percent);
     }
 
     // Play Westminster chime for debug (3 strikes)
     void playDebugChime(int strikes = 3) {
-        startChimeSequence(strikes);
+        startProgram(chime::WESTMINSTER_HOUR, (uint8_t)strikes);
     }
 
-    // Call frequently with current local time; will self-debounce to once per hour.
+    // Also chime the quarter, half and three-quarter phrases (off by default)
+    void setQuarterChimes(bool enabled) {
+        _quarterChimes = enabled;
+    }
+
+    // Call frequently with current local time; will self-debounce to once per slot.
     void maybeChime(const tm& timeinfo) {
         int hour = timeinfo.tm_hour;
         int minute = timeinfo.tm_min;
@@ -251,13 +153,26 @@ public:
             return;
         }
 
-        // Only fire at the top of the hour and only once per hour
-        if (minute == 0 && second < 2 && _lastChimedHour != hour && !isPlaying()) {
-            _lastChimedHour = hour;
+        // Only fire in the first two seconds of a slot and only once per slot
+        if (minute % 15 != 0 || second >= 2) {
+            return;
+        }
+        int quarter = minute / 15;
+        int slot = hour * 4 + quarter;
+        if (slot == _lastChimeSlot || isPlaying()) {
+            return;
+        }
 
+        if (quarter == 0) {
+            _lastChimeSlot = slot;
             int strikes = ((hour + 11) % 12) + 1; // Convert 0-23 -> 1-12
-            startChimeSequence(strikes);
+            startProgram(chime::WESTMINSTER_HOUR, (uint8_t)strikes);
+        } else if (_quarterChimes) {
+            static const ChimeOp* const QUARTER_PROGRAMS[] = {
+                nullptr, chime::WESTMINSTER_QUARTER, chime::WESTMINSTER_HALF, chime::WESTMINSTER_THREE_QUARTER
+            };
+            _lastChimeSlot = slot;
+            startProgram(QUARTER_PROGRAMS[quarter], 0);
         }
     }
 };
-
@@ -0,0 +1,194 @@
+#pragma once
+#include <stddef.h>
+#include <stdint.h>
+
+// Compact chime bytecode, interpreted by the audio task while it renders.
+// Event times are kept on an absolute millisecond timeline and converted to the exact
+// output sample, so playback is sample-accurate however late loop() runs.
+//
+//   DURATION ms      note length unit for following NOTE/STRIKES
+//   GAP ms           silence appended after every note
+//   RING pct         decay stretch for following strikes (100 = normal)
+//   NOTE hz, beats   strike once, then wait beats * DURATION + GAP
+//   STRIKES hz, n    NOTE hz,1 repeated n times (n = 0: the count passed to start())
+//   REST ms          wait without striking
+//   END
+struct ChimeOp {
+    enum Code : uint8_t { END, DURATION, GAP, RING, NOTE, STRIKES, REST };
+    Code code;
+    uint8_t arg;
+    uint16_t value;
+};
+
+namespace chime {
+
+constexpr ChimeOp duration(uint16_t ms) { return {ChimeOp::DURATION, 0, ms}; }
+constexpr ChimeOp gap(uint16_t ms) { return {ChimeOp::GAP, 0, ms}; }
+constexpr ChimeOp ring(uint16_t percent) { return {ChimeOp::RING, 0, percent}; }
+constexpr ChimeOp note(uint16_t hz, uint8_t beats = 1) { return {ChimeOp::NOTE, beats, hz}; }
+constexpr ChimeOp strikes(uint16_t hz, uint8_t count = 0) { return {ChimeOp::STRIKES, count, hz}; }
+constexpr ChimeOp rest(uint16_t ms) { return {ChimeOp::REST, 0, ms}; }
+constexpr ChimeOp end() { return {ChimeOp::END, 0, 0}; }
+
+// Westminster Quarters pitches (E major) and the Big Ben hour bell
+constexpr uint16_t B3 = 247, E4 = 330, FS4 = 370, GS4 = 415, E3 = 165;
+
+// The five changes, each q q q h in 5/4
+#define CHIME_CHANGE_1 chime::note(chime::GS4), chime::note(chime::FS4), chime::note(chime::E4), chime::note(chime::B3, 2)
+#define CHIME_CHANGE_2 chime::note(chime::E4), chime::note(chime::GS4), chime::note(chime::FS4), chime::note(chime::B3, 2)
+#define CHIME_CHANGE_3 chime::note(chime::E4), chime::note(chime::FS4), chime::note(chime::GS4), chime::note(chime::E4, 2)
+#define CHIME_CHANGE_4 chime::note(chime::GS4), chime::note(chime::E4), chime::note(chime::FS4), chime::note(chime::B3, 2)
+#define CHIME_CHANGE_5 chime::note(chime::B3), chime::note(chime::FS4), chime::note(chime::GS4), chime::note(chime::E4, 2)
+
+// ~100 BPM: quarter note 600 ms, 80 ms between notes
+#define CHIME_TEMPO chime::duration(600), chime::gap(80), chime::ring(100)
+
+constexpr ChimeOp WESTMINSTER_QUARTER[] = {
+    CHIME_TEMPO, CHIME_CHANGE_1, end()
+};
+constexpr ChimeOp WESTMINSTER_HALF[] = {
+    CHIME_TEMPO, CHIME_CHANGE_2, CHIME_CHANGE_3, end()
+};
+constexpr ChimeOp WESTMINSTER_THREE_QUARTER[] = {
+    CHIME_TEMPO, CHIME_CHANGE_4, CHIME_CHANGE_5, CHIME_CHANGE_1, end()
+};
+// Full hour: changes 2-5, a 1.5 s pause, then one strike per hour (1 s note + 1 s gap)
+constexpr ChimeOp WESTMINSTER_HOUR[] = {
+    CHIME_TEMPO, CHIME_CHANGE_2, CHIME_CHANGE_3, CHIME_CHANGE_4, CHIME_CHANGE_5,
+    rest(1500),
+    duration(1000), gap(1000), ring(180),
+    strikes(E3),
+    end()
+};
+
+// Total length in ms (last note's ring-out excluded); strikeCount fills STRIKES n = 0
+constexpr uint32_t programDurationMs(const ChimeOp* op, uint8_t strikeCount) {
+    uint32_t total = 0;
+    uint32_t unit = 0;
+    uint32_t gapMs = 0;
+    for (; op->code != ChimeOp::END; op++) {
+        switch (op->code) {
+            case ChimeOp::DURATION: unit = op->value; break;
+            case ChimeOp::GAP: gapMs = op->value; break;
+            case ChimeOp::NOTE: total += unit * op->arg + gapMs; break;
+            case ChimeOp::STRIKES: total += (unit + gapMs) * (op->arg ? op->arg : strikeCount); break;
+            case ChimeOp::REST: total += op->value; break;
+            default: break;
+        }
+    }
+    return total;
+}
+
+constexpr size_t programLength(const ChimeOp* op) {
+    size_t n = 1;
+    while (op->code != ChimeOp::END) {
+        op++;
+        n++;
+    }
+    return n;
+}
+
+static_assert(programDurationMs(WESTMINSTER_QUARTER, 0) == 3 * 680 + 1280, "quarter timing");
+static_assert(programDurationMs(WESTMINSTER_HOUR, 2) == 4 * (3 * 680 + 1280) + 1500 + 2 * 2000, "hour timing");
+
+}  // namespace chime
+
+// Runs a program against a strike sink; all methods are called from the audio task
+class ChimeSequencer {
+public:
+    // Strike at `offset` samples into the block being rendered
+    typedef void (*StrikeFn)(void* ctx, uint16_t hz, float ring, uint16_t offset);
+
+private:
+    uint32_t _sampleRate = 22050;
+    StrikeFn _strike = nullptr;
+    void* _strikeCtx = nullptr;
+
+    const ChimeOp* _pc = nullptr;
+    uint8_t _strikeCount = 0;
+    uint16_t _unitMs = 600;
+    uint16_t _gapMs = 80;
+    float _ring = 1.0f;
+    uint16_t _repeatHz = 0;
+    uint8_t _repeatLeft = 0;
+
+    uint32_t _nowSamples = 0;  // samples rendered since start()
+    uint32_t _eventMs = 0;     // timeline position of the next step
+    volatile bool _running = false;
+
+    uint32_t eventSample() const {
+        return (uint32_t)((uint64_t)_eventMs * _sampleRate / 1000);
+    }
+
+    // Execute ops at the current event time until one of them advances the timeline
+    void step(uint16_t offset) {
+        while (_pc) {
+            if (_repeatLeft > 0) {
+                _repeatLeft--;
+                _strike(_strikeCtx, _repeatHz, _ring, offset);
+                _eventMs += (uint32_t)_unitMs + _gapMs;
+                return;
+            }
+            const ChimeOp op = *_pc++;
+            switch (op.code) {
+                case ChimeOp::DURATION: _unitMs = op.value; break;
+                case ChimeOp::GAP: _gapMs = op.value; break;
+                case ChimeOp::RING: _ring = op.value / 100.0f; break;
+                case ChimeOp::NOTE:
+                    _strike(_strikeCtx, op.value, _ring, offset);
+                    _eventMs += (uint32_t)_unitMs * op.arg + _gapMs;
+                    return;
+                case ChimeOp::STRIKES:
+                    _repeatHz = op.value;
+                    _repeatLeft = op.arg ? op.arg : _strikeCount;
+                    break;
+                case ChimeOp::REST:
+                    _eventMs += op.value;
+                    return;
+                case ChimeOp::END:
+                default:
+                    _pc = nullptr;
+                    _running = false;
+                    return;
+            }
+        }
+    }
+
+public:
+    void begin(uint32_t sampleRate, StrikeFn strike, void* ctx) {
+        _sampleRate = sampleRate;
+        _strike = strike;
+        _strikeCtx = ctx;
+    }
+
+    void start(const ChimeOp* program, uint8_t strikeCount) {
+        _pc = program;
+        _strikeCount = strikeCount;
+        _unitMs = 600;
+        _gapMs = 80;
+        _ring = 1.0f;
+        _repeatLeft = 0;
+        _nowSamples = 0;
+        _eventMs = 0;
+        _running = program != nullptr;
+    }
+
+    void stop() {
+        _pc = nullptr;
+        _repeatLeft = 0;
+        _running = false;
+    }
+
+    // Advance by one block, issuing strikes at their exact sample offsets within it
+    void advance(size_t frames) {
+        uint32_t blockEnd = _nowSamples + (uint32_t)frames;
+        while (_running && eventSample() < blockEnd) {
+            uint32_t at = eventSample();
+            step((uint16_t)(at > _nowSamples ? at - _nowSamples : 0));
+        }
+        _nowSamples = blockEnd;
+    }
+
+    bool isRunning() const { return _running; }
+    uint32_t elapsedMs() const { return (uint32_t)((uint64_t)_nowSamples * 1000 / _sampleRate); }
+};
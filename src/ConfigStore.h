@@ -0,0 +1,272 @@
+#pragma once
+#include <Arduino.h>
+#include <Preferences.h>
+#include "TouchCalibration.h"
+
+// Persistent settings kept in NVS under the "wifi", "location" and "touch" namespaces.
+struct WifiConfig {
+    String ssid;
+    String pass;
+    // Fast-reconnect cache: last good BSSID/channel and DHCP lease
+    bool hasFastConnect = false;
+    uint8_t bssid[6] = {0, 0, 0, 0, 0, 0};
+    uint8_t channel = 0;
+    uint32_t ip = 0;
+    uint32_t gateway = 0;
+    uint32_t subnet = 0;
+    uint32_t dns = 0;
+};
+
+struct LocationConfig {
+    bool hasCoords = false;
+    float lat = 0.0f;
+    float lon = 0.0f;
+    String postcode;
+    String town;
+};
+
+struct TouchConfig {
+    bool calibrated = false;  // false: TouchManager uses its built-in defaults
+    TouchMatrix matrix = {};
+};
+
+// Typed configuration store: every key is read once in begin() and served from RAM
+// afterwards. Setters only mark a group dirty; update() commits all dirty groups in a
+// single NVS session once writes have been quiet for COMMIT_DEBOUNCE_MS.
+class ConfigStore {
+    static const uint32_t COMMIT_DEBOUNCE_MS = 2000;
+
+    enum DirtyFlags : uint8_t {
+        DIRTY_WIFI_CREDS = 1 << 0,
+        DIRTY_WIFI_FAST = 1 << 1,
+        DIRTY_LOCATION = 1 << 2,
+        DIRTY_TOUCH = 1 << 3,
+    };
+
+    Preferences _prefs;
+    WifiConfig _wifi;
+    LocationConfig _loc;
+    TouchConfig _touch;
+    uint8_t _dirty = 0;
+    unsigned long _lastChangeMs = 0;
+    uint32_t _commitCount = 0;
+    bool _loaded = false;
+
+    void markDirty(uint8_t flags) {
+        _dirty |= flags;
+        _lastChangeMs = millis();
+    }
+
+    void loadWifi() {
+        _prefs.begin("wifi", true);
+        _wifi.ssid = _prefs.getString("ssid", "");
+        _wifi.pass = _prefs.getString("pass", "");
+        _wifi.hasFastConnect = false;
+        if (_prefs.getBytesLength("bssid") == sizeof(_wifi.bssid)) {
+            _prefs.getBytes("bssid", _wifi.bssid, sizeof(_wifi.bssid));
+            _wifi.channel = _prefs.getUChar("chan", 0);
+            _wifi.ip = _prefs.getUInt("ip", 0);
+            _wifi.gateway = _prefs.getUInt("gw", 0);
+            _wifi.subnet = _prefs.getUInt("mask", 0);
+            _wifi.dns = _prefs.getUInt("dns", 0);
+            _wifi.hasFastConnect = _wifi.channel >= 1 && _wifi.channel <= 14;
+        }
+        _prefs.end();
+    }
+
+    void loadLocation() {
+        _prefs.begin("location", true);
+        _loc.hasCoords = _prefs.isKey("lat") && _prefs.isKey("lon");
+        _loc.lat = _prefs.getFloat("lat", 0.0f);
+        _loc.lon = _prefs.getFloat("lon", 0.0f);
+        _loc.postcode = _prefs.getString("postcode", "");
+        _loc.town = _prefs.getString("town", "");
+        _prefs.end();
+    }
+
+    void loadTouch() {
+        _prefs.begin("touch", true);
+        _touch.calibrated = _prefs.getBytesLength("affine") == sizeof(_touch.matrix) &&
+                            _prefs.getBytes("affine", &_touch.matrix, sizeof(_touch.matrix)) == sizeof(_touch.matrix);
+        _prefs.end();
+    }
+
+    void commitWifi(uint8_t dirty) {
+        _prefs.begin("wifi", false);
+        if (dirty & DIRTY_WIFI_CREDS) {
+            _prefs.putString("ssid", _wifi.ssid);
+            _prefs.putString("pass", _wifi.pass);
+        }
+        if (dirty & DIRTY_WIFI_FAST) {
+            if (_wifi.hasFastConnect) {
+                _prefs.putBytes("bssid", _wifi.bssid, sizeof(_wifi.bssid));
+                _prefs.putUChar("chan", _wifi.channel);
+                _prefs.putUInt("ip", _wifi.ip);
+                _prefs.putUInt("gw", _wifi.gateway);
+                _prefs.putUInt("mask", _wifi.subnet);
+                _prefs.putUInt("dns", _wifi.dns);
+            } else {
+                _prefs.remove("bssid");
+                _prefs.remove("chan");
+                _prefs.remove("ip");
+                _prefs.remove("gw");
+                _prefs.remove("mask");
+                _prefs.remove("dns");
+            }
+        }
+        _prefs.end();
+    }
+
+    void commitLocation() {
+        _prefs.begin("location", false);
+        if (_loc.hasCoords) {
+            _prefs.putFloat("lat", _loc.lat);
+            _prefs.putFloat("lon", _loc.lon);
+        } else {
+            _prefs.remove("lat");
+            _prefs.remove("lon");
+        }
+        _prefs.putString("postcode", _loc.postcode);
+        _prefs.putString("town", _loc.town);
+        _prefs.end();
+    }
+
+    void commitTouch() {
+        _prefs.begin("touch", false);
+        if (_touch.calibrated) {
+            _prefs.putBytes("affine", &_touch.matrix, sizeof(_touch.matrix));
+        } else {
+            _prefs.remove("affine");
+        }
+        _prefs.end();
+    }
+
+public:
+    // Load every key once; call at the top of setup() before any manager reads config
+    void begin() {
+        unsigned long start = millis();
+        loadWifi();
+        loadLocation();
+        loadTouch();
+        _loaded = true;
+        Serial.printf("[Config] Loaded in %lu ms (wifi: %s, location: %s, touch: %s)\n",
+                      millis() - start,
+                      _wifi.ssid.length() ? _wifi.ssid.c_str() : "none",
+                      _loc.hasCoords ? _loc.town.c_str() : (_loc.postcode.length() ? _loc.postcode.c_str() : "none"),
+                      _touch.calibrated ? "calibrated" : "defaults");
+    }
+
+    // Call from loop(); commits pending writes once they have settled
+    void update() {
+        if (_dirty && millis() - _lastChangeMs >= COMMIT_DEBOUNCE_MS) {
+            flush();
+        }
+    }
+
+    // Commit pending writes immediately (e.g. before a restart)
+    void flush() {
+        if (!_dirty) return;
+        uint8_t dirty = _dirty;
+        _dirty = 0;
+        if (dirty & (DIRTY_WIFI_CREDS | DIRTY_WIFI_FAST)) {
+            commitWifi(dirty);
+        }
+        if (dirty & DIRTY_LOCATION) {
+            commitLocation();
+        }
+        if (dirty & DIRTY_TOUCH) {
+            commitTouch();
+        }
+        _commitCount++;
+        Serial.printf("[Config] Committed to NVS (flags 0x%02x, commit #%lu)\n", dirty, (unsigned long)_commitCount);
+    }
+
+    bool isLoaded() const { return _loaded; }
+    bool hasPendingWrites() const { return _dirty != 0; }
+    uint32_t commitCount() const { return _commitCount; }
+
+    // --- WiFi ---
+    const WifiConfig& wifi() const { return _wifi; }
+    bool hasWifiCredentials() const { return _wifi.ssid.length() > 0; }
+
+    // New network: the cached BSSID/lease belongs to the old one
+    void setWifiCredentials(const String& ssid, const String& pass) {
+        _wifi.ssid = ssid;
+        _wifi.pass = pass;
+        markDirty(DIRTY_WIFI_CREDS);
+        clearFastConnect();
+    }
+
+    void setFastConnect(const uint8_t bssid[6], uint8_t channel, uint32_t ip, uint32_t gateway,
+                        uint32_t subnet, uint32_t dns) {
+        if (_wifi.hasFastConnect && memcmp(_wifi.bssid, bssid, sizeof(_wifi.bssid)) == 0 &&
+            _wifi.channel == channel && _wifi.ip == ip && _wifi.gateway == gateway &&
+            _wifi.subnet == subnet && _wifi.dns == dns) {
+            return;  // unchanged: no flash write
+        }
+        memcpy(_wifi.bssid, bssid, sizeof(_wifi.bssid));
+        _wifi.channel = channel;
+        _wifi.ip = ip;
+        _wifi.gateway = gateway;
+        _wifi.subnet = subnet;
+        _wifi.dns = dns;
+        _wifi.hasFastConnect = true;
+        markDirty(DIRTY_WIFI_FAST);
+    }
+
+    void clearFastConnect() {
+        if (!_wifi.hasFastConnect) return;
+        _wifi.hasFastConnect = false;
+        markDirty(DIRTY_WIFI_FAST);
+    }
+
+    // --- Location ---
+    const LocationConfig& location() const { return _loc; }
+
+    // Verified coordinates (postcode cleared; town kept only if provided)
+    void setLocationCoords(float lat, float lon, const String& town = "") {
+        _loc.hasCoords = true;
+        _loc.lat = lat;
+        _loc.lon = lon;
+        _loc.postcode = "";
+        if (town.length() > 0) _loc.town = town;
+        markDirty(DIRTY_LOCATION);
+    }
+
+    // Geocoded postcode: coordinates, friendly town and the original query
+    void setLocationGeocoded(const String& postcode, float lat, float lon, const String& town) {
+        _loc.hasCoords = true;
+        _loc.lat = lat;
+        _loc.lon = lon;
+        _loc.town = town;
+        _loc.postcode = postcode;
+        markDirty(DIRTY_LOCATION);
+    }
+
+    // Unresolved postcode; WeatherManager geocodes it later
+    void setLocationPostcode(const String& postcode) {
+        _loc.postcode = postcode;
+        markDirty(DIRTY_LOCATION);
+    }
+
+    void setTown(const String& town) {
+        if (town == _loc.town) return;
+        _loc.town = town;
+        markDirty(DIRTY_LOCATION);
+    }
+
+    // --- Touch ---
+    const TouchConfig& touch() const { return _touch; }
+
+    void setTouchCalibration(const TouchMatrix& matrix) {
+        _touch.calibrated = true;
+        _touch.matrix = matrix;
+        markDirty(DIRTY_TOUCH);
+    }
+
+    void clearTouchCalibration() {
+        if (!_touch.calibrated) return;
+        _touch.calibrated = false;
+        markDirty(DIRTY_TOUCH);
+    }
+};
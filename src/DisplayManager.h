@@ -4,6 +4,8 @@
 #include <SPI.h>
 #include "AppVersion.h"
 #include "weather_icons.h"
+#include "Metrics.h"
+#include "PowerManager.h"
 
 class DisplayManager {
     TFT_eSPI tft = TFT_eSPI();
@@ -47,6 +49,65 @@ class DisplayManager {
     // Special characters
     static constexpr char DEGREE_SYMBOL = 247; // Extended ASCII degree symbol (°)
 
+    // Draw bookkeeping for touch-to-photon tracing
+    uint32_t _drawCount = 0;
+    uint32_t _lastDrawDoneUs = 0;
+
+    PowerManager* _power = nullptr;  // full clock while pushing to the panel
+
+    // Retained model of what the screen shows. Kept current while the panel sleeps, so
+    // waking is one repaint instead of replaying every update that happened in the dark.
+    String _headerText = "";
+    String _headerTown = "";
+    String _clockText = "";
+    String _dateText = "";
+    String _instruction = "";
+    bool _weatherShown = false;
+    bool _weatherHasTemps = false;
+    uint8_t _weatherCodes[6] = {};
+    float _weatherTemps[6] = {};
+    int _weatherStartHour = 0;
+
+    // Blanked mode: backlight off, ILI9341 in sleep, no SPI traffic
+    bool _blanked = false;
+    uint32_t _sleepOutMs = 0;  // when the panel last left sleep
+    static const uint32_t SLEEP_OUT_SETTLE_MS = 5;    // SLPOUT to the next command
+    static const uint32_t SLEEP_IN_GUARD_MS = 120;    // SLPOUT to the next SLPIN
+
+    // Model updates call this before drawing; while blanked the draw is dropped
+    bool suppressed() {
+        if (!_blanked) return false;
+        metricDisplayDrawsSkipped.inc();
+        return true;
+    }
+
+    void resetModel() {
+        _headerText = "";
+        _headerTown = "";
+        _clockText = "";
+        _dateText = "";
+        _instruction = "";
+        _weatherShown = false;
+        _lastStatusShown = "";
+    }
+
+    // Times a draw call into metricSpiDrawDuration and notes when it finished. TFT_eSPI
+    // pushes synchronously, so the pixels are on the panel once the call returns.
+    // Also holds the CPU at full clock for the push.
+    class DrawScope {
+        DisplayManager& _dm;
+        PowerManager::Hold _power;
+        ScopedTimer _timer;
+
+    public:
+        explicit DrawScope(DisplayManager& dm)
+            : _dm(dm), _power(dm._power, POWER_LOCK_SPI), _timer(metricSpiDrawDuration) {}
+        ~DrawScope() {
+            _dm._lastDrawDoneUs = micros();
+            _dm._drawCount++;
+        }
+    };
+
 public:
     void begin() {
         tft.init();
@@ -65,22 +126,92 @@ public:
         // Turn on backlight
         pinMode(TFT_BL, OUTPUT);
         digitalWrite(TFT_BL, HIGH);
+        _sleepOutMs = millis();
+    }
+
+    // Backlight off and panel to sleep. From here until wake() every update only changes
+    // the model. Call from the loop task: it is the only one that talks to the panel.
+    void blank() {
+        if (_blanked) return;
+        PowerManager::Hold power(_power, POWER_LOCK_SPI);
+        digitalWrite(TFT_BL, LOW);
+        // The ILI9341 needs 120 ms after SLPOUT before it accepts SLPIN
+        uint32_t sinceWake = millis() - _sleepOutMs;
+        if (sinceWake < SLEEP_IN_GUARD_MS) delay(SLEEP_IN_GUARD_MS - sinceWake);
+        tft.writecommand(TFT_DISPOFF);
+        tft.writecommand(TFT_SLPIN);
+        _blanked = true;
+        metricDisplayAsleep.set(1);
+        Serial.println("[Display] Panel asleep; drawing suspended");
+    }
+
+    // Panel out of sleep, one full repaint from the model, then the backlight, so the
+    // stale frame left in GRAM is never visible
+    void wake() {
+        if (!_blanked) return;
+        PowerManager::Hold power(_power, POWER_LOCK_SPI);
+        uint32_t startMs = millis();
+        tft.writecommand(TFT_SLPOUT);
+        delay(SLEEP_OUT_SETTLE_MS);
+        _sleepOutMs = millis();
+        _blanked = false;
+        metricDisplayAsleep.set(0);
+        repaint();
+        tft.writecommand(TFT_DISPON);
+        digitalWrite(TFT_BL, HIGH);
+        Serial.printf("[Display] Panel awake; repainted in %lu ms\n", (unsigned long)(millis() - startMs));
+    }
+
+    bool isBlanked() const { return _blanked; }
+
+    // Draws hold POWER_LOCK_SPI from here on
+    void setPowerManager(PowerManager* power) {
+        _power = power;
     }
 
     void drawStaticInterface() {
         updateHeaderText("TouchClock");
     }
 
+    // Blank the whole panel; the caller redraws every element afterwards
+    void clear() {
+        resetModel();
+        if (suppressed()) return;
+        DrawScope drawScope(*this);
+        tft.fillScreen(TFT_BLACK);
+    }
+
+    // Redraw every element from the model in one pass
+    void repaint() {
+        DrawScope drawScope(*this);
+        tft.fillScreen(TFT_BLACK);
+        if (_headerText.length() > 0) paintHeader();
+        if (_clockText.length() > 0) paintClock();
+        if (_dateText.length() > 0) paintDate();
+        if (_weatherShown) paintWeather();
+        if (_lastStatusShown.length() > 0) paintStatus();
+        if (_instruction.length() > 0) paintInstruction();
+    }
+
     // Redraws the top bar title, divider line, town name, and version label
     void updateHeaderText(const String& text, const String& townName = "") {
+        _headerText = text;
+        _headerTown = townName;
+        if (suppressed()) return;
+        DrawScope drawScope(*this);
+        paintHeader();
+    }
+
+private:
+    void paintHeader() {
         tft.fillRect(0, 0, Lw, HEADER_HEIGHT, TFT_BLACK);
         tft.setTextColor(TFT_YELLOW, TFT_BLACK);
-        tft.drawCentreString(text, Lw / 2, HEADER_TITLE_Y, 4);
+        tft.drawCentreString(_headerText, Lw / 2, HEADER_TITLE_Y, 4);
         tft.drawFastHLine(0, HEADER_DIVIDER_Y, Lw, TFT_BLUE);
 
         // Draw town name in tiny blue font at top left, above the blue line (truncate to 15 chars)
-        if (townName.length() > 0) {
-            String shortTown = townName;
+        if (_headerTown.length() > 0) {
+            String shortTown = _headerTown;
             if (shortTown.length() > 15) {
                 shortTown = shortTown.substring(0, 15);
             }
@@ -93,19 +224,89 @@ public:
         tft.drawString(appVersion(), Lw - HEADER_VERSION_RIGHT_PAD, HEADER_VERSION_Y, 1);
     }
 
-    // Update clock display
-    void updateClock(String timeStr) {
+    void paintClock() {
         tft.setTextColor(TFT_WHITE, TFT_BLACK);
-        tft.drawCentreString(timeStr, Lw / 2, CLOCK_Y, 7);
+        tft.drawCentreString(_clockText, Lw / 2, CLOCK_Y, 7);
     }
-    
-    // Update date display
-    void updateDate(String dateStr) {
+
+    void paintDate() {
         tft.setTextColor(TFT_WHITE, TFT_BLACK);
         tft.setTextSize(1);
         // Clear a strip across the date area to avoid leftover pixels when text becomes shorter
         tft.fillRect(0, DATE_Y - DATE_CLEAR_PAD, Lw, DATE_CLEAR_HEIGHT, TFT_BLACK);
-        tft.drawCentreString(dateStr, Lw / 2, DATE_Y, 2);
+        tft.drawCentreString(_dateText, Lw / 2, DATE_Y, 2);
+    }
+
+    void paintWeather() {
+        paintWeatherIcons(_weatherCodes);
+        const float slotW = Lw / 6.0f;
+        const int labelY = WEATHER_BASE_Y + WEATHER_ICON_H + WEATHER_LABEL_GAP;
+        const int tempY = labelY + WEATHER_LABEL_HEIGHT;
+
+        // Clear the label (and temp) strip to avoid ghost characters when shorter labels
+        // (e.g., "2pm") overwrite longer ones (e.g., "12pm")
+        tft.fillRect(0, labelY - 2, Lw, _weatherHasTemps ? WEATHER_LABELS_TOTAL_HEIGHT : 16, TFT_BLACK);
+
+        // Draw time labels
+        tft.setTextColor(TFT_DARKGREY, TFT_BLACK);
+        for (int i = 0; i < 6; i++) {
+            int cx = (int)round(slotW * (i + 0.5f));
+            int hour = (_weatherStartHour + i * 2) % 24;
+            tft.drawCentreString(formatHour12(hour), cx, labelY, 2);
+        }
+        if (!_weatherHasTemps) return;
+
+        // Draw temperature labels
+        tft.setTextColor(TFT_CYAN, TFT_BLACK);
+        for (int i = 0; i < 6; i++) {
+            int cx = (int)round(slotW * (i + 0.5f));
+            // Format temperature as integer with degree symbol (°C)
+            String tempStr = String((int)round(_weatherTemps[i]));
+            tempStr += DEGREE_SYMBOL;
+            tempStr += "C";
+            // Add small offset to visually center (°C adds asymmetry)
+            tft.drawCentreString(tempStr, cx + 4, tempY, 2);
+        }
+    }
+
+    void paintStatus() {
+        tft.fillRect(0, Lh - STATUS_BAR_HEIGHT, Lw, STATUS_BAR_HEIGHT, TFT_BLACK);
+        tft.setTextSize(1);
+        tft.setTextColor(TFT_DARKGREY, TFT_BLACK);
+        tft.drawCentreString(_lastStatusShown, Lw / 2, Lh - STATUS_TEXT_Y_OFFSET, 1);
+    }
+
+    void paintInstruction() {
+        tft.fillRect(0, Lh - INSTR_BAR_HEIGHT, Lw, INSTR_BAR_HEIGHT, TFT_BLACK);
+        tft.setTextColor(TFT_WHITE, TFT_BLACK);
+        tft.setTextSize(1);
+
+        int split = _instruction.indexOf('\n');
+        if (split < 0) {
+            tft.drawCentreString(_instruction, Lw / 2, Lh - (INSTR_BAR_HEIGHT - INSTR_LINE2_Y), 2);
+        } else {
+            String a = _instruction.substring(0, split);
+            String b = _instruction.substring(split + 1);
+            tft.drawCentreString(a, Lw / 2, Lh - INSTR_LINE1_Y, 2);
+            tft.drawCentreString(b, Lw / 2, Lh - INSTR_LINE2_Y, 2);
+        }
+    }
+
+public:
+    // Update clock display
+    void updateClock(String timeStr) {
+        _clockText = timeStr;
+        if (suppressed()) return;
+        DrawScope drawScope(*this);
+        paintClock();
+    }
+    
+    // Update date display
+    void updateDate(String dateStr) {
+        _dateText = dateStr;
+        if (suppressed()) return;
+        DrawScope drawScope(*this);
+        paintDate();
     }
 
     const char* codeToGlyph(uint8_t code) {
@@ -165,8 +366,9 @@ public:
         return String(h) + (pm ? "pm" : "am");
     }
 
+private:
     // Weather icons display (PROGMEM bitmaps)
-    void showWeatherIcons(const uint8_t codes[6]) {
+    void paintWeatherIcons(const uint8_t codes[6]) {
         // Draw 6 icons across the width, below the date line
         const float slotW = Lw / 6.0f;              // use float to center precisely
         const int iconW = WEATHER_ICON_W;
@@ -184,102 +386,96 @@ public:
         }
     }
 
+    void setWeatherModel(const uint8_t codes[6], const float temps[6], int startHour) {
+        memcpy(_weatherCodes, codes, sizeof(_weatherCodes));
+        _weatherHasTemps = temps != nullptr;
+        if (temps) memcpy(_weatherTemps, temps, sizeof(_weatherTemps));
+        _weatherStartHour = startHour;
+        _weatherShown = true;
+    }
+
+public:
     // Show weather icons with 12-hour labels below
     void showWeatherIconsWithLabels(const uint8_t codes[6], int startHour) {
-        // Draw icons and 12h labels 5px below
-        showWeatherIcons(codes);
-        const float slotW = Lw / 6.0f;
-        const int labelY = WEATHER_BASE_Y + WEATHER_ICON_H + WEATHER_LABEL_GAP; // baseY + iconH + gap
-        // Clear the label strip to avoid ghost characters when shorter labels (e.g., "2pm") overwrite longer ones (e.g., "12pm")
-        tft.fillRect(0, labelY - 2, Lw, 16, TFT_BLACK);
-        tft.setTextColor(TFT_DARKGREY, TFT_BLACK);
-        for (int i = 0; i < 6; i++) {
-            int cx = (int)round(slotW * (i + 0.5f));
-            int hour = (startHour + i * 2) % 24;
-            tft.drawCentreString(formatHour12(hour), cx, labelY, 2);
-        }
+        setWeatherModel(codes, nullptr, startHour);
+        if (suppressed()) return;
+        DrawScope drawScope(*this);
+        paintWeather();
     }
 
     // Show weather icons with 12-hour labels and temperature in Celsius
     void showWeatherIconsWithLabelsAndTemps(const uint8_t codes[6], const float temps[6], int startHour) {
-        // Draw icons
-        showWeatherIcons(codes);
-        const float slotW = Lw / 6.0f;
-        const int labelY = WEATHER_BASE_Y + WEATHER_ICON_H + WEATHER_LABEL_GAP;
-        const int tempY = labelY + WEATHER_LABEL_HEIGHT;
-        
-        // Clear the label and temp strip
-        tft.fillRect(0, labelY - 2, Lw, WEATHER_LABELS_TOTAL_HEIGHT, TFT_BLACK);
-        
-        // Draw time labels
-        tft.setTextColor(TFT_DARKGREY, TFT_BLACK);
-        for (int i = 0; i < 6; i++) {
-            int cx = (int)round(slotW * (i + 0.5f));
-            int hour = (startHour + i * 2) % 24;
-            tft.drawCentreString(formatHour12(hour), cx, labelY, 2);
-        }
-        
-        // Draw temperature labels
-        tft.setTextColor(TFT_CYAN, TFT_BLACK);
-        for (int i = 0; i < 6; i++) {
-            int cx = (int)round(slotW * (i + 0.5f));
-            // Format temperature as integer with degree symbol (°C)
-            String tempStr = String((int)round(temps[i]));
-            tempStr += DEGREE_SYMBOL;
-            tempStr += "C";
-            // Add small offset to visually center (°C adds asymmetry)
-            tft.drawCentreString(tempStr, cx + 4, tempY, 2);
-        }
+        setWeatherModel(codes, temps, startHour);
+        if (suppressed()) return;
+        DrawScope drawScope(*this);
+        paintWeather();
     }
-    
+
     void showStatus(String status) {
         // Only redraw if status text actually changed
         if (status == _lastStatusShown) {
             return;  // Skip redraw if same
         }
         _lastStatusShown = status;
-        
-        tft.fillRect(0, Lh - STATUS_BAR_HEIGHT, Lw, STATUS_BAR_HEIGHT, TFT_BLACK);
-        tft.setTextSize(1);
-        tft.setTextColor(TFT_DARKGREY, TFT_BLACK);
-        tft.drawCentreString(status, Lw / 2, Lh - STATUS_TEXT_Y_OFFSET, 1);
+        if (suppressed()) return;
+        DrawScope drawScope(*this);
+        paintStatus();
     }
 
     void showInstruction(const String& text) {
-        tft.fillRect(0, Lh - INSTR_BAR_HEIGHT, Lw, INSTR_BAR_HEIGHT, TFT_BLACK);
-        tft.setTextColor(TFT_WHITE, TFT_BLACK);
-        tft.setTextSize(1);
-        
-        int split = text.indexOf('\n');
-        if (split < 0) {
-            tft.drawCentreString(text, Lw / 2, Lh - (INSTR_BAR_HEIGHT - INSTR_LINE2_Y), 2);
-        } else {
-            String a = text.substring(0, split);
-            String b = text.substring(split + 1);
-            tft.drawCentreString(a, Lw / 2, Lh - INSTR_LINE1_Y, 2);
-            tft.drawCentreString(b, Lw / 2, Lh - INSTR_LINE2_Y, 2);
-        }
+        _instruction = text;
+        if (suppressed()) return;
+        DrawScope drawScope(*this);
+        paintInstruction();
     }
 
+    // Clears the instruction and status bars
     void clearInstructions() {
+        _instruction = "";
+        _lastStatusShown = "";
+        if (suppressed()) return;
+        DrawScope drawScope(*this);
         tft.fillRect(0, Lh - (INSTR_BAR_HEIGHT + STATUS_BAR_HEIGHT), Lw, (INSTR_BAR_HEIGHT + STATUS_BAR_HEIGHT), TFT_BLACK);
     }
 
-    // Debug overlay helpers for touch areas
+    // Debug overlay helpers for touch areas (not retained: dropped while blanked)
     void drawRectOutline(uint16_t x, uint16_t y, uint16_t w, uint16_t h, uint16_t color) {
+        if (suppressed()) return;
+        DrawScope drawScope(*this);
         tft.drawRect(x, y, w, h, color);
     }
 
     void drawTextInArea(uint16_t x, uint16_t y, const char* text, uint16_t color) {
+        if (suppressed()) return;
+        DrawScope drawScope(*this);
         tft.setTextColor(color, TFT_BLACK);
         tft.drawString(text, x, y, 1);
     }
 
+    // Touch calibration screen: a single crosshair target and a prompt
+    void showCalibrationTarget(uint16_t x, uint16_t y, const String& prompt) {
+        resetModel();
+        if (suppressed()) return;
+        DrawScope drawScope(*this);
+        tft.fillScreen(TFT_BLACK);
+        tft.drawFastHLine(x - 12, y, 25, TFT_WHITE);
+        tft.drawFastVLine(x, y - 12, 25, TFT_WHITE);
+        tft.drawCircle(x, y, 6, TFT_RED);
+        tft.setTextColor(TFT_YELLOW, TFT_BLACK);
+        tft.drawCentreString(prompt, Lw / 2, Lh / 2 - 8, 2);
+    }
+
     void showBrightness(uint16_t rawValue) {
+        if (suppressed()) return;
+        DrawScope drawScope(*this);
         // Clear the left side area just below the blue line
         tft.fillRect(0, BRIGHTNESS_AREA_Y, 80, BRIGHTNESS_AREA_H, TFT_BLACK);
         // Draw raw sensor value in font 1 (small), blue color
         tft.setTextColor(TFT_BLUE, TFT_BLACK);
         tft.drawString(String(rawValue).c_str(), BRIGHTNESS_TEXT_X, BRIGHTNESS_TEXT_Y, 1);
     }
-};
\ No newline at end of file
+
+    // Draw calls completed so far, and when the last one finished (micros())
+    uint32_t drawCount() const { return _drawCount; }
+    uint32_t lastDrawDoneUs() const { return _lastDrawDoneUs; }
+};
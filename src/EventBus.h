@@ -0,0 +1,162 @@
+#pragma once
+#include <Arduino.h>
+#include <atomic>
+#include "GestureEngine.h"
+#include "Metrics.h"
+#include "MpscRing.h"
+
+// Things one module tells the others about. The payload member to read depends on the type.
+enum EventType : uint8_t {
+    EVENT_LOCATION_CHANGED = 0,  // config page saved a new location (location)
+    EVENT_SCREEN_OFF,            // bright light blanked the screen (lightMv)
+    EVENT_SCREEN_ON,             // a touch woke it again (lightMv)
+    EVENT_TIME_SYNCED,           // NTP set the clock (epoch)
+    EVENT_FORECAST_UPDATED,      // a forecast fetch succeeded (forecast)
+    EVENT_LINK_UP,               // connectivity supervisor: station link came up
+    EVENT_LINK_DOWN,             // connectivity supervisor: station link dropped
+    EVENT_TOUCH_DOWN,            // pen down, before any gesture is known (sensor hub)
+    EVENT_TOUCH_GESTURE,         // gesture recognised in loop() (gesture)
+    EVENT_TYPE_COUNT
+};
+
+constexpr uint32_t eventMask(EventType type) { return 1UL << type; }
+
+struct Event {
+    EventType type;
+    uint32_t timeUs;  // micros() when published
+    union {
+        struct {
+            float lat, lon;  // 0,0 when only an unresolved postcode was saved
+        } location;
+        uint16_t lightMv;
+        uint32_t epoch;
+        struct {
+            uint8_t code;       // weather code of the first forecast slot
+            uint8_t startHour;  // local hour of the first slot
+        } forecast;
+        Gesture gesture;
+    };
+
+    static Event of(EventType type) {
+        Event e{};
+        e.type = type;
+        e.timeUs = micros();
+        return e;
+    }
+    static Event locationChanged(float lat, float lon) {
+        Event e = of(EVENT_LOCATION_CHANGED);
+        e.location.lat = lat;
+        e.location.lon = lon;
+        return e;
+    }
+    static Event screen(bool on, uint16_t lightMv) {
+        Event e = of(on ? EVENT_SCREEN_ON : EVENT_SCREEN_OFF);
+        e.lightMv = lightMv;
+        return e;
+    }
+    static Event timeSynced(uint32_t epoch) {
+        Event e = of(EVENT_TIME_SYNCED);
+        e.epoch = epoch;
+        return e;
+    }
+    static Event forecastUpdated(uint8_t code, uint8_t startHour) {
+        Event e = of(EVENT_FORECAST_UPDATED);
+        e.forecast.code = code;
+        e.forecast.startHour = startHour;
+        return e;
+    }
+    static Event touchGesture(const Gesture& gesture) {
+        Event e = of(EVENT_TOUCH_GESTURE);
+        e.gesture = gesture;
+        return e;
+    }
+};
+
+// Typed publish/subscribe between modules and tasks. Each subscriber names the event types
+// it wants and gets its own lock-free queue (MpscRing.h), so publishing from the sensor hub
+// and the loop task at once needs no mutex, and a slow subscriber only fills its own queue.
+// After queueing, the publisher calls the subscriber's wake hook so the consuming task wakes
+// at once instead of polling: notifyTask() for a task blocked in waitNotified(), or the
+// subscriber's own hook (e.g. SensorHub::wake for a hub callback).
+//
+// Subscribe during setup(), before anything publishes. Publish from tasks only, not ISRs
+// (wake hooks may notify tasks or log). Each subscriber's queue is drained by its own task.
+class EventBus {
+public:
+    typedef void (*WakeFn)(void* ctx);
+
+    static const uint8_t MAX_SUBSCRIBERS = 4;
+    static const size_t QUEUE_SIZE = 16;
+
+private:
+    struct Subscriber {
+        const char* name;
+        uint32_t mask;
+        WakeFn wake;
+        void* ctx;
+        MpscRing<Event, QUEUE_SIZE> queue;
+    };
+
+    Subscriber _subscribers[MAX_SUBSCRIBERS];
+    std::atomic<uint8_t> _count{0};
+
+public:
+    // Returns the subscriber id for poll(), or -1 when full
+    int subscribe(const char* name, uint32_t mask, WakeFn wake = nullptr, void* ctx = nullptr) {
+        uint8_t id = _count.load(std::memory_order_relaxed);
+        if (id >= MAX_SUBSCRIBERS) return -1;
+        Subscriber& s = _subscribers[id];
+        s.name = name;
+        s.mask = mask;
+        s.wake = wake;
+        s.ctx = ctx;
+        _count.store(id + 1, std::memory_order_release);
+        return id;
+    }
+
+    void publish(const Event& event) {
+        metricEventsPublished.inc();
+        uint8_t count = _count.load(std::memory_order_acquire);
+        for (uint8_t i = 0; i < count; i++) {
+            Subscriber& s = _subscribers[i];
+            if (!(s.mask & eventMask(event.type))) continue;
+            if (!s.queue.push(event)) {
+                metricEventsDropped.inc();
+                Serial.printf("[EventBus] %s queue full, dropping %s\n", s.name, name(event.type));
+                continue;
+            }
+            if (s.wake) s.wake(s.ctx);
+        }
+    }
+
+    // Subscriber's own task: next queued event, false when there is none
+    bool poll(int id, Event& event) {
+        if (id < 0 || id >= _count.load(std::memory_order_acquire)) return false;
+        return _subscribers[id].queue.pop(event);
+    }
+
+    // Wake hook for a subscriber whose task blocks in waitNotified(); ctx is its TaskHandle_t
+    static void notifyTask(void* task) {
+        xTaskNotifyGive(static_cast<TaskHandle_t>(task));
+    }
+
+    // Block the calling task until notifyTask() or the timeout, whichever comes first
+    static void waitNotified(uint32_t timeoutMs) {
+        ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(timeoutMs));
+    }
+
+    static const char* name(EventType type) {
+        switch (type) {
+            case EVENT_LOCATION_CHANGED: return "location-changed";
+            case EVENT_SCREEN_OFF: return "screen-off";
+            case EVENT_SCREEN_ON: return "screen-on";
+            case EVENT_TIME_SYNCED: return "time-synced";
+            case EVENT_FORECAST_UPDATED: return "forecast-updated";
+            case EVENT_LINK_UP: return "link-up";
+            case EVENT_LINK_DOWN: return "link-down";
+            case EVENT_TOUCH_DOWN: return "touch-down";
+            case EVENT_TOUCH_GESTURE: return "touch-gesture";
+            default: return "unknown";
+        }
+    }
+};
@@ -0,0 +1,184 @@
+#pragma once
+#include <stdint.h>
+#include <stdlib.h>
+#include "TouchEvent.h"
+
+enum GestureType : uint8_t {
+    GESTURE_TAP = 0,
+    GESTURE_DOUBLE_TAP,
+    GESTURE_TRIPLE_TAP,
+    GESTURE_LONG_PRESS,  // fires while the pen is still down
+    GESTURE_SWIPE_LEFT,
+    GESTURE_SWIPE_RIGHT,
+    GESTURE_SWIPE_UP,
+    GESTURE_SWIPE_DOWN
+};
+
+struct Gesture {
+    GestureType type;
+    uint16_t x, y;         // where the gesture started (first tap of a multi-tap)
+    int16_t dx, dy;        // swipe displacement (0 otherwise)
+    uint32_t timestampUs;  // when it was recognised
+};
+
+// Turns a press/move/release stream into gestures. Fixed-size state machine, no heap and
+// no platform calls: time only comes in through the events and tick(), so recorded traces
+// replay identically on the host (tools/gesture_replay.cpp).
+//
+// Taps are reported as soon as the pen lifts and escalate TAP -> DOUBLE_TAP -> TRIPLE_TAP
+// while presses follow within MULTI_TAP_US near the first one; a third tap starts over.
+// A press held still for LONG_PRESS_US fires LONG_PRESS from tick() and its release is
+// swallowed. A press that travels beyond TAP_SLOP_PX is a drag: on release it is a swipe
+// if it was fast and long enough along a dominant axis, otherwise nothing.
+class GestureEngine {
+public:
+    static constexpr uint16_t TAP_SLOP_PX = 12;
+    static constexpr uint32_t MULTI_TAP_US = 400000;
+    static constexpr uint32_t LONG_PRESS_US = 2000000;
+    static constexpr uint16_t SWIPE_MIN_PX = 50;
+    static constexpr uint32_t SWIPE_MAX_US = 700000;
+    static constexpr uint8_t QUEUE_SIZE = 8;
+
+private:
+    enum State : uint8_t { IDLE, PRESSED, DRAGGING, LONG_PRESSED };
+
+    State _state = IDLE;
+    uint16_t _downX = 0, _downY = 0;
+    uint16_t _lastX = 0, _lastY = 0;
+    uint32_t _downUs = 0;
+
+    // Multi-tap sequence in progress
+    uint8_t _tapCount = 0;
+    uint16_t _tapX = 0, _tapY = 0;
+    uint32_t _lastTapUs = 0;
+
+    Gesture _queue[QUEUE_SIZE];
+    uint8_t _head = 0;
+    uint8_t _count = 0;
+    uint32_t _dropped = 0;
+
+    static uint16_t distance(uint16_t x1, uint16_t y1, uint16_t x2, uint16_t y2) {
+        int dx = abs((int)x1 - (int)x2);
+        int dy = abs((int)y1 - (int)y2);
+        return (uint16_t)(dx > dy ? dx : dy);  // Chebyshev: cheap and fine for a slop box
+    }
+
+    void emit(GestureType type, uint16_t x, uint16_t y, int16_t dx, int16_t dy, uint32_t us) {
+        if (_count == QUEUE_SIZE) {
+            _dropped++;
+            return;
+        }
+        Gesture& g = _queue[(_head + _count) % QUEUE_SIZE];
+        g.type = type;
+        g.x = x;
+        g.y = y;
+        g.dx = dx;
+        g.dy = dy;
+        g.timestampUs = us;
+        _count++;
+    }
+
+    void press(const TouchEvent& e) {
+        // A multi-tap continues only if this press is soon enough and close to the first tap
+        if (_tapCount > 0 &&
+            (e.timestampUs - _lastTapUs > MULTI_TAP_US || distance(e.x, e.y, _tapX, _tapY) > TAP_SLOP_PX)) {
+            _tapCount = 0;
+        }
+        _state = PRESSED;
+        _downX = _lastX = e.x;
+        _downY = _lastY = e.y;
+        _downUs = e.timestampUs;
+    }
+
+    void move(const TouchEvent& e) {
+        _lastX = e.x;
+        _lastY = e.y;
+        if (_state == PRESSED && distance(e.x, e.y, _downX, _downY) > TAP_SLOP_PX) {
+            _state = DRAGGING;
+            _tapCount = 0;
+        }
+    }
+
+    void release(const TouchEvent& e) {
+        _lastX = e.x;
+        _lastY = e.y;
+        if (_state == PRESSED) {
+            if (_tapCount == 0) {
+                _tapX = _downX;
+                _tapY = _downY;
+            }
+            _tapCount++;
+            _lastTapUs = e.timestampUs;
+            GestureType type = _tapCount == 1 ? GESTURE_TAP
+                             : _tapCount == 2 ? GESTURE_DOUBLE_TAP
+                                              : GESTURE_TRIPLE_TAP;
+            emit(type, _tapX, _tapY, 0, 0, e.timestampUs);
+            if (_tapCount == 3) _tapCount = 0;
+        } else if (_state == DRAGGING) {
+            int dx = (int)e.x - (int)_downX;
+            int dy = (int)e.y - (int)_downY;
+            int adx = abs(dx);
+            int ady = abs(dy);
+            bool fast = e.timestampUs - _downUs <= SWIPE_MAX_US;
+            // One axis must dominate by 2:1, otherwise the direction is ambiguous
+            if (fast && adx >= SWIPE_MIN_PX && adx >= 2 * ady) {
+                emit(dx < 0 ? GESTURE_SWIPE_LEFT : GESTURE_SWIPE_RIGHT, _downX, _downY, dx, dy, e.timestampUs);
+            } else if (fast && ady >= SWIPE_MIN_PX && ady >= 2 * adx) {
+                emit(dy < 0 ? GESTURE_SWIPE_UP : GESTURE_SWIPE_DOWN, _downX, _downY, dx, dy, e.timestampUs);
+            }
+        }
+        _state = IDLE;
+    }
+
+public:
+    // Feed events in timestamp order
+    void feed(const TouchEvent& e) {
+        tick(e.timestampUs);  // anything due before this event happens first
+        switch (e.type) {
+            case TOUCH_PRESS: press(e); break;
+            case TOUCH_MOVE: move(e); break;
+            case TOUCH_RELEASE: release(e); break;
+        }
+    }
+
+    // Advance time without an event: fires long-presses while the pen is held
+    void tick(uint32_t nowUs) {
+        if (_state == PRESSED && nowUs - _downUs >= LONG_PRESS_US) {
+            _state = LONG_PRESSED;
+            _tapCount = 0;
+            emit(GESTURE_LONG_PRESS, _downX, _downY, 0, 0, nowUs);
+        }
+    }
+
+    bool poll(Gesture& out) {
+        if (_count == 0) return false;
+        out = _queue[_head];
+        _head = (_head + 1) % QUEUE_SIZE;
+        _count--;
+        return true;
+    }
+
+    void reset() {
+        _state = IDLE;
+        _tapCount = 0;
+        _head = 0;
+        _count = 0;
+    }
+
+    bool isPressed() const { return _state != IDLE; }
+    uint32_t droppedCount() const { return _dropped; }
+
+    static const char* name(GestureType type) {
+        switch (type) {
+            case GESTURE_TAP: return "tap";
+            case GESTURE_DOUBLE_TAP: return "double-tap";
+            case GESTURE_TRIPLE_TAP: return "triple-tap";
+            case GESTURE_LONG_PRESS: return "long-press";
+            case GESTURE_SWIPE_LEFT: return "swipe-left";
+            case GESTURE_SWIPE_RIGHT: return "swipe-right";
+            case GESTURE_SWIPE_UP: return "swipe-up";
+            case GESTURE_SWIPE_DOWN: return "swipe-down";
+        }
+        return "?";
+    }
+};
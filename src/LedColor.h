@@ -0,0 +1,94 @@
+#pragma once
+#include <stdint.h>
+#include "Wavetable.h"
+
+// Fixed-point colour maths for the RGB LED. Both tables are built at compile time, so
+// turning a keyframe into three PWM duties is a few table reads and integer multiplies.
+//
+// Colours are HSV with 8-bit components: hue 0..255 around the wheel (0 red, 43 yellow,
+// 85 green, 128 cyan, 170 blue, 213 magenta), saturation 0 (white) .. 255, and value as
+// perceived lightness. The lightness table follows CIE 1931 (L* to luminance), which
+// looks even to the eye across the whole range where a plain linear duty bunches up
+// at the bright end.
+namespace ledcolor {
+
+static const uint8_t DUTY_BITS = 10;
+static const uint16_t DUTY_MAX = (1 << DUTY_BITS) - 1;
+
+struct Rgb8 {
+    uint8_t r, g, b;
+};
+
+struct Duty {
+    uint16_t r, g, b;
+};
+
+// a * b / 255, rounded, for 8-bit operands
+constexpr uint8_t mul8(uint8_t a, uint8_t b) {
+    return (uint8_t)(((uint32_t)a * b + 128 + (((uint32_t)a * b + 128) >> 8)) >> 8);
+}
+
+// Fully saturated colour at each hue: six linear sectors
+struct HueWheel {
+    Rgb8 data[256];
+
+    constexpr HueWheel() : data() {
+        for (int h = 0; h < 256; h++) {
+            int sector = h * 6 / 256;
+            int pos = h * 6 - sector * 256;  // 0..255 within the sector
+            uint8_t up = (uint8_t)pos;
+            uint8_t down = (uint8_t)(255 - pos);
+            switch (sector) {
+                case 0: data[h] = {255, up, 0}; break;
+                case 1: data[h] = {down, 255, 0}; break;
+                case 2: data[h] = {0, 255, up}; break;
+                case 3: data[h] = {0, down, 255}; break;
+                case 4: data[h] = {up, 0, 255}; break;
+                default: data[h] = {255, 0, down}; break;
+            }
+        }
+    }
+};
+
+// Perceived lightness 0..255 to PWM duty
+struct LightnessTable {
+    uint16_t data[256];
+
+    constexpr LightnessTable() : data() {
+        for (int v = 0; v < 256; v++) {
+            double l = v * 100.0 / 255.0;
+            double y = l <= 8.0 ? l / 903.3 : ((l + 16.0) / 116.0) * ((l + 16.0) / 116.0) * ((l + 16.0) / 116.0);
+            data[v] = (uint16_t)(y * DUTY_MAX + 0.5);
+        }
+    }
+};
+
+// One breath: lightness 0..255 on a raised cosine, sampled at STEPS points per cycle
+template <uint8_t STEPS>
+struct BreathCurve {
+    uint8_t data[STEPS];
+
+    constexpr BreathCurve() : data() {
+        for (int i = 0; i < STEPS; i++) {
+            // (1 - cos(2 pi i / STEPS)) / 2 = sin^2(pi i / STEPS), folded into the first quarter
+            int k = i <= STEPS / 2 ? i : STEPS - i;
+            double s = wavetable_detail::sinQuarter(wavetable_detail::kPi * k / STEPS);
+            data[i] = (uint8_t)(s * s * 255.0 + 0.5);
+        }
+    }
+};
+
+static constexpr HueWheel HUE_WHEEL{};
+static constexpr LightnessTable LIGHTNESS{};
+
+inline Duty hsvToDuty(uint8_t hue, uint8_t sat, uint8_t val) {
+    const Rgb8& c = HUE_WHEEL.data[hue];
+    // Desaturate towards white, then scale by lightness before the perceptual curve
+    uint8_t white = (uint8_t)(255 - sat);
+    uint8_t r = mul8((uint8_t)(white + mul8(c.r, sat)), val);
+    uint8_t g = mul8((uint8_t)(white + mul8(c.g, sat)), val);
+    uint8_t b = mul8((uint8_t)(white + mul8(c.b, sat)), val);
+    return {LIGHTNESS.data[r], LIGHTNESS.data[g], LIGHTNESS.data[b]};
+}
+
+}  // namespace ledcolor
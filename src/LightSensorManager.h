@@ -1,215 +1,212 @@
 #pragma once
 #include <Arduino.h>
+#include <driver/adc.h>
+#include <esp_adc_cal.h>
+#include "AmbientLight.h"
+#include "EventBus.h"
+#include "SensorHub.h"
 
 // Forward declaration
 class DisplayManager;
 
+// Ambient light from the LDR divider on GPIO34. Every SAMPLE_INTERVAL the sensor hub takes
+// a burst of back-to-back ADC1 conversions, averages the middle of the sorted burst
+// and converts it to millivolts with the chip's eFuse calibration, so levels and
+// thresholds mean the same on every unit. All light levels below are in millivolts.
+// Statistics, the adaptive baseline and bright-light detection live in AmbientLight.h.
+//
+// The screen state lives here and only the hub task touches it: bright light publishes
+// EVENT_SCREEN_OFF, and a pen-down (EVENT_TOUCH_DOWN) while it is off publishes
+// EVENT_SCREEN_ON. Those touch events arrive on a second, idle hub slot that the bus wakes,
+// so a touch wakes the screen right away instead of waiting for the next light reading.
+//
+// (Continuous/DMA ADC mode on the ESP32 is routed through I2S0, which the speaker's
+// built-in DAC output already owns; a short oneshot burst costs well under a millisecond.)
 class LightSensorManager {
 private:
-    // Light sensor on ADC pin (GPIO 34 on ESP32-2432S028 CYD)
-    static const uint8_t LIGHT_SENSOR_PIN = 34;
-    static const uint16_t ADC_MAX_VALUE = 4095;      // 12-bit ADC
-    static const uint16_t BRIGHTNESS_THRESHOLD = 80; // Percentage increase to trigger screen off
-    static const uint32_t SAMPLE_INTERVAL = 500;     // Sample every 500ms
-    static const uint8_t SAMPLE_COUNT_10SEC = 20;    // 20 samples × 500ms = 10 seconds
-    static const uint8_t SAMPLE_COUNT_5SEC = 10;     // 10 samples × 500ms = 5 seconds
-    static const uint32_t CALIBRATION_PERIOD_MS = 10000; // 10-second calibration on startup
-
-    TaskHandle_t _lightTaskHandle;
+    // Light sensor on ADC pin (GPIO 34 on ESP32-2432S028 CYD = ADC1 channel 6)
+    static const adc1_channel_t LIGHT_SENSOR_CHANNEL = ADC1_CHANNEL_6;
+    static const adc_atten_t ADC_ATTENUATION = ADC_ATTEN_DB_11;  // ~150-2450 mV calibrated range
+    static const uint32_t DEFAULT_VREF_MV = 1100;    // only used if the eFuse holds no calibration
+    static const uint8_t BURST_SAMPLES = 16;         // conversions per reading
+    static const uint8_t BURST_TRIM = 4;             // dropped from each end of the sorted burst
+    static const uint32_t SAMPLE_INTERVAL = AmbientLight::SAMPLE_INTERVAL_MS;
+
     DisplayManager* _display;
+    SensorHub* _hub;
+    EventBus* _bus;
+    int _screenSlot;                        // hub slot that handles touch events
+    int _subscriber;                        // event bus subscription (touch-down)
     void (*_brightnessCallback)(uint16_t);  // Callback for brightness updates
     
-    // Light level tracking
-    uint16_t _lightSamples10Sec[SAMPLE_COUNT_10SEC];  // 10-second rolling buffer
-    uint8_t _sampleIndex;
-    uint16_t _baselineLight;       // Baseline ambient light level (measured during calibration)
-    uint16_t _darknesThreshold;    // Calculated as half of baseline - light above this turns screen off
-    uint16_t _currentAverage5Sec;  // 5-second rolling average (for screen brightness control)
-    uint16_t _currentAverage10Sec; // 10-second rolling average (absolute brightness display)
-    uint16_t _latestRawReading;    // Most recent raw sensor reading
-    bool _screenOn;
-    unsigned long _lastSampleTime;
-    unsigned long _calibrationStartTime;  // When calibration started
-    bool _isCalibrating;                   // Currently in calibration period
-    
-    // Screen-off debouncing
-    unsigned long _brightLightStartTime;  // When sensor first dropped below threshold
-    unsigned long _lastScreenCheckTime;   // Last time we checked screen-off condition
-    static const uint32_t BRIGHT_LIGHT_DEBOUNCE_MS = 2000;  // 2 seconds debounce
-    static const uint32_t SCREEN_CHECK_INTERVAL_MS = 500;   // Check screen condition every 500ms
-
-    static void lightTaskWrapper(void* pvParameters) {
-        LightSensorManager* pThis = static_cast<LightSensorManager*>(pvParameters);
-        pThis->lightTaskLoop();
-        vTaskDelete(nullptr);
+    // Light level tracking (sensor hub only)
+    AmbientLight _light;
+
+    // Published copies for other tasks
+    volatile uint16_t _baselineLight;       // Adaptive baseline
+    volatile uint16_t _currentAverage10Sec; // 10-second rolling average (absolute brightness display)
+    volatile uint16_t _latestRawReading;    // Most recent reading (single burst, not averaged over time)
+    bool _screenOn;                         // sensor hub only
+    volatile bool _trace;                   // log every reading as a [LightTrace] line
+
+    esp_adc_cal_characteristics_t _adcChars;
+    uint32_t _burstUs;             // duration of the last conversion burst
+    bool _started;                 // first reading taken (sensor hub only)
+
+    // Sensor hub callback, every 500 ms
+    static uint32_t pollLight(void* ctx) {
+        static_cast<LightSensorManager*>(ctx)->pollLight();
+        return SensorHub::PERIOD;
     }
 
-    void lightTaskLoop() {
-        // Initialize calibration period
-        _calibrationStartTime = millis();
-        _isCalibrating = true;
-        _baselineLight = readLightLevel();
-        _currentAverage5Sec = _baselineLight;
-        _currentAverage10Sec = _baselineLight;
-        _latestRawReading = _baselineLight;
-        for (int i = 0; i < SAMPLE_COUNT_10SEC; i++) {
-            _lightSamples10Sec[i] = _baselineLight;
+    void pollLight() {
+        if (!_started) {
+            _light.begin(readLightLevel());
+            publish();
+            _started = true;
+            Serial.printf("LightSensor: Starting 10-second calibration period...\n");
+            return;
         }
-        _sampleIndex = 0;
-
-        Serial.printf("LightSensor: Starting 10-second calibration period...\n");
-
-        while (1) {
-            unsigned long now = millis();
-
-            if (now - _lastSampleTime >= SAMPLE_INTERVAL) {
-                _lastSampleTime = now;
-
-                // Read new sample and add to rolling buffer
-                uint16_t newSample = readLightLevel();
-                _latestRawReading = newSample;
-                _lightSamples10Sec[_sampleIndex] = newSample;
-                _sampleIndex = (_sampleIndex + 1) % SAMPLE_COUNT_10SEC;
-
-                // Calculate 5-second rolling average (first 10 samples)
-                uint32_t sum5Sec = 0;
-                for (int i = 0; i < SAMPLE_COUNT_5SEC; i++) {
-                    sum5Sec += _lightSamples10Sec[i];
-                }
-                _currentAverage5Sec = sum5Sec / SAMPLE_COUNT_5SEC;
-
-                // Calculate 10-second rolling average (all 20 samples)
-                uint32_t sum10Sec = 0;
-                for (int i = 0; i < SAMPLE_COUNT_10SEC; i++) {
-                    sum10Sec += _lightSamples10Sec[i];
-                }
-                _currentAverage10Sec = sum10Sec / SAMPLE_COUNT_10SEC;
-
-                // During calibration, use 10-second average as baseline
-                if (_isCalibrating) {
-                    _baselineLight = _currentAverage10Sec;
-                    // Calculate darkness threshold as half of baseline
-                    _darknesThreshold = _baselineLight / 2;
-                    
-                    // Check if calibration period is complete
-                    if (now - _calibrationStartTime >= CALIBRATION_PERIOD_MS) {
-                        _isCalibrating = false;
-                        Serial.printf("LightSensor: Calibration complete!\n");
-                        Serial.printf("  Baseline light level: %d\n", _baselineLight);
-                        Serial.printf("  Darkness threshold (flashlight): %d\n", _darknesThreshold);
-                    }
-                }
-
-                // Call brightness callback with 5-second average for RGB LED
-                if (_brightnessCallback) {
-                    _brightnessCallback(_currentAverage5Sec);
-                }
-
-                // Screen-off logic: only check AFTER calibration is complete
-                if (!_isCalibrating && _screenOn) {  // Only check if screen is currently on
-                    if (now - _lastScreenCheckTime >= SCREEN_CHECK_INTERVAL_MS) {
-                        _lastScreenCheckTime = now;
-                        
-                        if (_latestRawReading < _darknesThreshold) {  // Sensor reads BELOW threshold = very bright
-                            if (_brightLightStartTime == 0) {
-                                _brightLightStartTime = now;  // Record when bright light first detected
-                            } else if (now - _brightLightStartTime >= BRIGHT_LIGHT_DEBOUNCE_MS) {
-                                turnScreenOff();  // 2 seconds of sustained brightness
-                            }
-                        } else {
-                            _brightLightStartTime = 0;  // Reset debounce timer if brightness goes away
-                        }
-                    }
-                }
 
+        uint16_t mv = readLightLevel();
+        AmbientLight::Event event = _light.add(mv);
+        publish();
+        if (_trace) {
+            // Same format tools/light_replay.cpp reads
+            Serial.printf("[LightTrace] %u base %u\n", mv, _light.baseline());
+        }
 
-            }
+        switch (event) {
+            case AmbientLight::CALIBRATED:
+                Serial.printf("LightSensor: Calibration complete!\n");
+                Serial.printf("  Baseline light level: %d mV (10 s range %d-%d)\n", _light.baseline(),
+                              _light.min10s(), _light.max10s());
+                Serial.printf("  Darkness threshold (flashlight): %d mV\n", _light.threshold());
+                Serial.printf("  ADC burst: %u conversions in %lu us\n", BURST_SAMPLES, (unsigned long)_burstUs);
+                break;
+            case AmbientLight::BRIGHT_LIGHT:
+                Serial.printf("LightSensor: Bright light (%u mV, baseline %u mV)\n", _light.median(), _light.baseline());
+                turnScreenOff();
+                break;
+            case AmbientLight::BRIGHT_LIGHT_GONE:
+                Serial.printf("LightSensor: Bright light gone (%u mV)\n", _light.median());
+                break;
+            default:
+                break;
+        }
+
+        // Call brightness callback with 5-second average for RGB LED
+        if (_brightnessCallback) {
+            _brightnessCallback(_light.average5s());
+        }
+    }
 
-            // Poll interval: 100ms (actual sampling at SAMPLE_INTERVAL)
-            delay(100);
+    // Sensor hub callback, woken by the event bus
+    static uint32_t pollScreen(void* ctx) {
+        LightSensorManager* self = static_cast<LightSensorManager*>(ctx);
+        Event event;
+        while (self->_bus->poll(self->_subscriber, event)) {
+            if (event.type == EVENT_TOUCH_DOWN) self->wakeScreenFromTouch();
         }
+        return SensorHub::IDLE;
     }
 
+    static void wakeScreenSlot(void* ctx) {
+        LightSensorManager* self = static_cast<LightSensorManager*>(ctx);
+        self->_hub->wake(self->_screenSlot);
+    }
+
+    void publish() {
+        _baselineLight = _light.baseline();
+        _currentAverage10Sec = _light.average10s();
+        _latestRawReading = _light.latest();
+    }
+
+    // One burst: sort, average the middle half (rejects the ADC's occasional wild codes),
+    // then convert through the eFuse calibration curve
     uint16_t readLightLevel() {
-        // Read ADC and average a few readings for stability
+        uint32_t start = micros();
+        uint16_t burst[BURST_SAMPLES];
+        for (uint8_t i = 0; i < BURST_SAMPLES; i++) {
+            uint16_t v = (uint16_t)adc1_get_raw(LIGHT_SENSOR_CHANNEL);
+            uint8_t j = i;
+            while (j > 0 && burst[j - 1] > v) {
+                burst[j] = burst[j - 1];
+                j--;
+            }
+            burst[j] = v;
+        }
+        _burstUs = micros() - start;
+
         uint32_t sum = 0;
-        const int READINGS = 5;
-        for (int i = 0; i < READINGS; i++) {
-            sum += analogRead(LIGHT_SENSOR_PIN);
-            delayMicroseconds(100);
+        for (uint8_t i = BURST_TRIM; i < BURST_SAMPLES - BURST_TRIM; i++) {
+            sum += burst[i];
         }
-        return sum / READINGS;
+        uint32_t raw = (sum + (BURST_SAMPLES - 2 * BURST_TRIM) / 2) / (BURST_SAMPLES - 2 * BURST_TRIM);
+        return (uint16_t)esp_adc_cal_raw_to_voltage(raw, &_adcChars);
     }
 
     void turnScreenOff() {
         if (_screenOn) {  // Only turn off if currently on
             Serial.println("SCREEN OFF - Bright light detected");
-            _screenOn = false;
-            digitalWrite(TFT_BL, LOW);  // Turn off backlight
+            _screenOn = false;  // loop() blanks the display; the panel is not ours to drive
+            _bus->publish(Event::screen(false, _light.median()));
+        }
+    }
+
+    void wakeScreenFromTouch() {
+        if (!_screenOn) {
+            Serial.println("SCREEN ON - Woken by touch");
+            _screenOn = true;
+            // A light that is still on may blank the screen again after the debounce
+            _light.rearm();
+            _bus->publish(Event::screen(true, _light.latest()));
         }
     }
 
 public:
     LightSensorManager()
-        : _lightTaskHandle(nullptr),
-          _display(nullptr),
+        : _display(nullptr),
+          _hub(nullptr),
+          _bus(nullptr),
+          _screenSlot(-1),
+          _subscriber(-1),
           _brightnessCallback(nullptr),
-          _sampleIndex(0),
           _baselineLight(0),
-          _darknesThreshold(0),
-          _currentAverage5Sec(0),
           _currentAverage10Sec(0),
           _latestRawReading(0),
           _screenOn(true),
-          _lastSampleTime(0),
-          _calibrationStartTime(0),
-          _isCalibrating(false),
-          _brightLightStartTime(0),
-          _lastScreenCheckTime(0) {}
-
-    ~LightSensorManager() {
-        if (_lightTaskHandle) {
-            vTaskDelete(_lightTaskHandle);
-        }
-    }
+          _trace(false),
+          _adcChars(),
+          _burstUs(0),
+          _started(false) {}
 
-    void begin(DisplayManager* display, void (*brightnessCallback)(uint16_t) = nullptr) {
+    void begin(DisplayManager* display, SensorHub* hub, EventBus* bus, void (*brightnessCallback)(uint16_t) = nullptr) {
         _display = display;
+        _hub = hub;
+        _bus = bus;
         _brightnessCallback = brightnessCallback;
 
-        // Configure ADC for light sensor
-        pinMode(LIGHT_SENSOR_PIN, INPUT);
-        analogSetAttenuation(ADC_8db);  // Further attenuation (~0-3.6V range) to reduce sensitivity
-        analogSetWidth(12);              // 12-bit resolution
-
-        // Create and pin light polling task to Core 1
-        xTaskCreatePinnedToCore(
-            lightTaskWrapper,
-            "LightTask",
-            2048,                  // Stack size (bytes)
-            this,                  // Task parameter
-            1,                     // Priority (low, below touch)
-            &_lightTaskHandle,
-            1                      // Core 1
-        );
-
-        Serial.println("LightSensorManager initialized on Core 1");
-    }
-
-    // Called by TouchManager when screen is off and user touches
-    void wakeScreenFromTouch() {
-        if (!_screenOn) {
-            Serial.println("SCREEN ON - Woken by touch");
-            _screenOn = true;
-            digitalWrite(TFT_BL, HIGH);  // Turn on backlight
-            
-            // Reset bright-light debounce timer
-            _brightLightStartTime = 0;
-        }
+        // Configure ADC1 for the light sensor (ADC1 keeps working while WiFi is up)
+        adc1_config_width(ADC_WIDTH_BIT_12);
+        adc1_config_channel_atten(LIGHT_SENSOR_CHANNEL, ADC_ATTENUATION);
+        esp_adc_cal_value_t calSource = esp_adc_cal_characterize(ADC_UNIT_1, ADC_ATTENUATION, ADC_WIDTH_BIT_12,
+                                                                 DEFAULT_VREF_MV, &_adcChars);
+        Serial.printf("LightSensor: ADC calibration from %s\n",
+                      calSource == ESP_ADC_CAL_VAL_EFUSE_TP ? "eFuse two-point"
+                      : calSource == ESP_ADC_CAL_VAL_EFUSE_VREF ? "eFuse Vref"
+                                                                : "default Vref (uncalibrated chip)");
+
+        // Readings are taken by the sensor hub
+        hub->add("light", SAMPLE_INTERVAL * 1000, pollLight, this);
+        _screenSlot = hub->add("screen", 0, pollScreen, this);
+        _subscriber = bus->subscribe("screen", eventMask(EVENT_TOUCH_DOWN), wakeScreenSlot, this);
+
+        Serial.println("LightSensorManager initialized");
     }
 
-    bool isScreenOn() const {
-        return _screenOn;
+    void setTrace(bool enabled) {
+        _trace = enabled;
     }
 
     uint16_t getLightLevel() const {
@@ -217,7 +214,7 @@ public:
     }
 
     uint16_t getLightLevelRaw() const {
-        return _latestRawReading;  // Return raw latest reading
+        return _latestRawReading;  // Latest single reading, mV
     }
 
     uint16_t getBaseline() const {
@@ -0,0 +1,212 @@
+#include "Metrics.h"
+
+Metric* Metrics::_head = nullptr;
+Metric* Metrics::_tail = nullptr;
+void (*Metrics::_collectHook)() = nullptr;
+
+// Bucket bounds in microseconds
+// Fast paths: loop iteration, HTTP handling, single SPI draw call
+static const uint32_t FAST_BUCKETS_US[] = {
+    100, 250, 500, 1000, 2500, 5000, 10000, 25000, 50000, 100000, 250000, 1000000
+};
+// Network round-trips: weather fetch (TLS) and NTP sync (up to the 5 s poll)
+static const uint32_t NETWORK_BUCKETS_US[] = {
+    50000, 100000, 250000, 500000, 1000000, 2000000, 3000000, 5000000, 8000000, 15000000
+};
+#define BUCKETS(arr) arr, (uint8_t)(sizeof(arr) / sizeof(arr[0]))
+
+// Declaration order is export order; series sharing a name must be adjacent
+MetricHistogram metricLoopDuration("touchclock_loop_duration_seconds",
+    "Main loop iteration time excluding the trailing delay", BUCKETS(FAST_BUCKETS_US));
+MetricHistogram metricHttpHandleDuration("touchclock_http_handle_duration_seconds",
+    "Time spent in WebServer::handleClient per loop", BUCKETS(FAST_BUCKETS_US));
+MetricHistogram metricSpiDrawDuration("touchclock_display_draw_duration_seconds",
+    "Time spent pushing a DisplayManager draw call over SPI", BUCKETS(FAST_BUCKETS_US));
+MetricHistogram metricAudioRenderDuration("touchclock_audio_block_render_duration_seconds",
+    "Time to render and pack one 256-frame audio block", BUCKETS(FAST_BUCKETS_US));
+MetricHistogram metricTouchEventLatency("touchclock_touch_event_latency_seconds",
+    "Pen-down IRQ (press) or sample (move/release) to the event being handled in loop()",
+    BUCKETS(FAST_BUCKETS_US));
+MetricHistogram metricTouchDispatchLatency("touchclock_touch_dispatch_latency_seconds",
+    "Touch sample to its gesture handler starting in loop()", BUCKETS(FAST_BUCKETS_US));
+MetricHistogram metricTouchPhotonLatency("touchclock_touch_to_photon_latency_seconds",
+    "Touch sample to the SPI push of the screen change it caused completing", BUCKETS(FAST_BUCKETS_US));
+MetricCounter metricDisplayDrawsSkipped("touchclock_display_draws_skipped_total",
+    "Draw calls absorbed into the retained model while the panel slept");
+MetricGauge metricDisplayAsleep("touchclock_display_asleep", "1 while the panel is blanked and in sleep mode");
+MetricGauge metricAudioSynthCyclesPerSample("touchclock_audio_synth_cycles_per_sample",
+    "Average bell synth CPU cycles per output sample");
+MetricHistogram metricWeatherRefreshDuration("touchclock_weather_refresh_duration_seconds",
+    "WeatherManager::refresh fetch, parse and render time", BUCKETS(NETWORK_BUCKETS_US));
+MetricCounter metricWeatherRefreshOk("touchclock_weather_refresh_total",
+    "Weather refresh attempts by result", "result=\"ok\"");
+MetricCounter metricWeatherRefreshFailed("touchclock_weather_refresh_total",
+    "Weather refresh attempts by result", "result=\"error\"");
+MetricHistogram metricNtpSyncDuration("touchclock_ntp_sync_duration_seconds",
+    "TimeManager::trySyncOnce duration", BUCKETS(NETWORK_BUCKETS_US));
+MetricCounter metricNtpSyncOk("touchclock_ntp_sync_total",
+    "NTP sync attempts by result", "result=\"ok\"");
+MetricCounter metricNtpSyncFailed("touchclock_ntp_sync_total",
+    "NTP sync attempts by result", "result=\"error\"");
+MetricGauge metricUptimeSeconds("touchclock_uptime_seconds", "Seconds since boot");
+MetricGauge metricHeapFree("touchclock_heap_free_bytes", "Free internal heap");
+MetricGauge metricHeapMinFree("touchclock_heap_min_free_bytes", "Lowest free heap since boot");
+MetricGauge metricHeapMaxAlloc("touchclock_heap_max_alloc_bytes", "Largest allocatable heap block");
+MetricGauge metricStackFreeLoop("touchclock_task_stack_free_bytes",
+    "Task stack high-water mark (minimum free)", "task=\"loop\"");
+MetricGauge metricStackFreeSensors("touchclock_task_stack_free_bytes",
+    "Task stack high-water mark (minimum free)", "task=\"sensors\"");
+MetricGauge metricStackFreeAudio("touchclock_task_stack_free_bytes",
+    "Task stack high-water mark (minimum free)", "task=\"audio\"");
+MetricGauge metricWifiRssi("touchclock_wifi_rssi_dbm", "Signal strength of the current AP");
+MetricGauge metricWifiConnected("touchclock_wifi_connected", "1 while the station link is up");
+MetricGauge metricWifiReconnects("touchclock_wifi_reconnects", "Successful reconnects after a drop since boot");
+MetricGauge metricWifiOutageTotalMs("touchclock_wifi_outage_total_ms", "Accumulated WiFi outage time");
+MetricGauge metricWifiBootToConnectedMs("touchclock_wifi_boot_to_connected_ms",
+    "Milliseconds from boot to the first WiFi connection");
+MetricCounter metricEventsPublished("touchclock_events_published_total", "Events published on the event bus");
+MetricCounter metricEventsDropped("touchclock_events_dropped_total",
+    "Event deliveries dropped because a subscriber's queue was full");
+MetricGauge metricCpuFrequencyMhz("touchclock_cpu_frequency_mhz", "CPU clock when metrics were collected");
+
+Metric::Metric(const char* name, const char* help, const char* labels, Type type)
+    : _name(name), _help(help), _labels(labels), _type(type) {
+    Metrics::add(this);
+}
+
+void Metric::appendSeries(String& out, const char* suffix, const char* extraLabel) const {
+    out += _name;
+    if (suffix) out += suffix;
+    if (_labels || extraLabel) {
+        out += '{';
+        if (_labels) out += _labels;
+        if (_labels && extraLabel) out += ',';
+        if (extraLabel) out += extraLabel;
+        out += '}';
+    }
+    out += ' ';
+}
+
+void MetricCounter::render(String& out) const {
+    appendSeries(out, nullptr);
+    out += String(value());
+    out += '\n';
+}
+
+void MetricGauge::render(String& out) const {
+    appendSeries(out, nullptr);
+    out += String(value());
+    out += '\n';
+}
+
+MetricHistogram::MetricHistogram(const char* name, const char* help, const uint32_t* boundsUs, uint8_t bucketCount)
+    : Metric(name, help, nullptr, HISTOGRAM),
+      _bounds(boundsUs),
+      _bucketCount(bucketCount > MAX_BUCKETS ? MAX_BUCKETS : bucketCount) {}
+
+void MetricHistogram::observe(uint32_t us) {
+    uint8_t i = 0;
+    while (i < _bucketCount && us > _bounds[i]) i++;
+    portENTER_CRITICAL(&_mux);
+    _buckets[i]++;
+    _count++;
+    _sumUs += us;
+    if (us > _maxUs) _maxUs = us;
+    portEXIT_CRITICAL(&_mux);
+}
+
+void MetricHistogram::render(String& out) const {
+    uint32_t buckets[MAX_BUCKETS + 1];
+    uint32_t count;
+    uint64_t sumUs;
+    portENTER_CRITICAL(&_mux);
+    memcpy(buckets, _buckets, sizeof(buckets));
+    count = _count;
+    sumUs = _sumUs;
+    portEXIT_CRITICAL(&_mux);
+
+    // Prometheus buckets are cumulative
+    uint32_t cumulative = 0;
+    char le[24];
+    for (uint8_t i = 0; i < _bucketCount; i++) {
+        cumulative += buckets[i];
+        snprintf(le, sizeof(le), "le=\"%g\"", _bounds[i] / 1e6);
+        appendSeries(out, "_bucket", le);
+        out += String(cumulative);
+        out += '\n';
+    }
+    appendSeries(out, "_bucket", "le=\"+Inf\"");
+    out += String(count);
+    out += '\n';
+    appendSeries(out, "_sum");
+    out += String(sumUs / 1e6, 6);
+    out += '\n';
+    appendSeries(out, "_count");
+    out += String(count);
+    out += '\n';
+}
+
+uint32_t MetricHistogram::meanUs() const {
+    portENTER_CRITICAL(&_mux);
+    uint32_t mean = _count ? (uint32_t)(_sumUs / _count) : 0;
+    portEXIT_CRITICAL(&_mux);
+    return mean;
+}
+
+uint32_t MetricHistogram::quantileUs(float q) const {
+    uint32_t buckets[MAX_BUCKETS + 1];
+    uint32_t count;
+    uint32_t maxUs;
+    portENTER_CRITICAL(&_mux);
+    memcpy(buckets, _buckets, sizeof(buckets));
+    count = _count;
+    maxUs = _maxUs;
+    portEXIT_CRITICAL(&_mux);
+
+    if (count == 0) return 0;
+    uint32_t rank = (uint32_t)(q * count + 0.5f);
+    if (rank < 1) rank = 1;
+    uint32_t cumulative = 0;
+    for (uint8_t i = 0; i < _bucketCount; i++) {
+        cumulative += buckets[i];
+        if (cumulative >= rank) return _bounds[i] < maxUs ? _bounds[i] : maxUs;
+    }
+    return maxUs;
+}
+
+void Metrics::add(Metric* metric) {
+    if (_tail) {
+        _tail->_next = metric;
+    } else {
+        _head = metric;
+    }
+    _tail = metric;
+}
+
+String Metrics::renderPrometheus() {
+    if (_collectHook) {
+        _collectHook();
+    }
+
+    String out;
+    out.reserve(8192);
+    const char* lastName = "";
+    for (const Metric* m = _head; m; m = m->next()) {
+        if (strcmp(m->name(), lastName) != 0) {
+            lastName = m->name();
+            out += "# HELP ";
+            out += m->name();
+            out += ' ';
+            out += m->help();
+            out += "\n# TYPE ";
+            out += m->name();
+            switch (m->type()) {
+                case Metric::COUNTER: out += " counter\n"; break;
+                case Metric::GAUGE: out += " gauge\n"; break;
+                case Metric::HISTOGRAM: out += " histogram\n"; break;
+            }
+        }
+        m->render(out);
+    }
+    return out;
+}
@@ -0,0 +1,143 @@
+#pragma once
+#include <Arduino.h>
+
+// Lightweight instrumentation registry: counters, gauges and fixed-bucket histograms.
+// Metric objects are static globals (see Metrics.cpp) that link themselves into a list
+// on construction, so updating one is a few instructions and never allocates.
+// Metrics::renderPrometheus() serialises the whole registry in Prometheus text format.
+class Metric {
+public:
+    enum Type { COUNTER, GAUGE, HISTOGRAM };
+
+    Metric(const char* name, const char* help, const char* labels, Type type);
+    virtual ~Metric() {}
+
+    const char* name() const { return _name; }
+    const char* help() const { return _help; }
+    const char* labels() const { return _labels; }
+    Type type() const { return _type; }
+    Metric* next() const { return _next; }
+
+    // Appends this metric's sample lines (no HELP/TYPE header)
+    virtual void render(String& out) const = 0;
+
+protected:
+    void appendSeries(String& out, const char* suffix, const char* extraLabel = nullptr) const;
+
+private:
+    const char* _name;
+    const char* _help;
+    const char* _labels;  // e.g. "task=\"loop\"", or nullptr
+    Type _type;
+    Metric* _next = nullptr;
+    friend class Metrics;
+};
+
+class MetricCounter : public Metric {
+    uint32_t _value = 0;
+
+public:
+    MetricCounter(const char* name, const char* help, const char* labels = nullptr)
+        : Metric(name, help, labels, COUNTER) {}
+
+    // Safe from any task or core
+    void inc(uint32_t n = 1) { __atomic_fetch_add(&_value, n, __ATOMIC_RELAXED); }
+    uint32_t value() const { return __atomic_load_n(&_value, __ATOMIC_RELAXED); }
+    void render(String& out) const override;
+};
+
+class MetricGauge : public Metric {
+    int32_t _value = 0;
+
+public:
+    MetricGauge(const char* name, const char* help, const char* labels = nullptr)
+        : Metric(name, help, labels, GAUGE) {}
+
+    void set(int32_t v) { __atomic_store_n(&_value, v, __ATOMIC_RELAXED); }
+    int32_t value() const { return __atomic_load_n(&_value, __ATOMIC_RELAXED); }
+    void render(String& out) const override;
+};
+
+// Histogram of durations in microseconds; exported in seconds as Prometheus expects.
+// Bucket bounds are inclusive upper limits and must be ascending.
+class MetricHistogram : public Metric {
+public:
+    static const uint8_t MAX_BUCKETS = 12;
+
+    MetricHistogram(const char* name, const char* help, const uint32_t* boundsUs, uint8_t bucketCount);
+
+    void observe(uint32_t us);
+    uint32_t count() const { return _count; }
+    uint32_t maxUs() const { return _maxUs; }
+    uint32_t meanUs() const;
+    // Upper bound of the bucket holding quantile q (0-1), capped at the largest observation
+    uint32_t quantileUs(float q) const;
+    void render(String& out) const override;
+
+private:
+    const uint32_t* _bounds;
+    uint8_t _bucketCount;
+    uint32_t _buckets[MAX_BUCKETS + 1] = {};  // last slot is +Inf
+    uint32_t _count = 0;
+    uint64_t _sumUs = 0;
+    uint32_t _maxUs = 0;
+    mutable portMUX_TYPE _mux = portMUX_INITIALIZER_UNLOCKED;
+};
+
+// Observes the lifetime of a scope into a histogram
+class ScopedTimer {
+    MetricHistogram& _hist;
+    uint32_t _startUs;
+
+public:
+    explicit ScopedTimer(MetricHistogram& hist) : _hist(hist), _startUs(micros()) {}
+    ~ScopedTimer() { _hist.observe(micros() - _startUs); }
+};
+
+class Metrics {
+public:
+    // Called right before rendering so point-in-time gauges (heap, stacks) can be sampled
+    static void setCollectHook(void (*hook)()) { _collectHook = hook; }
+
+    static String renderPrometheus();
+
+private:
+    static Metric* _head;
+    static Metric* _tail;
+    static void (*_collectHook)();
+    static void add(Metric* metric);
+    friend class Metric;
+};
+
+// --- Registered metrics (defined in Metrics.cpp) ---
+extern MetricHistogram metricLoopDuration;
+extern MetricHistogram metricHttpHandleDuration;
+extern MetricHistogram metricSpiDrawDuration;
+extern MetricHistogram metricAudioRenderDuration;
+extern MetricHistogram metricTouchEventLatency;
+extern MetricHistogram metricTouchDispatchLatency;
+extern MetricHistogram metricTouchPhotonLatency;
+extern MetricCounter metricDisplayDrawsSkipped;
+extern MetricGauge metricDisplayAsleep;
+extern MetricGauge metricAudioSynthCyclesPerSample;
+extern MetricHistogram metricWeatherRefreshDuration;
+extern MetricCounter metricWeatherRefreshOk;
+extern MetricCounter metricWeatherRefreshFailed;
+extern MetricHistogram metricNtpSyncDuration;
+extern MetricCounter metricNtpSyncOk;
+extern MetricCounter metricNtpSyncFailed;
+extern MetricGauge metricUptimeSeconds;
+extern MetricGauge metricHeapFree;
+extern MetricGauge metricHeapMinFree;
+extern MetricGauge metricHeapMaxAlloc;
+extern MetricGauge metricStackFreeLoop;
+extern MetricGauge metricStackFreeSensors;
+extern MetricGauge metricStackFreeAudio;
+extern MetricGauge metricWifiRssi;
+extern MetricGauge metricWifiConnected;
+extern MetricGauge metricWifiReconnects;
+extern MetricGauge metricWifiOutageTotalMs;
+extern MetricGauge metricWifiBootToConnectedMs;
+extern MetricCounter metricEventsPublished;
+extern MetricCounter metricEventsDropped;
+extern MetricGauge metricCpuFrequencyMhz;
@@ -0,0 +1,65 @@
+#pragma once
+#include <atomic>
+#include <stddef.h>
+#include <stdint.h>
+
+// Fixed-size multi-producer/single-consumer ring: any number of tasks may push, one task
+// pops. Each slot carries a sequence number. A producer claims a slot by advancing _head
+// with a compare-and-swap, copies the item in, then release-stores the slot's sequence to
+// hand it to the consumer; the consumer frees it again by moving the sequence a lap ahead.
+// Nobody takes a lock or disables interrupts, and a full ring fails the push instead of
+// blocking. A producer preempted between claiming and publishing only holds up the
+// consumer at that one slot, never other producers.
+template <typename T, size_t N>
+class MpscRing {
+    static_assert(N >= 2 && (N & (N - 1)) == 0, "MpscRing size must be a power of two");
+
+    struct Slot {
+        std::atomic<uint32_t> seq;
+        T item;
+    };
+
+    Slot _slots[N];
+    std::atomic<uint32_t> _head{0};  // next slot to claim (producers, free-running)
+    uint32_t _tail = 0;              // next slot to read (consumer only)
+
+public:
+    MpscRing() {
+        for (uint32_t i = 0; i < N; i++) _slots[i].seq.store(i, std::memory_order_relaxed);
+    }
+
+    // Any producer: false if the ring is full (the item is not queued)
+    bool push(const T& item) {
+        uint32_t pos = _head.load(std::memory_order_relaxed);
+        for (;;) {
+            Slot& slot = _slots[pos & (N - 1)];
+            int32_t lag = (int32_t)(slot.seq.load(std::memory_order_acquire) - pos);
+            if (lag < 0) return false;  // the consumer has not freed this slot yet
+            if (lag > 0) {
+                pos = _head.load(std::memory_order_relaxed);  // another producer took it
+                continue;
+            }
+            if (_head.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                slot.item = item;
+                slot.seq.store(pos + 1, std::memory_order_release);
+                return true;
+            }
+        }
+    }
+
+    // Consumer: false if there is nothing to read
+    bool pop(T& item) {
+        Slot& slot = _slots[_tail & (N - 1)];
+        if (slot.seq.load(std::memory_order_acquire) != _tail + 1) return false;
+        item = slot.item;
+        slot.seq.store(_tail + N, std::memory_order_release);
+        _tail++;
+        return true;
+    }
+
+    // Consumer: a snapshot that may be stale by the time it is used
+    bool empty() const {
+        return _slots[_tail & (N - 1)].seq.load(std::memory_order_acquire) != _tail + 1;
+    }
+    static constexpr size_t capacity() { return N; }
+};
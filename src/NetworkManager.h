@@ -3,11 +3,27 @@
 #include <WiFi.h>
 #include <WebServer.h>
 #include <DNSServer.h>
-#include <Preferences.h>
+#include <LittleFS.h>
+#include "ConfigStore.h"
+#include "EventBus.h"
+#include "WiFiScanCache.h"
+#include "Metrics.h"
+#include "TouchRecorder.h"
+#include "WeatherManager.h"
 
 // Forward declaration
 class DisplayManager;
 
+// Connectivity supervisor states
+enum ConnectivityState {
+    CONN_IDLE = 0,        // begin() not called yet
+    CONN_CONNECTING,      // initial association with stored credentials
+    CONN_CONNECTED,
+    CONN_BACKOFF,         // waiting before the next attempt
+    CONN_AP_FALLBACK,     // provisioning portal up (no credentials or initial connect failed)
+    CONN_RECONNECTING     // link dropped after having been connected
+};
+
 class NetworkManager {
 private:
     String _apName;
@@ -21,11 +37,54 @@ private:
     bool _provisioned;
     bool _inApMode = false;
     unsigned long _apStartTime = 0;
-    Preferences _prefs;
-    Preferences _locPrefs;
+    ConfigStore* _config;
     DisplayManager* _display;
-    void* _weatherMgr;  // Use void* to avoid circular dependency
-    bool _locationUpdated = false;  // Flag to signal location changed
+    WeatherManager* _weather;       // geocodes postcodes and place names for the config page
+    EventBus* _bus;                 // EVENT_LOCATION_CHANGED, EVENT_LINK_UP/DOWN
+    WiFiScanCache _scanCache;       // Background scan results served by /api/scan
+    String _visibilityCheckSSID;    // Stored SSID to look for in the first AP-mode scan
+
+    // Fast reconnect: last good BSSID/channel/DHCP lease, persisted through ConfigStore.
+    // Reusing the lease skips DHCP while associating, and the device comes up on it. Once
+    // the link-up work is done, a DHCP exchange checks it (startLeaseCheck()): its answer
+    // confirms or replaces the address, and without one the cached lease goes back on and
+    // is checked again later. The core cannot run DHCP under a static address, so the
+    // address is gone for that exchange. The lease is also dropped whenever the fast path fails.
+    static const bool REUSE_DHCP_LEASE = true;
+    static const uint32_t FAST_CONNECT_TIMEOUT_MS = 3000;
+    static const uint32_t LEASE_CHECK_DELAY_MS = 30000;    // after link-up: NTP, timezone, forecast
+    static const uint32_t LEASE_RENEW_TIMEOUT_MS = 10000;  // DHCP answer to a lease check
+    static const uint32_t LEASE_RECHECK_MS = 600000;       // next check after DHCP stayed silent
+    bool _leaseCheckPending = false;
+    unsigned long _leaseCheckAtMs = 0;
+    bool _leaseRenewing = false;
+    unsigned long _leaseRenewStartMs = 0;
+    unsigned long _connectStartMs = 0;
+    unsigned long _bootToConnectedMs = 0;  // millis() when WiFi first came up
+    uint32_t _connectDurationMs = 0;       // time spent inside the connect path
+    const char* _connectPath = "none";     // "fast", "full" or "none"
+
+    // Connectivity supervisor (driven from update(), never blocks)
+    static const uint8_t MAX_INITIAL_ATTEMPTS = 3;       // full attempts before falling back to AP
+    static const uint32_t FULL_CONNECT_TIMEOUT_MS = 20000;
+    static const uint32_t BACKOFF_BASE_MS = 2000;
+    static const uint32_t BACKOFF_MAX_MS = 60000;
+    static const uint32_t AP_FALLBACK_RETRY_MS = 120000; // retry stored network after 2 min in AP mode
+    ConnectivityState _connState = CONN_IDLE;
+    bool _credentialsChanged = false;
+    bool _attemptIsFast = false;
+    bool _staticLeaseApplied = false;
+    bool _everConnected = false;
+    uint8_t _attempt = 0;              // consecutive failed full attempts
+    unsigned long _attemptStartMs = 0;
+    unsigned long _nextAttemptMs = 0;
+
+    // Outage statistics (runtime drops only; the initial connect is not an outage)
+    uint32_t _reconnectCount = 0;
+    unsigned long _outageStartMs = 0;
+    uint32_t _lastOutageMs = 0;
+    uint32_t _longestOutageMs = 0;
+    uint32_t _totalOutageMs = 0;
 
 public:
     NetworkManager() 
@@ -33,8 +92,10 @@ public:
           _server(nullptr),
           _dnsServer(nullptr),
           _provisioned(false),
+          _config(nullptr),
           _display(nullptr),
-          _weatherMgr(nullptr) {}
+          _weather(nullptr),
+          _bus(nullptr) {}
 
     ~NetworkManager() {
         if (_server) delete _server;
@@ -45,139 +106,372 @@ public:
         _display = display;
     }
 
-    void setWeatherManager(void* weatherMgr) {
-        _weatherMgr = weatherMgr;
+    void setWeatherManager(WeatherManager* weather) {
+        _weather = weather;
+    }
+
+    void setEventBus(EventBus* bus) {
+        _bus = bus;
+    }
+
+    void setConfigStore(ConfigStore* config) {
+        _config = config;
     }
 
-    bool hasStoredCredentials() {
-        _prefs.begin("wifi", true);  // read-only
-        bool hasSSID = _prefs.isKey("ssid");
-        _prefs.end();
-        return hasSSID;
+    bool hasStoredCredentials() const {
+        return _config && _config->hasWifiCredentials();
     }
 
-    // Must be called from main loop to handle server requests and AP timeout
+    // Must be called from main loop to handle server requests and drive the connectivity supervisor
     void update() {
         if (_server) {
+            ScopedTimer t(metricHttpHandleDuration);
             _server->handleClient();
         }
         if (_dnsServer) {
             _dnsServer->processNextRequest();
         }
-        
-        // If in AP mode, check for timeout (2 minutes)
-        if (_inApMode && _apStartTime > 0) {
-            unsigned long elapsed = millis() - _apStartTime;
-            if (elapsed > 120000 && !_provisioned) {
-                Serial.println("AP timeout - rebooting to retry");
-                if (_display) {
-                    _display->showStatus("AP timeout, rebooting...");
-                }
-                delay(2000);
-                ESP.restart();
+        _scanCache.update();
+
+        // Report whether the stored SSID is visible once the first background scan lands
+        if (_visibilityCheckSSID.length() > 0 && _scanCache.hasResults()) {
+            int ch = _scanCache.findChannel(_visibilityCheckSSID);
+            if (ch < 0) {
+                Serial.println("[WiFi] Target SSID not visible on 2.4GHz scan. Ensure 2.4GHz is enabled and SSID is broadcasting.");
+            } else {
+                Serial.printf("[WiFi] Found SSID '%s' on channel %d\n", _visibilityCheckSSID.c_str(), ch);
             }
+            _visibilityCheckSSID = "";
         }
+
+        superviseConnection();
     }
 
+    // Starts connecting (or provisioning) and returns immediately; progress is driven by update()
     bool begin() {
         Serial.println("Starting WiFi connection...");
         
+        _connectStartMs = millis();
+        WiFi.setAutoReconnect(false);  // reconnect policy is owned by the supervisor
+
         // Try stored credentials first
-        _prefs.begin("wifi", false);
-        String storedSSID = _prefs.getString("ssid", "");
-        String storedPass = _prefs.getString("pass", "");
-        
-        if (storedSSID.length() > 0) {
+        if (hasStoredCredentials()) {
             Serial.print("Found stored credentials for: ");
-            Serial.println(storedSSID);
-            
-            // Try up to 3 times with 20-second timeout each, resetting WiFi between attempts
-            const int maxRetries = 3;
-            const int timeoutSeconds = 20;
-
-            // Optional: quick visibility on whether SSID is present (2.4GHz only)
-            int foundChannel = -1;
-            int nScan = WiFi.scanNetworks();
-            for (int i = 0; i < nScan; i++) {
-                if (WiFi.SSID(i) == storedSSID) {
-                    foundChannel = WiFi.channel(i);
-                    break;
-                }
+            Serial.println(_config->wifi().ssid);
+
+            // Fast path first (last known AP/channel, optionally without DHCP), full path on failure
+            _attempt = 0;
+            startAttempt(hasFastConnect());
+            setState(CONN_CONNECTING);
+            return false;
+        }
+        
+        // No stored credentials - start provisioning AP mode
+        startAccessPoint();
+        return false;  // Provisioning not yet complete; wait for user input
+    }
+
+    bool isProvisioned() const {
+        return _provisioned;
+    }
+
+    const char* apName() const { 
+        return _apName.c_str(); 
+    }
+
+    bool isInApMode() const {
+        return _inApMode;
+    }
+
+    bool isConnected() const { return _connState == CONN_CONNECTED; }
+    ConnectivityState connectivityState() const { return _connState; }
+    const char* connectivityStateName() const { return stateName(_connState); }
+
+    static const char* stateName(ConnectivityState state) {
+        switch (state) {
+            case CONN_IDLE: return "idle";
+            case CONN_CONNECTING: return "connecting";
+            case CONN_CONNECTED: return "connected";
+            case CONN_BACKOFF: return "backoff";
+            case CONN_AP_FALLBACK: return "ap-fallback";
+            case CONN_RECONNECTING: return "reconnecting";
+        }
+        return "unknown";
+    }
+
+    // Outage statistics
+    uint32_t reconnectCount() const { return _reconnectCount; }
+    uint32_t lastOutageMs() const { return _lastOutageMs; }
+    uint32_t longestOutageMs() const { return _longestOutageMs; }
+    uint32_t totalOutageMs() const { return _totalOutageMs + currentOutageMs(); }
+    uint32_t currentOutageMs() const {
+        return (_everConnected && _connState != CONN_CONNECTED) ? (uint32_t)(millis() - _outageStartMs) : 0;
+    }
+
+    // Boot-to-connected instrumentation (0 until the first successful connection)
+    unsigned long bootToConnectedMs() const { return _bootToConnectedMs; }
+    uint32_t connectDurationMs() const { return _connectDurationMs; }
+    const char* lastConnectPath() const { return _connectPath; }
+
+    void ensureServerRunning(bool apMode) {
+        _inApMode = apMode;
+        // Stop DNS when not in AP captive portal mode
+        if (!apMode && _dnsServer) {
+            _dnsServer->stop();
+            delete _dnsServer;
+            _dnsServer = nullptr;
+        }
+
+        // If leaving AP mode, stop SoftAP to avoid interfering with STA traffic
+        if (!apMode && WiFi.getMode() == WIFI_AP_STA) {
+            WiFi.softAPdisconnect(true);
+        }
+
+        // Channel-hopping scans glitch STA traffic; only keep scanning while provisioning
+        _scanCache.setEnabled(apMode);
+
+        // Start HTTP server if not already running
+        if (!_server) {
+            _server = new WebServer(80);
+            setupWebServer();
+            _server->begin();
+        }
+    }
+
+private:
+    bool hasFastConnect() const {
+        return _config && _config->wifi().hasFastConnect;
+    }
+
+    // Record BSSID/channel/lease of the current connection (ConfigStore skips unchanged values)
+    void saveFastConnectInfo() {
+        const uint8_t* bssid = WiFi.BSSID();
+        if (!bssid || !_config || WiFi.localIP() == IPAddress()) return;
+        bool changed = !_config->wifi().hasFastConnect || _config->wifi().channel != WiFi.channel() ||
+                       _config->wifi().ip != (uint32_t)WiFi.localIP();
+        _config->setFastConnect(bssid, (uint8_t)WiFi.channel(), (uint32_t)WiFi.localIP(),
+                                (uint32_t)WiFi.gatewayIP(), (uint32_t)WiFi.subnetMask(), (uint32_t)WiFi.dnsIP(0));
+        if (changed) {
+            Serial.printf("[WiFi] Fast-connect cache updated: ch %d, BSSID %s, IP %s\n",
+                          (int)WiFi.channel(), WiFi.BSSIDstr().c_str(), WiFi.localIP().toString().c_str());
+        }
+    }
+
+    // Kick off one non-blocking association attempt; superviseConnection() watches the outcome
+    void startAttempt(bool fast) {
+        const WifiConfig& wifi = _config->wifi();
+        _attemptIsFast = fast && wifi.hasFastConnect;
+        _attemptStartMs = millis();
+
+        // Keep the provisioning AP up while trying freshly entered credentials
+        WiFi.mode(_inApMode ? WIFI_AP_STA : WIFI_STA);
+        // Optional hostname for easier router identification
+        WiFi.setHostname("TouchClock");
+
+        if (_attemptIsFast) {
+            if (REUSE_DHCP_LEASE && wifi.ip != 0 && wifi.gateway != 0) {
+                applyCachedLease();
+            } else if (_staticLeaseApplied) {
+                WiFi.config(INADDR_NONE, INADDR_NONE, INADDR_NONE);
+                _staticLeaseApplied = false;
             }
-            WiFi.scanDelete();
-            if (foundChannel < 0) {
-                Serial.println("[WiFi] Target SSID not visible on 2.4GHz scan. Ensure 2.4GHz is enabled and SSID is broadcasting.");
-            } else {
-                Serial.printf("[WiFi] Found SSID '%s' on channel %d\n", storedSSID.c_str(), foundChannel);
+            Serial.printf("[WiFi] Fast connect: ch %u%s\n", wifi.channel,
+                          _staticLeaseApplied ? ", reusing lease" : "");
+            if (_display) {
+                _display->showStatus("WiFi: " + wifi.ssid + " (fast connect)");
             }
-            
-            for (int attempt = 1; attempt <= maxRetries; attempt++) {
-                Serial.print("Connection attempt ");
-                Serial.print(attempt);
-                Serial.print("/");
-                Serial.println(maxRetries);
-                
-                if (_display) {
-                    _display->showStatus("WiFi: " + storedSSID + " (attempt " + String(attempt) + "/" + String(maxRetries) + ")");
+            WiFi.begin(wifi.ssid.c_str(), wifi.pass.c_str(), wifi.channel, wifi.bssid);
+            return;
+        }
+
+        // Full path: scan all channels and run DHCP
+        if (_staticLeaseApplied) {
+            WiFi.config(INADDR_NONE, INADDR_NONE, INADDR_NONE);
+            _staticLeaseApplied = false;
+        }
+        if (_everConnected) {
+            Serial.printf("[WiFi] Reconnect attempt %u\n", _attempt + 1);
+        } else {
+            Serial.printf("Connection attempt %u/%u\n", _attempt + 1, MAX_INITIAL_ATTEMPTS);
+        }
+        if (_display) {
+            String msg = "WiFi: " + wifi.ssid + " (attempt " + String(_attempt + 1);
+            if (!_everConnected) msg += "/" + String(MAX_INITIAL_ATTEMPTS);
+            _display->showStatus(msg + ")");
+        }
+        WiFi.begin(wifi.ssid.c_str(), wifi.pass.c_str());
+    }
+
+    void handleAttemptFailed() {
+        Serial.printf("[WiFi] Attempt failed, status code: %d\n", (int)WiFi.status());
+        WiFi.disconnect();
+
+        if (_attemptIsFast) {
+            // AP moved/changed or lease no longer valid: go straight to the full path
+            Serial.println("[WiFi] Fast connect failed, falling back to full scan + DHCP");
+            startAttempt(false);
+            return;
+        }
+
+        if (_attempt < UINT8_MAX) _attempt++;  // a router off for hours must not wrap it
+        if (!_everConnected && _attempt >= MAX_INITIAL_ATTEMPTS) {
+            Serial.printf("Failed to connect after %u attempts\n", MAX_INITIAL_ATTEMPTS);
+            Serial.println("[WiFi] Tips: Use 2.4GHz, WPA2 (not WPA3), avoid hidden SSIDs.");
+            if (_display) {
+                _display->showStatus("WiFi failed after 3 attempts - switching to AP mode");
+            }
+            // Stored credentials are preserved and retried from AP fallback
+            // The provisioning scan will report whether the SSID is visible at all
+            _visibilityCheckSSID = _config->wifi().ssid;
+            startAccessPoint();
+            return;
+        }
+
+        // Exponential backoff: 2 s, 4 s, 8 s ... capped at one minute
+        uint8_t shift = _attempt > 5 ? 5 : _attempt - 1;
+        uint32_t backoffMs = BACKOFF_BASE_MS << shift;
+        if (backoffMs > BACKOFF_MAX_MS) backoffMs = BACKOFF_MAX_MS;
+        _nextAttemptMs = millis() + backoffMs;
+        Serial.printf("[WiFi] Retrying in %lu ms\n", (unsigned long)backoffMs);
+        setState(CONN_BACKOFF);
+    }
+
+    void handleLinkUp() {
+        if (_everConnected) {
+            _reconnectCount++;
+            _lastOutageMs = millis() - _outageStartMs;
+            _totalOutageMs += _lastOutageMs;
+            if (_lastOutageMs > _longestOutageMs) _longestOutageMs = _lastOutageMs;
+            Serial.printf("[WiFi] Reconnected after %lu ms outage (reconnect #%lu)\n",
+                          (unsigned long)_lastOutageMs, (unsigned long)_reconnectCount);
+        }
+        Serial.print("Connected! IP: ");
+        Serial.println(WiFi.localIP());
+        onConnected(_attemptIsFast ? "fast" : "full");
+        // Online on the cached lease; DHCP checks it once the link-up work is done
+        _leaseCheckPending = _staticLeaseApplied;
+        _leaseCheckAtMs = millis() + LEASE_CHECK_DELAY_MS;
+        _attempt = 0;
+        _everConnected = true;
+        ensureServerRunning(false);  // Run HTTP server on STA IP (drops the AP if it was up)
+        setState(CONN_CONNECTED);
+    }
+
+    void applyCachedLease() {
+        const WifiConfig& wifi = _config->wifi();
+        WiFi.config(IPAddress(wifi.ip), IPAddress(wifi.gateway), IPAddress(wifi.subnet), IPAddress(wifi.dns));
+        _staticLeaseApplied = true;
+    }
+
+    // Hand the cached address to DHCP; renewLease() waits for the answer
+    void startLeaseCheck(unsigned long now) {
+        Serial.println("[WiFi] Checking the reused lease with DHCP");
+        WiFi.config(INADDR_NONE, INADDR_NONE, INADDR_NONE);
+        _staticLeaseApplied = false;
+        _leaseCheckPending = false;
+        _leaseRenewing = true;
+        _leaseRenewStartMs = now;
+    }
+
+    // Cache DHCP's answer, or go back to the cached lease if there is none
+    void renewLease(unsigned long now) {
+        IPAddress ip = WiFi.localIP();
+        if (ip != IPAddress()) {
+            _leaseRenewing = false;
+            bool same = _config && (uint32_t)ip == _config->wifi().ip;
+            Serial.printf("[WiFi] DHCP %s %s after %lu ms\n", same ? "confirmed" : "moved us to",
+                          ip.toString().c_str(), (unsigned long)(now - _leaseRenewStartMs));
+            saveFastConnectInfo();
+        } else if (now - _leaseRenewStartMs >= LEASE_RENEW_TIMEOUT_MS) {
+            // Never stay up without an address: the cached one is the best guess we have
+            _leaseRenewing = false;
+            applyCachedLease();
+            _leaseCheckPending = true;
+            _leaseCheckAtMs = now + LEASE_RECHECK_MS;
+            Serial.println("[WiFi] No DHCP answer in 10 s; back on the cached lease, checking again in 10 min");
+        }
+    }
+
+    void superviseConnection() {
+        unsigned long now = millis();
+        bool linkUp = WiFi.status() == WL_CONNECTED;
+        // Online means associated with an address; dependents start fetching on LINK_UP
+        bool online = linkUp && WiFi.localIP() != IPAddress();
+
+        switch (_connState) {
+            case CONN_CONNECTING:
+            case CONN_RECONNECTING:
+                if (online) {
+                    handleLinkUp();
+                } else if (now - _attemptStartMs >= (_attemptIsFast ? FAST_CONNECT_TIMEOUT_MS : FULL_CONNECT_TIMEOUT_MS)) {
+                    handleAttemptFailed();
                 }
-                
-                WiFi.mode(WIFI_STA);
-                // Optional hostname for easier router identification
-                WiFi.setHostname("TouchClock");
-                WiFi.begin(storedSSID.c_str(), storedPass.c_str());
-                
-                // Wait up to 10 seconds for connection
-                int elapsedSeconds = 0;
-                while (WiFi.status() != WL_CONNECTED && elapsedSeconds < timeoutSeconds) {
-                    delay(1000);
-                    elapsedSeconds++;
-                    if (_display) {
-                        String progress = "WiFi: " + storedSSID + " (" + String(elapsedSeconds) + "/" + String(timeoutSeconds) + "s)";
-                        _display->showStatus(progress);
-                    }
-                    Serial.print(".");
+                break;
+
+            case CONN_BACKOFF:
+                if (online) {
+                    handleLinkUp();
+                } else if ((long)(now - _nextAttemptMs) >= 0) {
+                    startAttempt(false);
+                    setState(_everConnected ? CONN_RECONNECTING : CONN_CONNECTING);
                 }
-                Serial.println();
-                
-                if (WiFi.status() == WL_CONNECTED) {
-                    Serial.print("Connected! IP: ");
-                    Serial.println(WiFi.localIP());
-                    ensureServerRunning(false); // Run HTTP server on STA IP
-                    return true;
-                } else {
-                    Serial.print("Connection failed, attempt ");
-                    Serial.print(attempt);
-                    Serial.println(" unsuccessful");
-                    Serial.print("[WiFi] Status code: ");
-                    Serial.println(WiFi.status());
-                    Serial.println("[WiFi] Tips: Use 2.4GHz, WPA2 (not WPA3), avoid hidden SSIDs.");
-                    
-                    // Reset WiFi for next attempt (except after last attempt)
-                    if (attempt < maxRetries) {
-                        WiFi.disconnect(true);  // true = turn off WiFi radio
-                        Serial.println("WiFi reset, preparing for next attempt...");
-                        delay(2000);
+                break;
+
+            case CONN_CONNECTED:
+                if (linkUp && _leaseRenewing) {
+                    renewLease(now);
+                } else if (linkUp && _leaseCheckPending && (long)(now - _leaseCheckAtMs) >= 0) {
+                    startLeaseCheck(now);
+                } else if (!linkUp) {
+                    _leaseRenewing = false;
+                    _leaseCheckPending = false;
+                    Serial.printf("[WiFi] Link lost (status %d), reconnecting\n", (int)WiFi.status());
+                    _outageStartMs = now;
+                    _connectStartMs = now;
+                    _attempt = 0;
+                    setState(CONN_RECONNECTING);
+                    startAttempt(hasFastConnect());
+                }
+                break;
+
+            case CONN_AP_FALLBACK:
+                if (_credentialsChanged) {
+                    // Freshly provisioned network: try it while the portal stays up
+                    _credentialsChanged = false;
+                    _attempt = 0;
+                    _connectStartMs = now;
+                    startAttempt(false);
+                    setState(CONN_CONNECTING);
+                } else if (now - _apStartTime > AP_FALLBACK_RETRY_MS) {
+                    _apStartTime = now;
+                    if (hasStoredCredentials()) {
+                        // Rather than rebooting, periodically retry the stored network
+                        Serial.println("AP timeout - retrying stored network");
+                        _attempt = 0;
+                        _connectStartMs = now;
+                        startAttempt(hasFastConnect());
+                        setState(CONN_CONNECTING);
                     }
                 }
-            }
-            
-            // All 3 attempts failed
-            Serial.println("Failed to connect after 3 attempts");
-            if (_display) {
-                _display->showStatus("WiFi failed after 3 attempts - switching to AP mode");
-                delay(2000);
-            }
-            WiFi.disconnect();
-            // Note: NOT clearing stored credentials - they are preserved for next boot
+                break;
+
+            default:
+                break;
         }
-        
-        // No stored credentials or connection failed 3 times - start provisioning AP mode
-        // Stored credentials are preserved and will be tried again on next boot
+    }
+
+    void startAccessPoint() {
+        if (_inApMode) {
+            // Already serving the portal (retry from AP fallback failed again)
+            _apStartTime = millis();
+            setState(CONN_AP_FALLBACK);
+            return;
+        }
+
         Serial.println("Starting WiFi provisioning (AP mode)...");
 
         // Ensure clean WiFi state
         WiFi.softAPdisconnect(true);
-        delay(100);
         
         // Set WiFi mode to AP+STA
         WiFi.mode(WIFI_AP_STA);
@@ -189,7 +483,7 @@ public:
         bool apStarted = WiFi.softAP(_apName.c_str(), NULL, 1, 0, 4, false);
         if (!apStarted) {
             Serial.println("Failed to start SoftAP");
-            return false;
+            return;
         }
 
         Serial.print("SoftAP started: ");
@@ -206,58 +500,40 @@ public:
         ensureServerRunning(true);
 
         Serial.println("HTTP server started in AP mode");
+        if (_display) {
+            _display->showInstruction(String("Connect to ") + _apName + "\nOpen a browser to configure WiFi");
+        }
 
         _provisioned = false;
-        _inApMode = true;
         _apStartTime = millis();
-        
-        // Return immediately - server will be handled in update() calls from main loop
-        return false;  // Provisioning not yet complete; wait for user input
+        setState(CONN_AP_FALLBACK);
     }
 
-    bool isProvisioned() const {
-        return _provisioned;
-    }
+    void setState(ConnectivityState next) {
+        if (next == _connState) return;
+        ConnectivityState prev = _connState;
+        _connState = next;
+        Serial.printf("[WiFi] %s -> %s\n", stateName(prev), stateName(next));
 
-    const char* apName() const { 
-        return _apName.c_str(); 
-    }
-
-    bool isInApMode() const {
-        return _inApMode;
-    }
-
-    bool checkAndClearLocationUpdated() {
-        if (_locationUpdated) {
-            _locationUpdated = false;
-            return true;
+        // Dependent fetchers only care about online/offline edges
+        bool wasOnline = prev == CONN_CONNECTED;
+        bool isOnline = next == CONN_CONNECTED;
+        if (wasOnline != isOnline && _bus) {
+            _bus->publish(Event::of(isOnline ? EVENT_LINK_UP : EVENT_LINK_DOWN));
         }
-        return false;
     }
 
-    void ensureServerRunning(bool apMode) {
-        _inApMode = apMode;
-        // Stop DNS when not in AP captive portal mode
-        if (!apMode && _dnsServer) {
-            _dnsServer->stop();
-            delete _dnsServer;
-            _dnsServer = nullptr;
-        }
-
-        // If leaving AP mode, stop SoftAP to avoid interfering with STA traffic
-        if (!apMode && WiFi.getMode() == WIFI_AP_STA) {
-            WiFi.softAPdisconnect(true);
-        }
-
-        // Start HTTP server if not already running
-        if (!_server) {
-            _server = new WebServer(80);
-            setupWebServer();
-            _server->begin();
+    void onConnected(const char* path) {
+        _connectPath = path;
+        _connectDurationMs = millis() - _connectStartMs;
+        if (_bootToConnectedMs == 0) {
+            _bootToConnectedMs = millis();
         }
+        Serial.printf("[WiFi] Connected via %s path in %lu ms (boot +%lu ms)\n",
+                      path, (unsigned long)_connectDurationMs, _bootToConnectedMs);
+        saveFastConnectInfo();
     }
 
-private:
     // Resolve the proper host/IP for the config server depending on mode
     String serverHost() {
         IPAddress ip = _inApMode ? WiFi.softAPIP() : WiFi.localIP();
@@ -289,31 +565,55 @@ private:
                 _server->send(403, "application/json", "{\"error\":\"scan not available in STA mode\"}");
                 return;
             }
-            int n = WiFi.scanNetworks();
-            String json = "[";
-            for (int i = 0; i < n; i++) {
-                if (i > 0) json += ",";
-                json += "{\"ssid\":\"" + WiFi.SSID(i) + "\",\"rssi\":" + String(WiFi.RSSI(i)) + "}";
+            // Answer from the background cache; only kick a refresh when it has gone stale
+            if (_scanCache.isStale()) {
+                _scanCache.requestRefresh();
             }
-            json += "]";
+            String json = "{\"age_ms\":";
+            json += _scanCache.hasResults() ? String(_scanCache.ageMs()) : String("null");
+            json += ",\"scanning\":";
+            json += _scanCache.isScanning() ? "true" : "false";
+            json += ",\"networks\":";
+            json += _scanCache.networksJson();
+            json += "}";
+            _server->send(200, "application/json", json);
+        });
+
+        // Connectivity state, polled by the setup page while it joins the new network
+        _server->on("/api/status", HTTP_GET, [this]() {
+            String json = "{\"state\":\"";
+            json += stateName(_connState);
+            json += "\",\"pending\":";
+            json += _credentialsChanged ? "true" : "false";
+            json += ",\"ip\":\"" + WiFi.localIP().toString() + "\"}";
             _server->send(200, "application/json", json);
-            WiFi.scanDelete();
+        });
+
+        // Prometheus scrape endpoint (available in both AP and STA mode)
+        _server->on("/api/metrics", HTTP_GET, [this]() {
+            _server->send(200, "text/plain; version=0.0.4", Metrics::renderPrometheus());
+        });
+
+        // Last touch trace recorded from debug mode, for tools/touch_replay.cpp
+        _server->on("/api/touch/trace", HTTP_GET, [this]() {
+            File trace = LittleFS.open(TouchRecorder::PATH, "r");
+            if (!trace) {
+                _server->send(404, "text/plain", "No touch trace recorded");
+                return;
+            }
+            _server->streamFile(trace, "text/plain");
+            trace.close();
         });
 
         // API endpoint to get current location
         _server->on("/api/location", HTTP_GET, [this]() {
-            _locPrefs.begin("location", true);
-            String postcode = _locPrefs.getString("postcode", "");
-            float lat = _locPrefs.getFloat("lat", 0.0f);
-            float lon = _locPrefs.getFloat("lon", 0.0f);
-            String town = _locPrefs.getString("town", "");
-            _locPrefs.end();
-            
+            // Served from RAM; no NVS access on the request path
+            const LocationConfig& loc = _config->location();
             String json = "{";
-            json += "\"postcode\":\"" + postcode + "\",";
-            json += "\"lat\":" + String(lat, 6) + ",";
-            json += "\"lon\":" + String(lon, 6) + ",";
-            json += "\"town\":\"" + town + "\"";
+            json += "\"postcode\":\"" + loc.postcode + "\",";
+            json += "\"lat\":" + String(loc.lat, 6) + ",";
+            json += "\"lon\":" + String(loc.lon, 6) + ",";
+            json += "\"town\":\"" + loc.town + "\"";
             json += "}";
             _server->send(200, "application/json", json);
         });
@@ -340,8 +640,7 @@ private:
                 String outTown = "";
                 String postcode = _server->arg("postcode");
                 
-                extern bool weatherManagerGeocode(void*, const String&, float&, float&, String&);
-                if (_weatherMgr && weatherManagerGeocode(_weatherMgr, postcode, outLat, outLon, outTown)) {
+                if (_weather && _weather->verifyAndGeocode(postcode, outLat, outLon, outTown)) {
                     json += "\"lat\":" + String(outLat, 6) + ",";
                     json += "\"lon\":" + String(outLon, 6) + ",";
                     json += "\"town\":\"" + outTown + "\",";
@@ -371,35 +670,23 @@ private:
 
             // Persist location preferences for WeatherManager to use later
             if (hasCoords || hasPostcode) {
-                _locPrefs.begin("location", false);
                 if (hasCoords) {
-                    float lat = _selectedLat.toFloat();
-                    float lon = _selectedLon.toFloat();
-                    _locPrefs.putFloat("lat", lat);
-                    _locPrefs.putFloat("lon", lon);
-                    _locPrefs.putString("postcode", "");
-                    // If client provided a town name (from verification), persist it immediately
-                    if (_server->hasArg("town") && _server->arg("town").length() > 0) {
-                        _locPrefs.putString("town", _server->arg("town"));
-                    }
+                    // If client provided a town name (from verification), persist it with the coordinates
+                    String town = _server->hasArg("town") ? _server->arg("town") : String("");
+                    _config->setLocationCoords(_selectedLat.toFloat(), _selectedLon.toFloat(), town);
                 } else if (hasPostcode) {
                     // Geocode postcode immediately to store lat/lon and friendly town
                     float outLat = 0.0f, outLon = 0.0f; String outTown = "";
-                    extern bool weatherManagerGeocode(void*, const String&, float&, float&, String&);
-                    bool ok = (_weatherMgr && weatherManagerGeocode(_weatherMgr, _selectedPostcode, outLat, outLon, outTown));
+                    bool ok = (_weather && _weather->verifyAndGeocode(_selectedPostcode, outLat, outLon, outTown));
                     if (ok) {
-                        _locPrefs.putFloat("lat", outLat);
-                        _locPrefs.putFloat("lon", outLon);
-                        _locPrefs.putString("town", outTown);
-                        _locPrefs.putString("postcode", _selectedPostcode);
+                        _config->setLocationGeocoded(_selectedPostcode, outLat, outLon, outTown);
                         Serial.printf("[Location Save] Geocoded '%s' → %s (%.4f, %.4f)\n", _selectedPostcode.c_str(), outTown.c_str(), outLat, outLon);
                     } else {
                         // Fallback: store postcode; WeatherManager will resolve later
-                        _locPrefs.putString("postcode", _selectedPostcode);
+                        _config->setLocationPostcode(_selectedPostcode);
                         Serial.printf("[Location Save] Geocode failed for '%s', stored postcode for later resolution\n", _selectedPostcode.c_str());
                     }
                 }
-                _locPrefs.end();
                 Serial.print("Location saved: ");
                 if (hasCoords) {
                     Serial.print("coords ");
@@ -418,11 +705,11 @@ private:
                     _server->send(400, "application/json", "{\"error\":\"Missing credentials\"}");
                     return;
                 }
-                _prefs.begin("wifi", false);
-                _prefs.putString("ssid", _selectedSSID);
-                _prefs.putString("pass", _selectedPass);
-                _prefs.end();
+                // Also drops the cached BSSID/lease, which belongs to the old network
+                _config->setWifiCredentials(_selectedSSID, _selectedPass);
+                _config->flush();  // credentials must survive a power cut right after provisioning
                 Serial.println("WiFi credentials saved");
+                _credentialsChanged = true;  // supervisor will try them on its next pass
                 _provisioned = true;
                 _server->send(200, "application/json", "{\"status\":\"ok\"}");
             } else {
@@ -432,17 +719,11 @@ private:
                     Serial.println("Ignoring SSID/pass update in STA mode (not supported live)");
                 }
                 if (hasCoords || hasPostcode) {
-                    Serial.println("[Location Update] Saving verified location...");
-                    // Trigger weather manager to reload location and fetch new weather
-                    // Use extern function to avoid circular dependency
-                    extern void weatherManagerReload(void*);
-                    if (_weatherMgr) {
-                        weatherManagerReload(_weatherMgr);
-                        _locationUpdated = true;  // Signal to main loop to force weather refresh
-                        Serial.println("[Location Update] Weather reload triggered, flag set for immediate refresh");
-                    } else {
-                        Serial.println("[Location Update] WARNING: WeatherManager pointer is null!");
-                    }
+                    // Weather and timezone follow from the event; the reply does not wait for them
+                    const LocationConfig& loc = _config->location();
+                    if (_bus) _bus->publish(Event::locationChanged(loc.hasCoords ? loc.lat : 0.0f,
+                                                                   loc.hasCoords ? loc.lon : 0.0f));
+                    Serial.println("[Location Update] Location saved, change published");
                     _server->send(200, "application/json", "{\"status\":\"ok\"}");
                 } else {
                     _server->send(400, "application/json", "{\"error\":\"No data to update\"}");
@@ -596,11 +877,15 @@ private:
                     setMode(true);
                     return r.json();
                 })
-                .then(networks => {
-                    if (!networks) return;
+                .then(data => {
+                    if (!data) return;
                     const div = document.getElementById('networks');
+                    if (!data.networks.length) {
+                        div.textContent = data.scanning ? 'Scanning...' : 'No networks found';
+                        return;
+                    }
                     div.innerHTML = '';
-                    networks.forEach(net => {
+                    data.networks.forEach(net => {
                         const item = document.createElement('div');
                         item.className = 'network-item';
                         item.textContent = net.ssid + ' (' + net.rssi + ' dBm)';
@@ -643,7 +928,8 @@ private:
             .then(r => r.json())
             .then(data => {
                 if (data.status === 'ok') {
-                    showStatus('✓ Connected! Device will restart...', 'success', 'wifi');
+                    showStatus('Connecting to ' + ssid + '...', 'loading', 'wifi');
+                    watchConnect(ssid);
                 } else {
                     showStatus('Error: ' + (data.error || 'Unknown'), 'error', 'wifi');
                 }
@@ -651,6 +937,24 @@ private:
             .catch(() => showStatus('Connection failed', 'error', 'wifi'));
         }
 
+        // The clock joins the network without restarting; follow it until it has an address
+        function watchConnect(ssid) {
+            fetch('/api/status')
+                .then(r => r.json())
+                .then(data => {
+                    if (data.state === 'connected') {
+                        showStatus('✓ Connected to ' + ssid + ' as ' + data.ip + '. This setup network closes now; ' +
+                                   'open http://' + data.ip + '/config from ' + ssid + '.', 'success', 'wifi');
+                    } else if (data.state === 'ap-fallback' && !data.pending) {
+                        showStatus('Could not join ' + ssid + '. Check the password and try again.', 'error', 'wifi');
+                    } else {
+                        setTimeout(() => watchConnect(ssid), 1000);
+                    }
+                })
+                .catch(() => showStatus('✓ The setup network closed as the clock joined ' + ssid +
+                                        '. Its new address is on the clock screen.', 'success', 'wifi'));
+        }
+
         function loadCurrentLocation() {
             fetch('/api/location')
                 .then(r => r.json())
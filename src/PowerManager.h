@@ -0,0 +1,290 @@
+#pragma once
+#include <Arduino.h>
+#include <WiFi.h>
+#include <sys/time.h>
+#include "Metrics.h"
+#if CONFIG_PM_ENABLE
+#include <esp_idf_version.h>
+#include <esp_pm.h>
+#endif
+
+// What a holder needs the chip to keep doing
+enum PowerLockType : uint8_t {
+    POWER_LOCK_SPI = 0,  // panel pushes: full clock so a repaint stays short
+    POWER_LOCK_AUDIO,    // chime playback: full clock for the bell synth
+    POWER_LOCK_LED,      // LEDC fades: any clock, but no light sleep (the PWM would stop)
+    POWER_LOCK_COUNT
+};
+
+enum PowerState : uint8_t {
+    POWER_ACTIVE = 0,  // a full-clock lock is held
+    POWER_IDLE,        // screen on, nothing to push: minimum clock
+    POWER_SLEEP,       // screen off: minimum clock, modem sleep, light sleep between ticks
+    POWER_STATE_COUNT
+};
+
+// CPU clock and sleep policy. Nothing runs at full clock unless it holds a lock: DisplayManager
+// takes POWER_LOCK_SPI around every panel push, AudioOutput POWER_LOCK_AUDIO for a chime,
+// RGBLedManager POWER_LOCK_LED while the LED is lit. Between those the CPU drops to 80 MHz.
+//
+// While the screen is off (setScreenOn(false)) the WiFi radio sleeps between beacons, and
+// the loop only wakes once a second (loopWaitMs()). The backlight flicker modem sleep used
+// to cause (ISSUES.md) cannot be seen with the backlight off, so on return the radio stays
+// awake again.
+//
+// With a core built with CONFIG_PM_ENABLE the locks are ESP-IDF PM locks, so the frequency
+// switches inside esp_pm_lock_acquire(), and with tickless idle the chip also light-sleeps
+// between ticks while the screen is off. The stock Arduino core has neither; there the loop
+// task switches the clock with setCpuFrequencyMhz() itself: at once for a lock it takes,
+// on its next update() for locks taken or dropped by other tasks.
+//
+// Time spent in each state is kept for touchclock_power_state_seconds_total.
+class PowerManager {
+public:
+    static const uint32_t MIN_MHZ = 80;       // lowest clock with WiFi and an 80 MHz APB
+    static const uint32_t LOOP_WAIT_MS = 5;   // loop() pacing while the screen is on
+
+    // Holds a lock for its scope; a null manager makes it a no-op
+    class Hold {
+        PowerManager* _pm;
+        PowerLockType _type;
+
+    public:
+        Hold(PowerManager* pm, PowerLockType type) : _pm(pm), _type(type) {
+            if (_pm) _pm->acquire(_type);
+        }
+        ~Hold() {
+            if (_pm) _pm->release(_type);
+        }
+        Hold(const Hold&) = delete;
+        Hold& operator=(const Hold&) = delete;
+    };
+
+private:
+    mutable portMUX_TYPE _mux = portMUX_INITIALIZER_UNLOCKED;
+    uint8_t _held[POWER_LOCK_COUNT] = {};
+    bool _screenOn = true;
+    PowerState _state = POWER_IDLE;
+    uint32_t _sinceUs = 0;  // start of the part of this state not yet in _stateUs
+    uint64_t _stateUs[POWER_STATE_COUNT] = {};
+
+    uint32_t _maxMhz = 240;
+    TaskHandle_t _loopTask = nullptr;
+    bool _lightSleep = false;  // automatic light sleep currently enabled
+#if CONFIG_PM_ENABLE
+    esp_pm_lock_handle_t _locks[POWER_LOCK_COUNT] = {};
+    bool _pmConfigured = false;
+#endif
+
+    static bool raisesClock(PowerLockType type) {
+        return type == POWER_LOCK_SPI || type == POWER_LOCK_AUDIO;
+    }
+
+    // Caller holds _mux: bank the time since the last change, then re-evaluate the state.
+    // Also called on every update() so the 32-bit micros() difference never wraps.
+    void accountLocked() {
+        uint32_t now = micros();
+        _stateUs[_state] += now - _sinceUs;
+        _sinceUs = now;
+        if (_held[POWER_LOCK_SPI] || _held[POWER_LOCK_AUDIO]) {
+            _state = POWER_ACTIVE;
+        } else {
+            _state = _screenOn ? POWER_IDLE : POWER_SLEEP;
+        }
+    }
+
+#if CONFIG_PM_ENABLE
+    bool configurePm(bool lightSleep) {
+#if ESP_IDF_VERSION_MAJOR >= 5
+        esp_pm_config_t cfg = {};
+#else
+        esp_pm_config_esp32_t cfg = {};
+#endif
+        cfg.max_freq_mhz = (int)_maxMhz;
+        cfg.min_freq_mhz = (int)MIN_MHZ;
+        cfg.light_sleep_enable = lightSleep;
+        esp_err_t err = esp_pm_configure(&cfg);
+        if (err != ESP_OK) {
+            Serial.printf("[Power] esp_pm_configure failed (%d)\n", (int)err);
+            return false;
+        }
+        return true;
+    }
+#else
+    // Loop task only: setCpuFrequencyMhz() must not race itself
+    void applyClock() {
+        uint32_t want = cpuLocksHeld() ? _maxMhz : MIN_MHZ;
+        if (getCpuFrequencyMhz() != want) setCpuFrequencyMhz(want);
+    }
+#endif
+
+public:
+    // Call first in setup(), from the loop task, at the clock the core booted with
+    void begin() {
+        _loopTask = xTaskGetCurrentTaskHandle();
+        _maxMhz = getCpuFrequencyMhz();
+        portENTER_CRITICAL(&_mux);
+        _sinceUs = micros();
+        portEXIT_CRITICAL(&_mux);
+#if CONFIG_PM_ENABLE
+        static const esp_pm_lock_type_t kinds[POWER_LOCK_COUNT] = {
+            ESP_PM_CPU_FREQ_MAX, ESP_PM_CPU_FREQ_MAX, ESP_PM_NO_LIGHT_SLEEP};
+        static const char* const names[POWER_LOCK_COUNT] = {"spi", "audio", "led"};
+        for (uint8_t i = 0; i < POWER_LOCK_COUNT; i++) {
+            if (esp_pm_lock_create(kinds[i], 0, names[i], &_locks[i]) != ESP_OK) _locks[i] = nullptr;
+        }
+        _pmConfigured = configurePm(false);
+        Serial.printf("[Power] esp_pm DFS %lu-%lu MHz; light sleep while the screen is off: %s\n",
+                      (unsigned long)MIN_MHZ, (unsigned long)_maxMhz,
+                      lightSleepSupported() ? "yes" : "no (needs tickless idle)");
+#else
+        applyClock();
+        Serial.printf("[Power] Loop-driven DFS %lu-%lu MHz; no light sleep (core built without CONFIG_PM_ENABLE)\n",
+                      (unsigned long)MIN_MHZ, (unsigned long)_maxMhz);
+#endif
+    }
+
+    // True when the screen-off state can light-sleep, so PENIRQ edges may be missed
+    bool lightSleepSupported() const {
+#if CONFIG_PM_ENABLE && CONFIG_FREERTOS_USE_TICKLESS_IDLE
+        return _pmConfigured;
+#else
+        return false;
+#endif
+    }
+
+    // Safe from any task; pair every acquire() with a release() (or use Hold)
+    void acquire(PowerLockType type) {
+        portENTER_CRITICAL(&_mux);
+        _held[type]++;
+        accountLocked();
+        portEXIT_CRITICAL(&_mux);
+#if CONFIG_PM_ENABLE
+        if (_locks[type]) esp_pm_lock_acquire(_locks[type]);
+#else
+        if (raisesClock(type) && _loopTask && xTaskGetCurrentTaskHandle() == _loopTask) applyClock();
+#endif
+    }
+
+    void release(PowerLockType type) {
+#if CONFIG_PM_ENABLE
+        if (_locks[type]) esp_pm_lock_release(_locks[type]);
+#endif
+        portENTER_CRITICAL(&_mux);
+        if (_held[type]) _held[type]--;
+        accountLocked();
+        portEXIT_CRITICAL(&_mux);
+    }
+
+    bool cpuLocksHeld() const {
+        portENTER_CRITICAL(&_mux);
+        bool held = _held[POWER_LOCK_SPI] || _held[POWER_LOCK_AUDIO];
+        portEXIT_CRITICAL(&_mux);
+        return held;
+    }
+
+    // Loop task: the screen was blanked or woken. Off lets the radio and the chip sleep.
+    void setScreenOn(bool on) {
+        portENTER_CRITICAL(&_mux);
+        bool changed = _screenOn != on;
+        _screenOn = on;
+        accountLocked();
+        portEXIT_CRITICAL(&_mux);
+        if (!changed) return;
+
+        applyWifiSleep();
+#if CONFIG_PM_ENABLE
+        if (lightSleepSupported() && configurePm(!on)) _lightSleep = !on;
+#endif
+        Serial.printf("[Power] Screen %s: WiFi %s, light sleep %s\n", on ? "on" : "off",
+                      on ? "awake" : "modem sleep", _lightSleep ? "on" : "off");
+        logStats();
+    }
+
+    bool isScreenOn() const { return _screenOn; }
+    bool isLightSleepEnabled() const { return _lightSleep; }
+
+    // Radio power save for the current screen state. Also call when the station link comes
+    // up; the setting is kept across reconnects but this keeps one place deciding it.
+    void applyWifiSleep() {
+        WiFi.setSleep(_screenOn ? WIFI_PS_NONE : WIFI_PS_MIN_MODEM);
+    }
+
+    // Loop task, once per pass: banks state time and, without esp_pm, lowers the clock
+    // once nobody needs it
+    void update() {
+        portENTER_CRITICAL(&_mux);
+        accountLocked();
+        portEXIT_CRITICAL(&_mux);
+#if !CONFIG_PM_ENABLE
+        applyClock();
+#endif
+    }
+
+    // How long loop() may wait for events: a short pace while the screen is on, otherwise
+    // up to the next whole second, when the clock model ticks
+    uint32_t loopWaitMs() const {
+        if (state() != POWER_SLEEP) return LOOP_WAIT_MS;
+        struct timeval tv;
+        gettimeofday(&tv, nullptr);
+        return 1000 - (uint32_t)(tv.tv_usec / 1000);
+    }
+
+    PowerState state() const {
+        portENTER_CRITICAL(&_mux);
+        PowerState s = _state;
+        portEXIT_CRITICAL(&_mux);
+        return s;
+    }
+
+    // Total time in a state since begin(), including the current stretch
+    uint64_t stateUs(PowerState s) const {
+        portENTER_CRITICAL(&_mux);
+        uint64_t us = _stateUs[s];
+        if (s == _state) us += micros() - _sinceUs;
+        portEXIT_CRITICAL(&_mux);
+        return us;
+    }
+
+    void logStats() const {
+        uint64_t us[POWER_STATE_COUNT];
+        uint64_t total = 0;
+        for (uint8_t i = 0; i < POWER_STATE_COUNT; i++) {
+            us[i] = stateUs((PowerState)i);
+            total += us[i];
+        }
+        if (!total) return;
+        Serial.printf("[Power] %lu s: active %.1f%%, idle %.1f%%, sleep %.1f%%\n",
+                      (unsigned long)(total / 1000000), us[POWER_ACTIVE] * 100.0 / total,
+                      us[POWER_IDLE] * 100.0 / total, us[POWER_SLEEP] * 100.0 / total);
+    }
+
+    static const char* stateName(PowerState s) {
+        switch (s) {
+            case POWER_ACTIVE: return "active";
+            case POWER_IDLE: return "idle";
+            case POWER_SLEEP: return "sleep";
+            default: return "unknown";
+        }
+    }
+};
+
+// Exports seconds spent in each power state, one series per state
+class PowerStateMetric : public Metric {
+    const PowerManager& _pm;
+
+public:
+    PowerStateMetric(const PowerManager& pm, const char* name, const char* help)
+        : Metric(name, help, nullptr, COUNTER), _pm(pm) {}
+
+    void render(String& out) const override {
+        for (uint8_t i = 0; i < POWER_STATE_COUNT; i++) {
+            out += name();
+            out += "{state=\"";
+            out += PowerManager::stateName((PowerState)i);
+            out += "\"} ";
+            out += String(_pm.stateUs((PowerState)i) / 1e6, 3);
+            out += '\n';
+        }
+    }
+};
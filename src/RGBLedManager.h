@@ -1,6 +1,19 @@
 #pragma once
 #include <Arduino.h>
+#include <atomic>
+#include <driver/ledc.h>
+#include "LedColor.h"
+#include "PowerManager.h"
 
+// RGB LED animation engine. Animations are keyframe lists (HSV colour + fade time); each
+// keyframe becomes one LEDC hardware fade per channel, so the PWM ramps on its own and
+// the CPU only runs at keyframe boundaries, from update() in loop(). Colours go through
+// the compile-time HSV and lightness tables in LedColor.h.
+//
+// Two layers: a looping base animation (breathing weather tint) and a one-shot overlay
+// (the chime pulse) that plays on top and hands back to the base where it left off.
+// Overall brightness follows the room via setAmbientLight(). While the LED is lit or
+// fading it holds POWER_LOCK_LED: the LEDC PWM stops in light sleep.
 class RGBLedManager {
 private:
     // RGB LED pins for ESP32-2432S028 CYD
@@ -12,137 +25,214 @@ private:
     static const uint8_t LEDC_CHANNEL_RED = 0;
     static const uint8_t LEDC_CHANNEL_GREEN = 1;
     static const uint8_t LEDC_CHANNEL_BLUE = 2;
-    static const uint32_t LEDC_FREQUENCY = 1000;  // 1kHz PWM
-    static const uint8_t LEDC_RESOLUTION = 8;     // 8-bit PWM (0-255)
-    static const uint16_t PWM_MAX = (1 << LEDC_RESOLUTION) - 1;  // 255
+    static const ledc_mode_t LEDC_MODE = LEDC_HIGH_SPEED_MODE;
+    static const ledc_timer_t LEDC_TIMER = LEDC_TIMER_0;
+    static const uint32_t LEDC_FREQUENCY = 5000;  // 5 kHz, above visible flicker
+    static const uint8_t LEDC_RESOLUTION = ledcolor::DUTY_BITS;
 
-    uint16_t _lastBrightness;
+    // A new fade can only start once the previous one on that channel has finished
+    static const uint8_t FADE_GUARD_MS = 2;
 
-    // Rainbow color mapping: 7 colors, each responsible for 1/7th of brightness
-    // Maps brightness (0-4095 ADC) to RGB components
-    struct RGBColor {
-        uint8_t r, g, b;
+    // The LDR divider reads higher in the dark: full level in daylight, dim at night
+    static const uint16_t LEVEL_BRIGHT_MV = 600;
+    static const uint16_t LEVEL_DARK_MV = 2600;
+    static const uint8_t LEVEL_MIN = 24;
+
+    static const uint8_t BREATH_STEPS = 16;        // keyframes per breath
+    static const uint16_t BREATH_STEP_MS = 250;    // 4 s per breath
+    static const uint8_t BREATH_LOW = 40;          // lightness range of a breath
+    static const uint8_t BREATH_HIGH = 150;
+
+public:
+    struct Keyframe {
+        uint8_t hue, sat, val;  // val 0..255 before the ambient level is applied
+        uint16_t ms;            // fade time into this colour
     };
 
-    void setLedColor(uint8_t r, uint8_t g, uint8_t b) {
-        // LED is active LOW - invert the values
-        analogWrite(LED_RED, 255 - r);
-        analogWrite(LED_GREEN, 255 - g);
-        analogWrite(LED_BLUE, 255 - b);
+private:
+    static constexpr uint8_t CHANNELS[3] = {LEDC_CHANNEL_RED, LEDC_CHANNEL_GREEN, LEDC_CHANNEL_BLUE};
+    static constexpr ledcolor::BreathCurve<BREATH_STEPS> BREATH{};
+
+    // Base layer: rebuilt when the weather tint changes
+    Keyframe _base[BREATH_STEPS];
+    uint8_t _baseCount = 0;
+    uint8_t _baseIndex = 0;
+    int16_t _tintCode = -1;  // WMO code of the current tint, -1 for none
+
+    // Overlay: one-shot keyframes played instead of the base
+    static const uint8_t PULSE_FRAMES = 4;
+    Keyframe _pulse[PULSE_FRAMES];
+    uint8_t _pulseIndex = PULSE_FRAMES;  // == PULSE_FRAMES when idle
+    std::atomic<bool> _pulseRequested{false};
+
+    std::atomic<uint8_t> _level{255};  // ambient brightness scale
+    uint16_t _duty[3] = {0, 0, 0};    // what each channel is at (or fading to)
+    uint32_t _frameStartMs = 0;
+    uint32_t _frameMs = 0;
+    bool _ready = false;
+    bool _enabled = true;
+    PowerManager* _power = nullptr;
+    bool _powerHeld = false;
+
+    // Hold the no-light-sleep lock exactly while a channel is lit or a fade is running
+    void updatePowerLock(bool fading) {
+        bool lit = fading || _duty[0] || _duty[1] || _duty[2];
+        if (!_power || lit == _powerHeld) return;
+        if (lit) {
+            _power->acquire(POWER_LOCK_LED);
+        } else {
+            _power->release(POWER_LOCK_LED);
+        }
+        _powerHeld = lit;
+    }
+
+    void setChannel(uint8_t i, uint16_t duty, uint16_t ms) {
+        if (duty == _duty[i]) return;  // nothing to fade; the channel stays idle
+        ledc_channel_t ch = (ledc_channel_t)CHANNELS[i];
+        if (ms == 0) {
+            ledc_set_duty(LEDC_MODE, ch, duty);
+            ledc_update_duty(LEDC_MODE, ch);
+        } else {
+            ledc_set_fade_with_time(LEDC_MODE, ch, duty, ms);
+            ledc_fade_start(LEDC_MODE, ch, LEDC_FADE_NO_WAIT);
+        }
+        _duty[i] = duty;
     }
 
-    // Convert brightness (0-4095) to rainbow color
-    RGBColor brightnessToRainbow(uint16_t brightness) {
-        RGBColor color = {0, 0, 0};
-        
-        // Normalize brightness to 0-1 range
-        float normalized = (float)brightness / 4095.0f;
-        
-        // 7 color bands in rainbow: Red, Orange, Yellow, Green, Cyan, Blue, Magenta
-        // Each band is 1/7th of the spectrum
-        float bandPosition = normalized * 7.0f;  // 0 to 7
-        int band = (int)bandPosition;
-        float bandProgress = bandPosition - band;  // 0 to 1 within the band
-        
-        switch (band) {
-            case 0:  // Red -> Orange (Red=full, Green rises, Blue=0)
-                color.r = 255;
-                color.g = (uint8_t)(255.0f * bandProgress);
-                color.b = 0;
-                break;
-            case 1:  // Orange -> Yellow (Red=full, Green=full, Blue=0)
-                color.r = 255;
-                color.g = 255;
-                color.b = 0;
-                break;
-            case 2:  // Yellow -> Green (Red falls, Green=full, Blue=0)
-                color.r = (uint8_t)(255.0f * (1.0f - bandProgress));
-                color.g = 255;
-                color.b = 0;
-                break;
-            case 3:  // Green -> Cyan (Red=0, Green=full, Blue rises)
-                color.r = 0;
-                color.g = 255;
-                color.b = (uint8_t)(255.0f * bandProgress);
-                break;
-            case 4:  // Cyan -> Blue (Red=0, Green falls, Blue=full)
-                color.r = 0;
-                color.g = (uint8_t)(255.0f * (1.0f - bandProgress));
-                color.b = 255;
-                break;
-            case 5:  // Blue -> Magenta (Red rises, Green=0, Blue=full)
-                color.r = (uint8_t)(255.0f * bandProgress);
-                color.g = 0;
-                color.b = 255;
-                break;
-            case 6:  // Magenta -> Red (Red=full, Green=0, Blue falls)
-                color.r = 255;
-                color.g = 0;
-                color.b = (uint8_t)(255.0f * (1.0f - bandProgress));
-                break;
-            default:  // Beyond range, default to red
-                color.r = 255;
-                color.g = 0;
-                color.b = 0;
+    void startFrame(const Keyframe& k) {
+        uint8_t val = ledcolor::mul8(k.val, _level.load(std::memory_order_relaxed));
+        ledcolor::Duty d = ledcolor::hsvToDuty(k.hue, k.sat, val);
+        setChannel(0, d.r, k.ms);
+        setChannel(1, d.g, k.ms);
+        setChannel(2, d.b, k.ms);
+        _frameStartMs = millis();
+        _frameMs = k.ms;
+    }
+
+    // Breathing in the given tint
+    void buildBreath(uint8_t hue, uint8_t sat) {
+        for (uint8_t i = 0; i < BREATH_STEPS; i++) {
+            uint8_t val = (uint8_t)(BREATH_LOW + ledcolor::mul8(BREATH.data[i], BREATH_HIGH - BREATH_LOW));
+            _base[i] = {hue, sat, val, BREATH_STEP_MS};
         }
-        
-        return color;
+        _baseCount = BREATH_STEPS;
     }
 
-public:
-    RGBLedManager() : _lastBrightness(0xFFFF) {}
+    // Tint per forecast: warm for sun, greys for cloud and fog, blue rain, violet storms
+    static Keyframe weatherTint(uint8_t code) {
+        if (code == 0) return {20, 230, 0, 0};                                              // Clear: amber
+        if (code == 1 || code == 2) return {30, 130, 0, 0};                                 // Partly cloudy: warm white
+        if (code == 3) return {150, 50, 0, 0};                                              // Overcast: grey-blue
+        if (code == 45 || code == 48) return {128, 25, 0, 0};                               // Fog: pale
+        if ((code >= 51 && code <= 67) || (code >= 80 && code <= 82)) return {165, 230, 0, 0};  // Rain: blue
+        if ((code >= 71 && code <= 77) || (code >= 85 && code <= 86)) return {150, 15, 0, 0};   // Snow: cold white
+        if (code >= 95) return {195, 240, 0, 0};                                            // Thunder: violet
+        return {125, 180, 0, 0};                                                            // Wind/other: teal
+    }
 
+public:
     void begin() {
-        // Configure LED pins as outputs
-        pinMode(LED_RED, OUTPUT);
-        pinMode(LED_GREEN, OUTPUT);
-        pinMode(LED_BLUE, OUTPUT);
+        ledc_timer_config_t timer = {};
+        timer.speed_mode = LEDC_MODE;
+        timer.duty_resolution = (ledc_timer_bit_t)LEDC_RESOLUTION;
+        timer.timer_num = LEDC_TIMER;
+        timer.freq_hz = LEDC_FREQUENCY;
+        timer.clk_cfg = LEDC_AUTO_CLK;
+        if (ledc_timer_config(&timer) != ESP_OK) {
+            Serial.println("[LED] LEDC timer setup failed; LED disabled");
+            return;
+        }
+
+        const uint8_t pins[3] = {LED_RED, LED_GREEN, LED_BLUE};
+        for (uint8_t i = 0; i < 3; i++) {
+            ledc_channel_config_t ch = {};
+            ch.gpio_num = pins[i];
+            ch.speed_mode = LEDC_MODE;
+            ch.channel = (ledc_channel_t)CHANNELS[i];
+            ch.timer_sel = LEDC_TIMER;
+            ch.duty = 0;
+            ch.flags.output_invert = 1;  // LED is active LOW
+            ledc_channel_config(&ch);
+        }
+        // Fade-end interrupts let the driver run fades without a task
+        ledc_fade_func_install(0);
+        _ready = true;
+
+        Serial.printf("[LED] LEDC %lu Hz, %u-bit, hardware fades (LED off)\n",
+                      (unsigned long)LEDC_FREQUENCY, LEDC_RESOLUTION);
+    }
+
+    // Called from loop(): starts the next keyframe once the current fade has run out
+    void update() {
+        if (!_ready) return;
+        if (_pulseRequested.exchange(false, std::memory_order_acquire) && _enabled) {
+            // Flash from the current tint and decay back to it
+            Keyframe from = _baseCount ? _base[_baseIndex] : Keyframe{30, 60, 0, 0};
+            _pulse[0] = {36, 90, 255, 30};
+            _pulse[1] = {36, 90, 140, 150};
+            _pulse[2] = {from.hue, from.sat, (uint8_t)((from.val + 140) / 2), 250};
+            _pulse[3] = {from.hue, from.sat, from.val, 300};
+            _pulseIndex = 0;  // a strike during a pulse starts it over
+        }
+
+        if (millis() - _frameStartMs < _frameMs + FADE_GUARD_MS) {
+            updatePowerLock(true);
+            return;
+        }
 
-        // Turn off LED (active LOW - write 255 to turn off)
-        analogWrite(LED_RED, 255);
-        analogWrite(LED_GREEN, 255);
-        analogWrite(LED_BLUE, 255);
+        if (_pulseIndex < PULSE_FRAMES) {
+            startFrame(_pulse[_pulseIndex++]);
+        } else if (_enabled && _baseCount) {
+            startFrame(_base[_baseIndex]);
+            _baseIndex = (_baseIndex + 1) % _baseCount;
+        } else if (_duty[0] || _duty[1] || _duty[2]) {
+            startFrame({0, 0, 0, 500});  // fade out
+        }
+        updatePowerLock(millis() - _frameStartMs < _frameMs + FADE_GUARD_MS);
+    }
+
+    // Lit keyframes hold POWER_LOCK_LED from here on
+    void setPowerManager(PowerManager* power) {
+        _power = power;
+    }
 
-        Serial.println("RGBLedManager initialized (LED off)");
+    // Breathe in a tint for this WMO weather code; cheap to call every loop pass
+    void setWeatherCode(uint8_t code) {
+        if (_tintCode == code) return;
+        _tintCode = code;
+        Keyframe tint = weatherTint(code);
+        buildBreath(tint.hue, tint.sat);
+        _baseIndex %= _baseCount;
     }
 
-    // Update LED color based on brightness level
-    // Called from LightSensorManager whenever brightness changes
-    void updateBrightness(uint16_t brightness) {
-        // Only update if brightness changed significantly (avoid flickering)
-        // Use 50-unit hysteresis to prevent continuous updates
-        if (brightness < _lastBrightness - 50 || brightness > _lastBrightness + 50) {
-            _lastBrightness = brightness;
-            
-            RGBColor color = brightnessToRainbow(brightness);
-            setLedColor(color.r, color.g, color.b);
-
-            // Debug output
-            Serial.printf("RGB Update: brightness=%d -> RGB(%d, %d, %d)\n", brightness, color.r, color.g, color.b);
+    // Safe from any task: flash once (e.g. on a chime strike)
+    void pulse() {
+        _pulseRequested.store(true, std::memory_order_release);
+    }
+
+    // Safe from any task: 5-second light average (mV) from the light sensor. Takes effect
+    // from the next keyframe.
+    void setAmbientLight(uint16_t mv) {
+        uint32_t level;
+        if (mv <= LEVEL_BRIGHT_MV) {
+            level = 255;
+        } else if (mv >= LEVEL_DARK_MV) {
+            level = LEVEL_MIN;
         } else {
-            // Even if not updating due to hysteresis, show the value occasionally
-            static unsigned long lastSerialTime = 0;
-            if (millis() - lastSerialTime > 5000) {  // Print every 5 seconds
-                lastSerialTime = millis();
-                RGBColor color = brightnessToRainbow(brightness);
-                Serial.printf("RGB (no change): brightness=%d -> would be RGB(%d, %d, %d)\n", brightness, color.r, color.g, color.b);
-            }
+            level = 255 - (uint32_t)(mv - LEVEL_BRIGHT_MV) * (255 - LEVEL_MIN) / (LEVEL_DARK_MV - LEVEL_BRIGHT_MV);
         }
+        _level.store((uint8_t)level, std::memory_order_relaxed);
     }
 
-    // Turn off LED
+    // Stop animating and fade out (pulses are ignored until enabled again)
     void off() {
-        // Active LOW - write 255 to turn off
-        analogWrite(LED_RED, 255);
-        analogWrite(LED_GREEN, 255);
-        analogWrite(LED_BLUE, 255);
+        _enabled = false;
+        _pulseIndex = PULSE_FRAMES;
     }
 
-    // Test all colors in sequence
-    void testRainbow() {
-        for (uint16_t i = 0; i <= 4095; i += 256) {
-            updateBrightness(i);
-            delay(100);
-        }
+    void on() {
+        _enabled = true;
     }
+
+    bool isEnabled() const { return _enabled; }
 };
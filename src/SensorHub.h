@@ -0,0 +1,223 @@
+#pragma once
+#include <Arduino.h>
+#include <atomic>
+#include "Metrics.h"
+
+// One task for all polled sensors. Each sensor registers a callback and a period; the hub
+// sleeps until the earliest deadline, runs that callback, and schedules it again. A
+// callback returns how long until it wants to run next:
+//   PERIOD          its registered period (deadlines advance by whole periods, no drift)
+//   IDLE            not until wake() / wakeFromISR() (e.g. touch between pen-downs)
+//   anything else   that many microseconds from now
+// Sensors share one stack and one wake-up per deadline instead of a task each, and every
+// run is timed: run count, busy time, longest run and worst start lateness per sensor,
+// exported at /api/metrics.
+//
+// Register everything with add() before begin(); callbacks run in the hub task and must
+// not block beyond a short bus transaction.
+class SensorHub {
+public:
+    typedef uint32_t (*Callback)(void* ctx);
+
+    static const uint32_t PERIOD = 0;
+    static const uint32_t IDLE = UINT32_MAX;
+    static const uint8_t CAPACITY = 8;
+
+    struct Stats {
+        uint32_t runs;
+        uint64_t busyUs;
+        uint32_t maxRunUs;
+        uint32_t maxLateUs;  // deadline to callback start
+    };
+
+private:
+    struct Sensor {
+        const char* name;
+        char labels[24];  // sensor="<name>" for the metrics
+        Callback callback;
+        void* ctx;
+        uint32_t periodUs;
+        uint32_t deadlineUs;
+        bool scheduled;
+        Stats stats;
+    };
+
+    static const uint32_t STACK_SIZE = 3072;  // replaces 4096 (touch) + 2048 (light)
+    static const UBaseType_t PRIORITY = 2;
+
+    Sensor _sensors[CAPACITY];
+    uint8_t _count = 0;
+    std::atomic<uint32_t> _wakeMask{0};  // set by wake()/wakeFromISR(), consumed by the task
+    TaskHandle_t _task = nullptr;
+    mutable portMUX_TYPE _statsMux = portMUX_INITIALIZER_UNLOCKED;
+
+    static void taskWrapper(void* pvParameters) {
+        static_cast<SensorHub*>(pvParameters)->taskLoop();
+        vTaskDelete(nullptr);
+    }
+
+    // Earliest scheduled sensor, or -1 when all are idle
+    int earliest() const {
+        int best = -1;
+        for (uint8_t i = 0; i < _count; i++) {
+            if (!_sensors[i].scheduled) continue;
+            if (best < 0 || (int32_t)(_sensors[i].deadlineUs - _sensors[best].deadlineUs) < 0) best = i;
+        }
+        return best;
+    }
+
+    void run(Sensor& s, uint32_t startUs) {
+        uint32_t next = s.callback(s.ctx);
+        uint32_t endUs = micros();
+
+        uint32_t late = startUs - s.deadlineUs;
+        uint32_t took = endUs - startUs;
+        portENTER_CRITICAL(&_statsMux);
+        s.stats.runs++;
+        s.stats.busyUs += took;
+        if (took > s.stats.maxRunUs) s.stats.maxRunUs = took;
+        if (late > s.stats.maxLateUs) s.stats.maxLateUs = late;
+        portEXIT_CRITICAL(&_statsMux);
+
+        if (next == IDLE) {
+            s.scheduled = false;
+        } else if (next == PERIOD) {
+            s.deadlineUs += s.periodUs;
+            // Fell a whole period behind: skip the missed runs rather than bunching them
+            if ((int32_t)(endUs - s.deadlineUs) > (int32_t)s.periodUs) s.deadlineUs = endUs + s.periodUs;
+        } else {
+            s.deadlineUs = endUs + next;
+        }
+    }
+
+    void taskLoop() {
+        for (;;) {
+            uint32_t nowUs = micros();
+            uint32_t woken = _wakeMask.exchange(0, std::memory_order_acquire);
+            for (; woken; woken &= woken - 1) {
+                // A sensor that is already scheduled keeps its deadline: touch sampling's
+                // own SPI reads toggle PENIRQ, and those edges must not speed up sampling
+                Sensor& s = _sensors[__builtin_ctz(woken)];
+                if (!s.scheduled) {
+                    s.deadlineUs = nowUs;
+                    s.scheduled = true;
+                }
+            }
+
+            int next = earliest();
+            if (next < 0) {
+                ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+                continue;
+            }
+            int32_t waitUs = (int32_t)(_sensors[next].deadlineUs - nowUs);
+            if (waitUs > 0) {
+                // Tick-granular sleep; a wake() notification ends it early
+                ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS((waitUs + 999) / 1000));
+                continue;
+            }
+            run(_sensors[next], nowUs);
+        }
+    }
+
+public:
+    // Returns the sensor's slot (for wake()), or -1 when full or already running
+    int add(const char* name, uint32_t periodUs, Callback callback, void* ctx) {
+        if (_count >= CAPACITY || _task) return -1;
+        Sensor& s = _sensors[_count];
+        s.name = name;
+        snprintf(s.labels, sizeof(s.labels), "sensor=\"%s\"", name);
+        s.callback = callback;
+        s.ctx = ctx;
+        s.periodUs = periodUs;
+        s.deadlineUs = 0;
+        s.scheduled = true;  // every sensor runs once at start
+        s.stats = {};
+        return _count++;
+    }
+
+    // Start the hub task on core 1 with everything registered so far
+    void begin() {
+        uint32_t now = micros();
+        for (uint8_t i = 0; i < _count; i++) _sensors[i].deadlineUs = now;
+        xTaskCreatePinnedToCore(taskWrapper, "SensorHub", STACK_SIZE, this, PRIORITY, &_task, 1);
+        Serial.printf("[SensorHub] %u sensors on Core 1:", _count);
+        for (uint8_t i = 0; i < _count; i++) {
+            Serial.printf(" %s", _sensors[i].name);
+            if (_sensors[i].periodUs) Serial.printf(" (%lu ms)", (unsigned long)(_sensors[i].periodUs / 1000));
+        }
+        Serial.println();
+    }
+
+    // Run this idle sensor as soon as possible (from any task)
+    void wake(int slot) {
+        if (slot < 0 || !_task) return;
+        _wakeMask.fetch_or(1UL << slot, std::memory_order_release);
+        xTaskNotifyGive(_task);
+    }
+
+    void IRAM_ATTR wakeFromISR(int slot) {
+        if (slot < 0 || !_task) return;
+        _wakeMask.fetch_or(1UL << slot, std::memory_order_release);
+        BaseType_t woken = pdFALSE;
+        vTaskNotifyGiveFromISR(_task, &woken);
+        portYIELD_FROM_ISR(woken);
+    }
+
+    uint8_t count() const { return _count; }
+    const char* name(uint8_t slot) const { return _sensors[slot].name; }
+    const char* labels(uint8_t slot) const { return _sensors[slot].labels; }
+
+    Stats stats(uint8_t slot) const {
+        portENTER_CRITICAL(&_statsMux);
+        Stats copy = _sensors[slot].stats;
+        portEXIT_CRITICAL(&_statsMux);
+        return copy;
+    }
+
+    void logStats() const {
+        for (uint8_t i = 0; i < _count; i++) {
+            Stats s = stats(i);
+            Serial.printf("[SensorHub] %-6s runs %lu, avg %lu us, max %lu us, max late %lu us\n", _sensors[i].name,
+                          (unsigned long)s.runs, (unsigned long)(s.runs ? s.busyUs / s.runs : 0),
+                          (unsigned long)s.maxRunUs, (unsigned long)s.maxLateUs);
+        }
+    }
+
+    // Minimum free stack (bytes) the hub task has ever had
+    uint32_t stackHighWaterMark() const {
+        return _task ? uxTaskGetStackHighWaterMark(_task) : 0;
+    }
+};
+
+// Per-sensor series for /api/metrics: one metric object renders a line per sensor
+class SensorHubMetric : public Metric {
+public:
+    enum Field : uint8_t { RUNS, BUSY_SECONDS, MAX_RUN_SECONDS, MAX_LATE_SECONDS };
+
+private:
+    const SensorHub& _hub;
+    Field _field;
+
+public:
+    SensorHubMetric(const SensorHub& hub, Field field, const char* name, const char* help)
+        : Metric(name, help, nullptr, field == RUNS || field == BUSY_SECONDS ? COUNTER : GAUGE),
+          _hub(hub),
+          _field(field) {}
+
+    void render(String& out) const override {
+        for (uint8_t i = 0; i < _hub.count(); i++) {
+            SensorHub::Stats s = _hub.stats(i);
+            out += name();
+            out += '{';
+            out += _hub.labels(i);
+            out += "} ";
+            switch (_field) {
+                case RUNS: out += String(s.runs); break;
+                case BUSY_SECONDS: out += String(s.busyUs / 1e6, 6); break;
+                case MAX_RUN_SECONDS: out += String(s.maxRunUs / 1e6, 6); break;
+                case MAX_LATE_SECONDS: out += String(s.maxLateUs / 1e6, 6); break;
+            }
+            out += '\n';
+        }
+    }
+};
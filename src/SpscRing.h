@@ -0,0 +1,45 @@
+#pragma once
+#include <atomic>
+#include <stddef.h>
+#include <stdint.h>
+
+// Fixed-size single-producer/single-consumer ring for handing whole structs between two
+// tasks without locks or disabled interrupts. The producer only writes _head and the
+// consumer only writes _tail; an item is copied in before the release-store of _head, so
+// the consumer never sees a half-written entry. Exactly one task may push and one pop.
+template <typename T, size_t N>
+class SpscRing {
+    static_assert(N >= 2 && (N & (N - 1)) == 0, "SpscRing size must be a power of two");
+
+    T _items[N];
+    std::atomic<uint32_t> _head{0};  // next slot to write (free-running)
+    std::atomic<uint32_t> _tail{0};  // next slot to read (free-running)
+
+public:
+    // Producer: false if the ring is full (the item is not queued)
+    bool push(const T& item) {
+        uint32_t head = _head.load(std::memory_order_relaxed);
+        if (head - _tail.load(std::memory_order_acquire) == N) return false;
+        _items[head & (N - 1)] = item;
+        _head.store(head + 1, std::memory_order_release);
+        return true;
+    }
+
+    // Consumer: false if there is nothing to read
+    bool pop(T& item) {
+        uint32_t tail = _tail.load(std::memory_order_relaxed);
+        if (tail == _head.load(std::memory_order_acquire)) return false;
+        item = _items[tail & (N - 1)];
+        _tail.store(tail + 1, std::memory_order_release);
+        return true;
+    }
+
+    // Either side; a snapshot that may be stale by the time it is used
+    bool empty() const {
+        return _head.load(std::memory_order_acquire) == _tail.load(std::memory_order_acquire);
+    }
+    size_t size() const {
+        return _head.load(std::memory_order_acquire) - _tail.load(std::memory_order_acquire);
+    }
+    static constexpr size_t capacity() { return N; }
+};
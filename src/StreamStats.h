@@ -0,0 +1,200 @@
+#pragma once
+#include <stdint.h>
+
+// Constant-cost streaming statistics for periodic sensor readings. Every push() is O(1)
+// (amortised for the min/max window, O(N) with a small fixed N for the median), nothing
+// allocates and there are no platform calls, so the same code runs in host tools.
+
+// Mean over the last N readings from a running sum
+template <typename T, uint8_t N>
+class RunningWindow {
+    static_assert(N > 0, "RunningWindow needs at least one slot");
+
+    T _values[N] = {};
+    uint8_t _next = 0;
+    uint8_t _count = 0;
+    int32_t _sum = 0;
+
+public:
+    void push(T v) {
+        if (_count == N) {
+            _sum -= _values[_next];
+        } else {
+            _count++;
+        }
+        _values[_next] = v;
+        _sum += v;
+        _next = (_next + 1) % N;
+    }
+
+    // Start over with the window full of v
+    void fill(T v) {
+        for (uint8_t i = 0; i < N; i++) _values[i] = v;
+        _next = 0;
+        _count = N;
+        _sum = (int32_t)v * N;
+    }
+
+    T mean() const { return _count ? (T)((_sum + _count / 2) / _count) : 0; }
+    T newest() const { return _values[(_next + N - 1) % N]; }
+    uint8_t count() const { return _count; }
+    bool full() const { return _count == N; }
+};
+
+// Exponential moving average, alpha = 1 / 2^SHIFT, kept with 8 fractional bits
+template <uint8_t SHIFT>
+class Ema {
+    int32_t _state = 0;  // value << 8
+    bool _seeded = false;
+
+public:
+    void push(int32_t v) {
+        if (!_seeded) {
+            seed(v);
+            return;
+        }
+        _state += ((v << 8) - _state) >> SHIFT;
+    }
+
+    void seed(int32_t v) {
+        _state = v << 8;
+        _seeded = true;
+    }
+
+    int32_t value() const { return (_state + 128) >> 8; }
+    bool seeded() const { return _seeded; }
+};
+
+// Minimum and maximum of the last N readings (monotonic queues: each reading enters and
+// leaves each queue at most once)
+template <typename T, uint8_t N>
+class WindowMinMax {
+    struct Entry {
+        T value;
+        uint32_t seq;
+    };
+
+    Entry _min[N], _max[N];
+    uint8_t _minHead = 0, _minCount = 0;
+    uint8_t _maxHead = 0, _maxCount = 0;
+    uint32_t _seq = 0;
+
+    template <typename Better>
+    static void pushQueue(Entry* q, uint8_t& head, uint8_t& count, T v, uint32_t seq, Better better) {
+        // The oldest leaves from the front once it is out of the window
+        if (count > 0 && seq - q[head].seq >= N) {
+            head = (head + 1) % N;
+            count--;
+        }
+        // Entries that can no longer be the extreme leave from the back
+        while (count > 0 && !better(q[(head + count - 1) % N].value, v)) count--;
+        q[(head + count) % N] = {v, seq};
+        count++;
+    }
+
+public:
+    void push(T v) {
+        _seq++;
+        pushQueue(_min, _minHead, _minCount, v, _seq, [](T a, T b) { return a < b; });
+        pushQueue(_max, _maxHead, _maxCount, v, _seq, [](T a, T b) { return a > b; });
+    }
+
+    T min() const { return _minCount ? _min[_minHead].value : 0; }
+    T max() const { return _maxCount ? _max[_maxHead].value : 0; }
+};
+
+// Median of the last N readings (N odd and small): a sorted copy is kept alongside the
+// ring, so one push is a removal and an insertion in N elements
+template <typename T, uint8_t N>
+class MedianWindow {
+    static_assert(N % 2 == 1, "MedianWindow size must be odd");
+
+    T _ring[N];
+    T _sorted[N];
+    uint8_t _next = 0;
+    uint8_t _count = 0;
+
+public:
+    void push(T v) {
+        uint8_t n = _count;
+        if (_count == N) {
+            // Remove the value leaving the window from the sorted copy
+            T old = _ring[_next];
+            uint8_t i = 0;
+            while (_sorted[i] != old) i++;
+            for (; i + 1 < N; i++) _sorted[i] = _sorted[i + 1];
+            n = N - 1;
+        } else {
+            _count++;
+        }
+        _ring[_next] = v;
+        _next = (_next + 1) % N;
+
+        uint8_t j = n;
+        while (j > 0 && _sorted[j - 1] > v) {
+            _sorted[j] = _sorted[j - 1];
+            j--;
+        }
+        _sorted[j] = v;
+    }
+
+    // Median of what has been seen so far (lower middle while the window fills)
+    T median() const { return _count ? _sorted[(_count - 1) / 2] : 0; }
+    uint8_t count() const { return _count; }
+};
+
+// Slowly adapting baseline with a hysteresis detector for excursions away from it. The
+// baseline follows the input through a very slow EMA, so gradual changes (daylight, a
+// lamp left on) move it instead of triggering; a fast, sustained excursion beyond
+// ENTER_PCT of the baseline for ENTER_SAMPLES readings in a row triggers once, and it
+// stays triggered until the input comes back past EXIT_PCT. The baseline is frozen while
+// an excursion is building or active so the event itself is never learned.
+template <uint8_t ADAPT_SHIFT, uint8_t ENTER_PCT, uint8_t EXIT_PCT, uint8_t ENTER_SAMPLES>
+class BaselineDetector {
+    static_assert(ENTER_PCT < EXIT_PCT && EXIT_PCT < 100, "detects drops below the baseline");
+
+    Ema<ADAPT_SHIFT> _baseline;
+    uint8_t _pending = 0;
+    bool _active = false;
+
+public:
+    enum Event : uint8_t { NONE, ENTERED, EXITED };
+
+    void seed(int32_t baseline) {
+        _baseline.seed(baseline);
+        _pending = 0;
+        _active = false;
+    }
+
+    Event update(int32_t v) {
+        if (_active) {
+            if (v > exitThreshold()) {
+                _active = false;
+                return EXITED;
+            }
+            return NONE;
+        }
+        if (v < enterThreshold()) {
+            if (++_pending >= ENTER_SAMPLES) {
+                _pending = 0;
+                _active = true;
+                return ENTERED;
+            }
+            return NONE;
+        }
+        _pending = 0;
+        _baseline.push(v);
+        return NONE;
+    }
+
+    // Allow a new trigger while the input is still beyond the threshold
+    void rearm() {
+        _active = false;
+        _pending = 0;
+    }
+
+    int32_t baseline() const { return _baseline.value(); }
+    int32_t enterThreshold() const { return baseline() * ENTER_PCT / 100; }
+    int32_t exitThreshold() const { return baseline() * EXIT_PCT / 100; }
+    bool active() const { return _active; }
+};
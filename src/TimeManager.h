@@ -2,7 +2,9 @@
 #include <time.h>
 #include <WiFiClientSecure.h>
 #include <HTTPClient.h>
-#include <Preferences.h>
+#include "ConfigStore.h"
+#include "EventBus.h"
+#include "Metrics.h"
 
 // Forward declaration
 class DisplayManager;
@@ -16,7 +18,12 @@ class TimeManager {
     bool _synced = false;
     String _usedNtpServer;
     unsigned long _lastAttemptMs = 0;
+    bool _syncPending = false;   // configTime() issued, SNTP answer not seen yet
+    uint32_t _syncStartUs = 0;
+    static const unsigned long SYNC_TIMEOUT_MS = 5000;  // give up on an attempt after this
+    static const unsigned long SYNC_RETRY_MS = 10000;   // attempt start to the next attempt
     size_t _serverIndex = 0; // rotates through NTP servers
+    bool _paused = false;    // set while offline; NTP retries are skipped
 
     // Timezone metadata
     String _tzName = "Europe/London";
@@ -25,22 +32,35 @@ class TimeManager {
     long _stdOffsetSec = 0;
     long _dstOffsetSec = 3600;
     bool _tzLoaded = false;
+    // POSIX TZ with the zone's own DST rule, built from timeapi.io's DST interval. Empty when
+    // the zone has no DST or the interval was missing; configTime()'s offsets apply then.
+    String _posixTz;
 
-    // Storage to read current location for timezone bootstrap
-    Preferences _locPrefs;
+    // Current location for timezone bootstrap
+    ConfigStore* _config = nullptr;
+    EventBus* _bus = nullptr;  // EVENT_TIME_SYNCED
 
 public:
     TimeManager(long offset = 0, int daylight = 3600) 
         : _gmtOffset_sec(offset), _daylightOffset_sec(daylight), _stdOffsetSec(offset), _dstOffsetSec(daylight) {}
 
+    void setConfigStore(ConfigStore* config) {
+        _config = config;
+    }
+
+    void setEventBus(EventBus* bus) {
+        _bus = bus;
+    }
+
     void begin(DisplayManager* display = nullptr) {
         // Try to load timezone based on stored location (if any)
-        bootstrapTimezoneFromPrefs(display);
-        // Kick off initial sync attempt but do not block indefinitely
+        bootstrapTimezoneFromConfig(display);
+        // Kick off the initial sync; maybeEnsureSynced() sees it complete
         trySyncOnce(display);
     }
 
-    // Attempt a single sync using a rotating trio of servers; non-blocking beyond short wait
+    // Start a sync using a rotating trio of servers. Never waits: SNTP runs in the
+    // background and checkSync() picks up the answer. True if the clock is already set.
     bool trySyncOnce(DisplayManager* display = nullptr) {
         // Choose three servers in a round-robin fashion
         auto serverByIndex = [](size_t idx) -> const char* {
@@ -59,36 +79,56 @@ public:
         _serverIndex = (_serverIndex + 1) % NTP_COUNT; // advance for next round
 
         if (display) display->showStatus(String("Syncing NTP: ") + s1 + ", " + s2 + ", " + s3);
-        Serial.printf("Configuring NTP: %s, %s, %s (offset=%ld, dst=%d)\n", s1, s2, s3, _gmtOffset_sec, _daylightOffset_sec);
-        configTime(_gmtOffset_sec, _daylightOffset_sec, s1, s2, s3);
+        if (_posixTz.length()) {
+            // The zone's own rule: configTime() would switch on US dates for every zone
+            Serial.printf("Configuring NTP: %s, %s, %s (TZ=%s)\n", s1, s2, s3, _posixTz.c_str());
+            configTzTime(_posixTz.c_str(), s1, s2, s3);
+        } else {
+            Serial.printf("Configuring NTP: %s, %s, %s (offset=%ld, dst=%d)\n", s1, s2, s3, _gmtOffset_sec, _daylightOffset_sec);
+            configTime(_gmtOffset_sec, _daylightOffset_sec, s1, s2, s3);
+        }
         _usedNtpServer = String(s1);
         _lastAttemptMs = millis();
+        _syncStartUs = micros();
+        _syncPending = true;
+        return checkSync(display);
+    }
 
-        // Poll briefly for success (up to ~5 seconds)
+    // Outcome of the pending attempt, if there is one yet: true once the clock is set,
+    // false while waiting or after SYNC_TIMEOUT_MS without an answer
+    bool checkSync(DisplayManager* display = nullptr) {
+        if (!_syncPending) return _synced;
         time_t now = time(nullptr);
-        int attempts = 0;
-        while (now < 24 * 3600 && attempts < 50) { // 50 * 100ms = 5s
-            delay(100);
-            now = time(nullptr);
-            attempts++;
-        }
         if (now > 24 * 3600) {
+            _syncPending = false;
             _synced = true;
+            metricNtpSyncDuration.observe(micros() - _syncStartUs);
+            metricNtpSyncOk.inc();
             Serial.println("Time synchronized from NTP");
             if (display) display->showStatus(String("Time synced from ") + _usedNtpServer + " (" + _tzName + ")");
+            if (_bus) _bus->publish(Event::timeSynced((uint32_t)now));
             return true;
         }
-        Serial.println("NTP attempt failed, will retry");
-        if (display) display->showStatus(String("NTP attempt failed on ") + _usedNtpServer);
+        if (millis() - _lastAttemptMs >= SYNC_TIMEOUT_MS) {
+            _syncPending = false;
+            metricNtpSyncDuration.observe(micros() - _syncStartUs);
+            metricNtpSyncFailed.inc();
+            Serial.println("NTP attempt failed, will retry");
+            if (display) display->showStatus(String("NTP attempt failed on ") + _usedNtpServer);
+        }
         return false;
     }
 
-    // Continuously retry NTP until an update is obtained; call from loop()
+    // Pause/resume NTP retries on connectivity transitions
+    void setPaused(bool paused) { _paused = paused; }
+
+    // Continuously retry NTP until an update is obtained; call from loop(). Only checks
+    // time() on most passes, so it never holds the loop up.
     void maybeEnsureSynced(DisplayManager* display = nullptr) {
-        if (_synced) return;
-        unsigned long nowMs = millis();
-        // Retry every 10 seconds while unsynced
-        if (nowMs - _lastAttemptMs >= 10000) {
+        if (_synced || _paused) return;
+        if (_syncPending) {
+            checkSync(display);
+        } else if (millis() - _lastAttemptMs >= SYNC_RETRY_MS) {
             trySyncOnce(display);
         }
     }
@@ -163,6 +203,8 @@ public:
         long dstOffset = extractIntField("\"dstOffsetToUtc\":{\"seconds\":");
         bool hasDst = extractBoolField("\"hasDayLightSaving\":");
         bool dstActive = extractBoolField("\"isDayLightSavingActive\":");
+        String dstStart = extractStringField("\"dstStart\":");
+        String dstEnd = extractStringField("\"dstEnd\":");
 
         if (tzName.length() == 0) tzName = _tzName; // fallback
         _tzName = tzName;
@@ -173,8 +215,10 @@ public:
         _gmtOffset_sec = _stdOffsetSec;
         _daylightOffset_sec = (_hasDst && _dstActive) ? (int)_dstOffsetSec : 0;
         _tzLoaded = true;
+        _posixTz = _hasDst ? posixTz(_stdOffsetSec, _dstOffsetSec, dstStart, dstEnd) : String("");
 
-        Serial.printf("[TimeManager] TZ=%s std=%ld dst=%ld active=%s\n", _tzName.c_str(), _stdOffsetSec, _dstOffsetSec, _dstActive ? "yes" : "no");
+        Serial.printf("[TimeManager] TZ=%s std=%ld dst=%ld active=%s rule=%s\n", _tzName.c_str(), _stdOffsetSec,
+                      _dstOffsetSec, _dstActive ? "yes" : "no", _posixTz.length() ? _posixTz.c_str() : "none");
         if (display) display->showStatus(String("TZ: ") + _tzName + " (dst " + (_dstActive ? "on" : "off") + ")");
 
         // Reconfigure SNTP with new offsets
@@ -183,21 +227,78 @@ public:
         return true;
     }
 
+    // Days since 1970-01-01 for a proleptic Gregorian date (month 1-12)
+    static long daysFromCivil(int y, int m, int d) {
+        y -= m <= 2;
+        long era = (y >= 0 ? y : y - 399) / 400;
+        long yoe = y - era * 400;
+        long doy = (153 * (m + (m > 2 ? -3 : 9)) + 2) / 5 + d - 1;
+        long doe = yoe * 365 + yoe / 4 - yoe / 100 + doy;
+        return era * 146097 + doe - 719468;
+    }
+
+    // POSIX "UTC" offset: hours west of Greenwich, minutes only when needed
+    static String posixOffset(long utcOffsetSec) {
+        long west = -utcOffsetSec;
+        String out = west < 0 ? "-" : "";
+        west = labs(west);
+        out += String(west / 3600);
+        if (west % 3600) {
+            long mins = (west % 3600) / 60;
+            out += mins < 10 ? ":0" : ":";
+            out += String(mins);
+        }
+        return out;
+    }
+
+    // One transition ("2026-10-25T01:00:00Z") as a "Mm.w.d/h" rule in the local time it
+    // happens in. Week 5 means the last such weekday, so the rule holds in later years too.
+    static String posixRule(const String& isoUtc, long localOffsetSec) {
+        int y, mo, d, h, mi;
+        if (sscanf(isoUtc.c_str(), "%d-%d-%dT%d:%d", &y, &mo, &d, &h, &mi) != 5) return String("");
+        long long epoch = (long long)daysFromCivil(y, mo, d) * 86400 + h * 3600L + mi * 60L + localOffsetSec;
+        time_t t = (time_t)epoch;
+        struct tm local;
+        gmtime_r(&t, &local);
+        int year = local.tm_year + 1900, month = local.tm_mon + 1;
+        long monthDays = daysFromCivil(month == 12 ? year + 1 : year, month == 12 ? 1 : month + 1, 1) -
+                         daysFromCivil(year, month, 1);
+        int week = local.tm_mday + 7 > monthDays ? 5 : (local.tm_mday - 1) / 7 + 1;
+        String rule = "M" + String(month) + "." + String(week) + "." + String(local.tm_wday) + "/" +
+                      String(local.tm_hour);
+        if (local.tm_min) rule += (local.tm_min < 10 ? ":0" : ":") + String(local.tm_min);
+        return rule;
+    }
+
+    // Standard and DST offsets with the rule taken from one DST interval; "" if unusable
+    static String posixTz(long stdOffsetSec, long dstOffsetSec, const String& dstStart, const String& dstEnd) {
+        if (dstOffsetSec == stdOffsetSec) return String("");
+        String start = posixRule(dstStart, stdOffsetSec);  // clocks go forward from standard time
+        String end = posixRule(dstEnd, dstOffsetSec);      // and back from daylight time
+        if (!start.length() || !end.length()) return String("");
+        return String("UTC") + posixOffset(stdOffsetSec) + "DST" + posixOffset(dstOffsetSec) + "," + start + "," + end;
+    }
+
     // Try to load stored location to bootstrap timezone
-    void bootstrapTimezoneFromPrefs(DisplayManager* display = nullptr) {
-        _locPrefs.begin("location", true);
-        bool hasLat = _locPrefs.isKey("lat");
-        bool hasLon = _locPrefs.isKey("lon");
-        float lat = hasLat ? _locPrefs.getFloat("lat", 51.5074f) : 51.5074f;
-        float lon = hasLon ? _locPrefs.getFloat("lon", -0.1278f) : -0.1278f;
-        _locPrefs.end();
+    void bootstrapTimezoneFromConfig(DisplayManager* display = nullptr) {
+        bool hasCoords = _config && _config->location().hasCoords;
+        float lat = hasCoords ? _config->location().lat : 51.5074f;
+        float lon = hasCoords ? _config->location().lon : -0.1278f;
         // Attempt timezone fetch; ignore failure silently
         refreshTimezone(lat, lon, display);
     }
 
+    // Local time without waiting (getLocalTime() would poll for up to 5 s while the clock
+    // is still unset); false until SNTP has set it
+    static bool localNow(struct tm& timeinfo) {
+        time_t now = time(nullptr);
+        localtime_r(&now, &timeinfo);
+        return timeinfo.tm_year > (2016 - 1900);
+    }
+
     String getFormattedTime() {
         struct tm timeinfo;
-        if(!getLocalTime(&timeinfo)) return "--:--:--";
+        if (!localNow(timeinfo)) return "--:--:--";
         char timeStringBuff[10];
         strftime(timeStringBuff, sizeof(timeStringBuff), "%H:%M:%S", &timeinfo);
         return String(timeStringBuff);
@@ -205,7 +306,7 @@ public:
     
     String getFormattedDate() {
         struct tm timeinfo;
-        if(!getLocalTime(&timeinfo)) return "";
+        if (!localNow(timeinfo)) return "";
         const char* dayNames[] = {"Sunday", "Monday", "Tuesday", "Wednesday", "Thursday", "Friday", "Saturday"};
         const char* monthNames[] = {"January", "February", "March", "April", "May", "June", 
                                      "July", "August", "September", "October", "November", "December"};
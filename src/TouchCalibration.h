@@ -0,0 +1,79 @@
+#pragma once
+#include <stdint.h>
+
+// Raw-to-screen affine transform in Q16 fixed point:
+//   x = (a*rawX + b*rawY + c) >> 16
+//   y = (d*rawX + e*rawY + f) >> 16
+// Three taps on known targets determine all six terms, which absorbs offset, scale,
+// rotation and skew of each individual panel (the shared TS_MIN/MAX constants only
+// handle the first two, and only for an average unit).
+struct TouchMatrix {
+    int32_t a, b, c;
+    int32_t d, e, f;
+};
+
+namespace TouchCalibration {
+
+static constexpr int32_t ONE = 1 << 16;
+static constexpr uint16_t SCREEN_W = 320;
+static constexpr uint16_t SCREEN_H = 240;
+
+// Equivalent of map(raw, min, max, 0, size) on both axes
+inline TouchMatrix fromRange(uint16_t minX, uint16_t maxX, uint16_t minY, uint16_t maxY) {
+    TouchMatrix m = {};
+    m.a = (int32_t)((int64_t)SCREEN_W * ONE / (maxX - minX));
+    m.c = -m.a * minX;
+    m.e = (int32_t)((int64_t)SCREEN_H * ONE / (maxY - minY));
+    m.f = -m.e * minY;
+    return m;
+}
+
+inline int32_t applyAxis(int32_t k1, int32_t k2, int32_t k3, uint16_t rawX, uint16_t rawY) {
+    return (int32_t)(((int64_t)k1 * rawX + (int64_t)k2 * rawY + k3 + ONE / 2) >> 16);
+}
+
+// Screen position, clamped to the panel
+inline void apply(const TouchMatrix& m, uint16_t rawX, uint16_t rawY, uint16_t& x, uint16_t& y) {
+    int32_t sx = applyAxis(m.a, m.b, m.c, rawX, rawY);
+    int32_t sy = applyAxis(m.d, m.e, m.f, rawX, rawY);
+    x = (uint16_t)(sx < 0 ? 0 : sx >= SCREEN_W ? SCREEN_W - 1 : sx);
+    y = (uint16_t)(sy < 0 ? 0 : sy >= SCREEN_H ? SCREEN_H - 1 : sy);
+}
+
+// Solve for the transform taking raw[i] to screen[i] (three non-collinear points).
+// Returns false for a degenerate or implausible result, e.g. two taps on the same spot
+// or a scale no XPT2046 panel produces.
+inline bool solve(const uint16_t rawX[3], const uint16_t rawY[3],
+                  const uint16_t screenX[3], const uint16_t screenY[3], TouchMatrix& out) {
+    double x0 = rawX[0], x1 = rawX[1], x2 = rawX[2];
+    double y0 = rawY[0], y1 = rawY[1], y2 = rawY[2];
+    double det = (x0 - x2) * (y1 - y2) - (x1 - x2) * (y0 - y2);
+    // Targets span ~250x190 px, i.e. ~2700x2800 raw; anything this small is not a real spread
+    if (det > -100000.0 && det < 100000.0) return false;
+
+    double coef[2][3];
+    const uint16_t* screen[2] = {screenX, screenY};
+    for (int axis = 0; axis < 2; axis++) {
+        double s0 = screen[axis][0], s1 = screen[axis][1], s2 = screen[axis][2];
+        double k1 = ((s0 - s2) * (y1 - y2) - (s1 - s2) * (y0 - y2)) / det;
+        double k2 = ((x0 - x2) * (s1 - s2) - (x1 - x2) * (s0 - s2)) / det;
+        double k3 = s0 - k1 * x0 - k2 * y0;
+        // 12-bit ADC over 320/240 px: roughly 0.06-0.1 px per count on the dominant term
+        double scale = k1 * k1 + k2 * k2;
+        if (scale < 0.03 * 0.03 || scale > 0.25 * 0.25) return false;
+        coef[axis][0] = k1;
+        coef[axis][1] = k2;
+        coef[axis][2] = k3;
+    }
+
+    auto q16 = [](double v) { return (int32_t)(v * ONE + (v < 0 ? -0.5 : 0.5)); };
+    out.a = q16(coef[0][0]);
+    out.b = q16(coef[0][1]);
+    out.c = q16(coef[0][2]);
+    out.d = q16(coef[1][0]);
+    out.e = q16(coef[1][1]);
+    out.f = q16(coef[1][2]);
+    return true;
+}
+
+}  // namespace TouchCalibration
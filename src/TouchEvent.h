@@ -0,0 +1,25 @@
+#pragma once
+#include <stdint.h>
+
+// Raw pen events from touch sampling (logical display coordinates)
+enum TouchEventType : uint8_t {
+    TOUCH_PRESS = 0,    // pen down (timestamp = IRQ edge)
+    TOUCH_MOVE = 1,     // pen moved while down
+    TOUCH_RELEASE = 2   // pen up (position = last sample)
+};
+
+struct TouchEvent {
+    TouchEventType type;
+    uint16_t x;
+    uint16_t y;
+    uint32_t timestampUs;  // micros()
+};
+
+// Filtered event as touch sampling queues it; calibration is applied in loop(), so the
+// matrix is only ever touched by one core
+struct RawTouch {
+    TouchEventType type;
+    uint16_t x, y;         // raw ADC units
+    uint32_t timestampUs;  // IRQ edge (press) or sample time (move/release)
+    uint32_t queuedUs;     // when it went into the queue
+};
@@ -0,0 +1,91 @@
+#pragma once
+#include <stdint.h>
+
+// Conditions raw XPT2046 readings before they become touch events. Each reading goes through
+// a pressure gate, a sliding median (drops the single-sample spikes the resistive panel
+// produces while the pen settles or lifts) and a first-order IIR smoother (removes the
+// remaining +/-1-2 px jitter). Works in raw ADC units; calibration is applied afterwards.
+// No platform calls, so it behaves identically in host builds.
+class TouchFilter {
+public:
+    static constexpr uint8_t MEDIAN_TAPS = 5;     // 25 ms window at 200 Hz
+    static constexpr uint8_t IIR_SHIFT = 2;       // alpha = 1/4
+    static constexpr uint8_t SETTLE_SAMPLES = 1;  // readings dropped right after pen-down
+    // Pressure gate with hysteresis: a press needs a firm reading, and is held until the
+    // reading falls below the lower threshold (the library reports 0 below 300)
+    static constexpr int16_t Z_PRESS = 400;
+    static constexpr int16_t Z_RELEASE = 300;
+
+private:
+    static constexpr uint8_t FRAC_BITS = 4;  // IIR state keeps 4 fractional bits
+
+    int16_t _xs[MEDIAN_TAPS];
+    int16_t _ys[MEDIAN_TAPS];
+    uint8_t _count = 0;   // readings in the window (saturates at MEDIAN_TAPS)
+    uint8_t _next = 0;    // slot the next reading overwrites
+    uint8_t _settle = 0;
+    bool _pressed = false;
+    int32_t _sx = 0, _sy = 0;  // IIR state, raw << FRAC_BITS
+    uint32_t _gated = 0;       // readings refused by the pressure gate
+
+    // Median of the filled part of the window (insertion sort of at most 5 values)
+    int16_t median(const int16_t* values) const {
+        int16_t sorted[MEDIAN_TAPS];
+        for (uint8_t i = 0; i < _count; i++) {
+            int16_t v = values[i];
+            uint8_t j = i;
+            while (j > 0 && sorted[j - 1] > v) {
+                sorted[j] = sorted[j - 1];
+                j--;
+            }
+            sorted[j] = v;
+        }
+        return sorted[_count / 2];
+    }
+
+public:
+    // Start of a new touch: forget the previous stroke
+    void reset() {
+        _count = 0;
+        _next = 0;
+        _settle = SETTLE_SAMPLES;
+        _pressed = false;
+    }
+
+    // Feed one reading. Returns true with the filtered raw position once the touch is firm
+    // enough; false while it is settling or too light (the caller treats that as pen-up
+    // once a press has started).
+    bool add(int16_t x, int16_t y, int16_t z, uint16_t& outX, uint16_t& outY) {
+        if (z < (_pressed ? Z_RELEASE : Z_PRESS)) {
+            _gated++;
+            return false;
+        }
+        if (_settle > 0) {
+            _settle--;
+            return false;
+        }
+
+        _xs[_next] = x;
+        _ys[_next] = y;
+        _next = (_next + 1) % MEDIAN_TAPS;
+        if (_count < MEDIAN_TAPS) _count++;
+
+        int32_t mx = (int32_t)median(_xs) << FRAC_BITS;
+        int32_t my = (int32_t)median(_ys) << FRAC_BITS;
+        if (!_pressed) {
+            // Seed the smoother so the press lands where the pen is, not drifting in from 0
+            _sx = mx;
+            _sy = my;
+            _pressed = true;
+        } else {
+            _sx += (mx - _sx) >> IIR_SHIFT;
+            _sy += (my - _sy) >> IIR_SHIFT;
+        }
+        outX = (uint16_t)((_sx + (1 << (FRAC_BITS - 1))) >> FRAC_BITS);
+        outY = (uint16_t)((_sy + (1 << (FRAC_BITS - 1))) >> FRAC_BITS);
+        return true;
+    }
+
+    bool isPressed() const { return _pressed; }
+    uint32_t gatedCount() const { return _gated; }
+};
@@ -1,36 +1,43 @@
 #pragma once
 #include <Arduino.h>
+#include <atomic>
 #include <TFT_eSPI.h>
 #include <XPT2046_Touchscreen.h>
 #include "ChimeManager.h"
+#include "ConfigStore.h"
+#include "EventBus.h"
+#include "GestureEngine.h"
+#include "Metrics.h"
+#include "SensorHub.h"
+#include "TouchCalibration.h"
+#include "TouchEvent.h"
+#include "TouchRecorder.h"
+#include "TouchRegistry.h"
+#include "TouchSampler.h"
 
 // Forward declarations
 class DisplayManager;
 
-// Touch event structure for inter-core communication
-struct TouchEvent {
-    uint16_t x;
-    uint16_t y;
-    uint32_t timestamp;
-};
-
-// Touch area definitions (in logical coordinates after calibration)
-enum TouchAreaId {
-    TOUCH_TITLE = 0,     // Header text area
-    TOUCH_VERSION = 1,   // Top right corner (version label)
+// Touch area identifiers (several regions may share one, e.g. the forecast slots)
+enum TouchAreaId : uint8_t {
+    TOUCH_TITLE = 0,       // Header text area
+    TOUCH_VERSION = 1,     // Top right corner (version label)
     TOUCH_DEBUG_CHIME = 2, // Top-left corner long-press for chime debug
-    TOUCH_AREA_MAX = 3   // Keep this in sync with area count
-};
-
-struct TouchArea {
-    uint16_t x1, y1;     // Top-left
-    uint16_t x2, y2;     // Bottom-right
-    const char* label;   // Debug label
-    TouchAreaId id;      // Area identifier
+    TOUCH_CLOCK = 3,       // Main time digits
+    TOUCH_DATE = 4,        // Date line
+    TOUCH_FORECAST = 5,    // One of the six forecast slots
+    TOUCH_STATUS = 6       // Status bar at the bottom
 };
 
 class TouchManager {
 private:
+    // Timestamps of the event behind a gesture, for touch-to-photon tracing
+    struct LatencyTrace {
+        uint32_t sourceUs;    // IRQ edge or sample
+        uint32_t queuedUs;    // handed to the queue
+        uint32_t dequeuedUs;  // picked up by loop()
+    };
+
     // Hardware setup for XPT2046
     static const uint8_t XPT2046_CLK = 25;
     static const uint8_t XPT2046_MOSI = 32;
@@ -38,101 +45,120 @@ private:
     static const uint8_t XPT2046_CS = 33;
     static const uint8_t XPT2046_IRQ = 36;
 
-    // Raw touch calibration values (from reference examples for CYD)
+    // Raw touch range (from reference examples for CYD); used until a unit is calibrated
     static const uint16_t TS_MINX = 200;
     static const uint16_t TS_MAXX = 3700;
     static const uint16_t TS_MINY = 240;
     static const uint16_t TS_MAXY = 3800;
 
+    // Sampling while the pen is down; nothing runs between touches
+    static const uint32_t SAMPLE_INTERVAL_US = 5000;  // 200 Hz burst
+    // Pen checks while light sleep may swallow the PENIRQ edge (setPenPolling)
+    static const uint32_t PEN_POLL_US = 100000;
+
+    // Calibration: three targets spread over the panel, then a fourth to verify the result
+    static const uint8_t CAL_POINTS = 3;
+    static constexpr uint16_t CAL_TARGET_X[CAL_POINTS + 1] = {32, 288, 160, 80};
+    static constexpr uint16_t CAL_TARGET_Y[CAL_POINTS + 1] = {32, 120, 208, 180};
+    static const uint16_t CAL_VERIFY_TOLERANCE_PX = 8;
+    static const uint32_t CAL_TIMEOUT_MS = 30000;  // abandon (keeping the old matrix) if idle
+
     SPIClass* _spi;
     XPT2046_Touchscreen* _ts;
     QueueHandle_t _eventQueue;
-    TaskHandle_t _touchTaskHandle;
+    SensorHub* _hub;
+    int _hubSlot;
     DisplayManager* _display;
     ChimeManager* _chime;
+    ConfigStore* _config;
+    EventBus* _bus;
     bool _debugMode;
-    uint8_t _versionPressCount;
-    unsigned long _lastVersionPressTime;
-    uint8_t _titlePressCount;
-    unsigned long _lastTitlePressTime;
     bool _titleIsCopyright;
-    bool _pressActive;
-    TouchAreaId _pressArea;
-    unsigned long _pressStartMs;
-
-    // Touch areas configuration (can be extended)
-    static const int AREA_COUNT = TOUCH_AREA_MAX;
-    TouchArea _touchAreas[AREA_COUNT] = {
-        { // Title area roughly covering "TouchClock" text in header
-            .x1 = 80, .y1 = 4,
-            .x2 = 240, .y2 = 32,
-            .label = "Title",
-            .id = TOUCH_TITLE
-        },
-        { // Version label area (top-right tiny text)
-            .x1 = 285, .y1 = 20,
-            .x2 = 320, .y2 = 35,
-            .label = "Version",
-            .id = TOUCH_VERSION
-        },
-        { // Top-left corner for debug chime (press-and-hold 2s)
-            .x1 = 0, .y1 = 0,
-            .x2 = 70, .y2 = 40,
-            .label = "ChimeDebug",
-            .id = TOUCH_DEBUG_CHIME
-        }
-    };
-
-    // Static wrapper for FreeRTOS task
-    static void touchTaskWrapper(void* pvParameters) {
-        TouchManager* pThis = static_cast<TouchManager*>(pvParameters);
-        pThis->touchTaskLoop();
-        vTaskDelete(nullptr);
+    GestureEngine _gestures;  // fed and polled from loop()
+    volatile uint32_t _irqUs;  // time of the last pen-down edge (ISR)
+    TouchSampler _sampler;     // sensor hub only
+    bool _inBurst;             // sensor hub only: pen-down burst in progress
+    std::atomic<bool> _penPolling{false};
+    TouchRecorder _recorder;   // fed by the sensor hub, written out from loop()
+    TouchMatrix _matrix;       // loop() only
+
+    // Calibration flow state (loop() only); _calStep < 0 when not calibrating
+    int8_t _calStep;
+    uint16_t _calRawX[CAL_POINTS + 1];
+    uint16_t _calRawY[CAL_POINTS + 1];
+    TouchMatrix _calCandidate;
+    unsigned long _calLastMs;
+    bool _redrawNeeded;
+
+    // Touch areas (logical coordinates after calibration); populated in registerDefaultAreas()
+    TouchRegistry _areas;
+
+    // PENIRQ falling edge: note the time and wake touch sampling in the sensor hub
+    static void IRAM_ATTR penIrqHandler(void* arg) {
+        TouchManager* self = static_cast<TouchManager*>(arg);
+        self->_irqUs = micros();
+        self->_hub->wakeFromISR(self->_hubSlot);
     }
 
-    void touchTaskLoop() {
-        while (1) {
-            // Poll touch input at ~100Hz
-            if (_ts->tirqTouched() && _ts->touched()) {
-                TS_Point p = _ts->getPoint();
-
-                // Calibrate raw coordinates to logical display coordinates
-                uint16_t touchX = map(p.x, TS_MINX, TS_MAXX, 0, 320);
-                uint16_t touchY = map(p.y, TS_MINY, TS_MAXY, 0, 240);
+    bool penDown() {
+        return digitalRead(XPT2046_IRQ) == LOW;
+    }
 
-                // Create and queue the touch event
-                TouchEvent event = {
-                    .x = touchX,
-                    .y = touchY,
-                    .timestamp = millis()
-                };
+    void queueEvent(RawTouch& event) {
+        event.queuedUs = micros();
+        // Use queue to pass event to Core 0 safely
+        if (xQueueSend(_eventQueue, &event, 0) != pdTRUE) {
+            Serial.println("[Touch] Event queue full, dropping event");
+        }
+    }
 
-                // Use queue to pass event to Core 0 safely
-                xQueueSend(_eventQueue, &event, 0);
+    // Sensor hub callback: idle until the pen-down IRQ, then one reading every 5 ms until
+    // the pen lifts
+    static uint32_t pollTouch(void* ctx) {
+        return static_cast<TouchManager*>(ctx)->pollTouch();
+    }
 
-                // Debounce delay
-                delay(100);
-            }
+    uint32_t pollTouch() {
+        if (!_inBurst) {
+            // Re-check the pin rather than trusting the edge: an edge that arrived while
+            // the last touch was being sampled was dropped, and our own SPI reads cause
+            // spurious ones
+            if (!penDown()) return _penPolling.load(std::memory_order_relaxed) ? PEN_POLL_US : SensorHub::IDLE;
+            uint32_t downUs = _irqUs;
+            if (micros() - downUs > PEN_POLL_US) downUs = micros();  // found by polling, no edge
+            _sampler.begin(downUs);
+            _recorder.record('D', 0, 0, 0, true, downUs);
+            _inBurst = true;
+            if (_bus) _bus->publish(Event::of(EVENT_TOUCH_DOWN));
+        }
 
-            // Poll interval: 10ms = ~100Hz touch polling rate
-            delay(10);
+        // TouchSampler decides what becomes an event
+        RawTouch event;
+        TS_Point p = _ts->getPoint();  // z is 0 when the library sees no touch
+        bool pen = penDown();
+        uint32_t nowUs = micros();
+        _recorder.record('S', p.x, p.y, p.z, pen, nowUs);
+        if (_sampler.sample(p.x, p.y, p.z, pen, nowUs, event)) {
+            queueEvent(event);
         }
-    }
+        if (!_sampler.done()) return SensorHub::PERIOD;  // next reading 5 ms after this one was due
 
-    bool isTouchInArea(const TouchEvent& event, const TouchArea& area) {
-        return event.x >= area.x1 && event.x <= area.x2 &&
-               event.y >= area.y1 && event.y <= area.y2;
+        if (_sampler.finish(micros(), event)) {
+            queueEvent(event);
+        }
+        _inBurst = false;
+        return SensorHub::IDLE;
     }
 
     void drawDebugOverlay() {
-        // Draw rectangles for all touch areas
-        for (int i = 0; i < AREA_COUNT; i++) {
-            TouchArea& area = _touchAreas[i];
+        // Draw rectangles for every live region in the registry
+        for (uint32_t m = _areas.liveMask(); m; m &= m - 1) {
+            const TouchArea& area = _areas.area(__builtin_ctz(m));
             uint16_t color = TFT_GREEN;
-            
+
             // Draw outline rectangle
-            _display->drawRectOutline(area.x1, area.y1, area.x2 - area.x1, area.y2 - area.y1, color);
-            
+            _display->drawRectOutline(area.x1, area.y1, area.x2 - area.x1 + 1, area.y2 - area.y1 + 1, color);
+
             // Draw label inside (tiny font)
             _display->drawTextInArea(area.x1 + 2, area.y1 + 2, area.label, TFT_GREEN);
         }
@@ -142,8 +168,94 @@ private:
     }
 
     void disableDebugOverlay() {
-        // Redraw the static interface to clear debug overlay
-        _display->drawStaticInterface();
+        logLatencySummary();
+        if (_hub) _hub->logStats();
+        // Outlines now cover the whole screen; have loop() repaint everything
+        _titleIsCopyright = false;
+        _redrawNeeded = true;
+    }
+
+    // Screen layout regions; keep in step with the DisplayManager layout constants
+    void registerDefaultAreas() {
+        // Title area roughly covering "TouchClock" text in header
+        _areas.add(80, 4, 240, 32, "Title", TOUCH_TITLE);
+        // Version label area (top-right tiny text)
+        _areas.add(285, 20, 319, 35, "Version", TOUCH_VERSION);
+        // Top-left corner for debug chime (press-and-hold 2s)
+        _areas.add(0, 0, 70, 40, "ChimeDebug", TOUCH_DEBUG_CHIME);
+        _areas.add(40, 62, 280, 112, "Clock", TOUCH_CLOCK);
+        _areas.add(40, 116, 280, 138, "Date", TOUCH_DATE);
+        static const char* const forecastLabels[6] = {"Fc0", "Fc1", "Fc2", "Fc3", "Fc4", "Fc5"};
+        for (int i = 0; i < 6; i++) {
+            uint16_t x1 = (uint16_t)(i * 320 / 6);
+            uint16_t x2 = (uint16_t)((i + 1) * 320 / 6 - 1);
+            _areas.add(x1, 146, x2, 206, forecastLabels[i], TOUCH_FORECAST);
+        }
+        _areas.add(0, 212, 319, 239, "Status", TOUCH_STATUS);
+    }
+
+    void showCalibrationStep(const char* note = nullptr) {
+        String prompt = note ? String(note) + " - " : String();
+        if (_calStep < CAL_POINTS) {
+            prompt += String("Touch the cross (") + (_calStep + 1) + "/" + CAL_POINTS + ")";
+        } else {
+            prompt += "Touch the cross to verify";
+        }
+        _display->showCalibrationTarget(CAL_TARGET_X[_calStep], CAL_TARGET_Y[_calStep], prompt);
+    }
+
+    void finishCalibration() {
+        _calStep = -1;
+        _gestures.reset();
+        _redrawNeeded = true;
+    }
+
+    // Calibration consumes raw releases directly; gestures are suspended meanwhile
+    void handleCalibrationTouch(const RawTouch& touch) {
+        _calLastMs = millis();
+        if (touch.type != TOUCH_RELEASE) return;
+        _calRawX[_calStep] = touch.x;
+        _calRawY[_calStep] = touch.y;
+        Serial.printf("[Touch] Calibration point %d: raw (%u,%u) for (%u,%u)\n", _calStep + 1,
+                      touch.x, touch.y, CAL_TARGET_X[_calStep], CAL_TARGET_Y[_calStep]);
+
+        if (_calStep + 1 < CAL_POINTS) {
+            _calStep++;
+            showCalibrationStep();
+            return;
+        }
+
+        if (_calStep + 1 == CAL_POINTS) {
+            if (!TouchCalibration::solve(_calRawX, _calRawY, CAL_TARGET_X, CAL_TARGET_Y, _calCandidate)) {
+                Serial.println("[Touch] Calibration rejected: points degenerate or out of range");
+                _calStep = 0;
+                showCalibrationStep("Bad taps");
+                return;
+            }
+            _calStep++;
+            showCalibrationStep();
+            return;
+        }
+
+        // Verification tap through the candidate matrix
+        uint16_t x, y;
+        TouchCalibration::apply(_calCandidate, touch.x, touch.y, x, y);
+        int err = max(abs((int)x - CAL_TARGET_X[_calStep]), abs((int)y - CAL_TARGET_Y[_calStep]));
+        if (err > CAL_VERIFY_TOLERANCE_PX) {
+            Serial.printf("[Touch] Calibration verify missed by %d px, restarting\n", err);
+            _calStep = 0;
+            showCalibrationStep((String("Off by ") + err + " px").c_str());
+            return;
+        }
+
+        _matrix = _calCandidate;
+        if (_config) {
+            _config->setTouchCalibration(_matrix);
+        }
+        Serial.printf("[Touch] Calibration saved (verify error %d px): a=%ld b=%ld c=%ld d=%ld e=%ld f=%ld\n", err,
+                      (long)_matrix.a, (long)_matrix.b, (long)_matrix.c,
+                      (long)_matrix.d, (long)_matrix.e, (long)_matrix.f);
+        finishCalibration();
     }
 
 public:
@@ -151,23 +263,25 @@ public:
         : _spi(nullptr),
           _ts(nullptr),
           _eventQueue(nullptr),
-          _touchTaskHandle(nullptr),
+          _hub(nullptr),
+          _hubSlot(-1),
           _display(nullptr),
           _chime(nullptr),
+          _config(nullptr),
+          _bus(nullptr),
           _debugMode(false),
-          _versionPressCount(0),
-          _lastVersionPressTime(0),
-          _titlePressCount(0),
-          _lastTitlePressTime(0),
           _titleIsCopyright(false),
-          _pressActive(false),
-          _pressArea(TOUCH_TITLE),
-          _pressStartMs(0) {}
+          _irqUs(0),
+          _inBurst(false),
+          _matrix(TouchCalibration::fromRange(TS_MINX, TS_MAXX, TS_MINY, TS_MAXY)),
+          _calStep(-1),
+          _calCandidate(),
+          _calLastMs(0),
+          _redrawNeeded(false) {
+        registerDefaultAreas();
+    }
 
     ~TouchManager() {
-        if (_touchTaskHandle) {
-            vTaskDelete(_touchTaskHandle);
-        }
         if (_eventQueue) {
             vQueueDelete(_eventQueue);
         }
@@ -175,83 +289,186 @@ public:
         if (_spi) delete _spi;
     }
 
-    void begin(DisplayManager* display) {
+    void begin(DisplayManager* display, SensorHub* hub) {
         _display = display;
+        _hub = hub;
 
         // Initialize SPI for touch controller on HSPI to avoid contention with TFT VSPI bus
         _spi = new SPIClass(HSPI);
         _spi->begin(XPT2046_CLK, XPT2046_MISO, XPT2046_MOSI, XPT2046_CS);
 
-        // Initialize XPT2046 touchscreen
-        _ts = new XPT2046_Touchscreen(XPT2046_CS, XPT2046_IRQ);
+        // Initialize XPT2046 touchscreen; PENIRQ is handled here rather than by the library
+        _ts = new XPT2046_Touchscreen(XPT2046_CS);
         _ts->begin(*_spi);
         _ts->setRotation(1);  // Match display rotation
 
-        // Create FreeRTOS queue for touch events (10 events max)
-        _eventQueue = xQueueCreate(10, sizeof(TouchEvent));
+        // Create FreeRTOS queue for touch events (16 events max)
+        _eventQueue = xQueueCreate(16, sizeof(RawTouch));
         if (!_eventQueue) {
             Serial.println("ERROR: Failed to create touch event queue");
             return;
         }
 
-        // Create and pin touch polling task to Core 1
-        xTaskCreatePinnedToCore(
-            touchTaskWrapper,      // Task function
-            "TouchTask",           // Task name
-            4096,                  // Stack size (bytes)
-            this,                  // Task parameter (pointer to this)
-            2,                     // Priority (medium)
-            &_touchTaskHandle,     // Task handle output
-            1                      // Core 1
-        );
-
-        Serial.println("TouchManager initialized on Core 1");
+        // Sampling runs in the sensor hub, idle between touches
+        _hubSlot = _hub->add("touch", SAMPLE_INTERVAL_US, pollTouch, this);
+
+        // GPIO36 is input-only; the XPT2046 pulls PENIRQ up itself
+        pinMode(XPT2046_IRQ, INPUT);
+        attachInterruptArg(digitalPinToInterrupt(XPT2046_IRQ), penIrqHandler, this, FALLING);
+
+        _recorder.begin();
+
+        Serial.println("TouchManager initialized (IRQ-driven, sampled by the sensor hub)");
     }
 
-    bool hasPendingEvents() {
-        return uxQueueMessagesWaiting(_eventQueue) > 0;
+    // Also check the pen every 100 ms between touches, for when the chip light-sleeps and
+    // the PENIRQ edge cannot wake it. Safe from any task.
+    void setPenPolling(bool on) {
+        if (_penPolling.exchange(on) == on) return;
+        if (on && _hub) _hub->wake(_hubSlot);
+    }
+
+    // Set before the sensor hub starts: pen-downs are published from the hub task
+    void setEventBus(EventBus* bus) {
+        _bus = bus;
     }
 
     void setChimeManager(ChimeManager* chime) {
         _chime = chime;
     }
 
+    // Loads this unit's calibration; without one the TS_MIN/MAX defaults stay in use
+    void setConfigStore(ConfigStore* config) {
+        _config = config;
+        if (_config && _config->touch().calibrated) {
+            _matrix = _config->touch().matrix;
+            Serial.println("[Touch] Using stored calibration");
+        }
+    }
+
+    // Full-screen target flow; the previous matrix stays active until the result verifies
+    void startCalibration() {
+        if (!_display) return;
+        Serial.println("[Touch] Calibration started");
+        _debugMode = false;
+        _titleIsCopyright = false;
+        _gestures.reset();
+        _calStep = 0;
+        _calLastMs = millis();
+        showCalibrationStep();
+    }
+
+    bool isCalibrating() const { return _calStep >= 0; }
+
+    // True once after calibration or the debug overlay ends: the screen needs a full redraw
+    bool checkAndClearRedrawNeeded() {
+        bool needed = _redrawNeeded;
+        _redrawNeeded = false;
+        return needed;
+    }
+
     void update() {
         // This should be called from Core 0 (main loop)
-        TouchEvent event;
+        RawTouch raw;
+
+        while (xQueueReceive(_eventQueue, &raw, 0) == pdTRUE) {
+            uint32_t dequeuedUs = micros();
+            metricTouchEventLatency.observe(dequeuedUs - raw.timestampUs);
+            if (_calStep >= 0) {
+                handleCalibrationTouch(raw);
+                continue;
+            }
+
+            TouchEvent event;
+            event.type = raw.type;
+            event.timestampUs = raw.timestampUs;
+            TouchCalibration::apply(_matrix, raw.x, raw.y, event.x, event.y);
+            if (_debugMode) {
+                // Same format tools/gesture_replay.cpp reads (it ignores the trailing raw pair),
+                // so a serial log can be replayed
+                Serial.printf("[TouchTrace] %c %u %u %lu raw %u %u\n", "PMR"[event.type],
+                              event.x, event.y, (unsigned long)event.timestampUs, raw.x, raw.y);
+            }
+            _gestures.feed(event);
 
-        while (xQueueReceive(_eventQueue, &event, 0) == pdTRUE) {
-            handleTouchEvent(event);
+            // Gestures completed by this event are traced back to it
+            dispatchGestures({raw.timestampUs, raw.queuedUs, dequeuedUs});
         }
-    }
 
-    void handleTouchEvent(const TouchEvent& event) {
-        // Check which area was touched
-        for (int i = 0; i < AREA_COUNT; i++) {
-            if (isTouchInArea(event, _touchAreas[i])) {
-                handleAreaTouched(_touchAreas[i]);
-                break;
+        _recorder.update();
+
+        if (_calStep >= 0) {
+            if (millis() - _calLastMs >= CAL_TIMEOUT_MS) {
+                Serial.println("[Touch] Calibration timed out, keeping previous calibration");
+                finishCalibration();
             }
+            return;
         }
+
+        // Long-presses fire while the pen is still held, without needing new events; they
+        // are traced from the moment they were recognised
+        uint32_t nowUs = micros();
+        _gestures.tick(nowUs);
+        dispatchGestures({nowUs, nowUs, nowUs});
     }
 
-    void handleAreaTouched(const TouchArea& area) {
-        unsigned long now = millis();
+    // Serial summary of the touch latency histograms (also served at /api/metrics)
+    void logLatencySummary() const {
+        const MetricHistogram* hists[] = {&metricTouchEventLatency, &metricTouchDispatchLatency,
+                                          &metricTouchPhotonLatency};
+        const char* names[] = {"sample->loop", "sample->handler", "sample->photon"};
+        for (int i = 0; i < 3; i++) {
+            Serial.printf("[TouchLatency] %-15s n=%lu mean=%lu us p50<=%lu us p95<=%lu us max=%lu us\n", names[i],
+                          (unsigned long)hists[i]->count(), (unsigned long)hists[i]->meanUs(),
+                          (unsigned long)hists[i]->quantileUs(0.5f), (unsigned long)hists[i]->quantileUs(0.95f),
+                          (unsigned long)hists[i]->maxUs());
+        }
+    }
 
-        // Handle long-press debug chime in top-left corner (2s hold)
-        if (area.id == TOUCH_DEBUG_CHIME) {
-            if (!_pressActive || _pressArea != area.id) {
-                _pressActive = true;
-                _pressArea = area.id;
-                _pressStartMs = now;
+    void dispatchGestures(const LatencyTrace& trace) {
+        Gesture gesture;
+        while (_gestures.poll(gesture)) {
+            uint32_t drawsBefore = _display ? _display->drawCount() : 0;
+            uint32_t dispatchUs = micros();
+            metricTouchDispatchLatency.observe(dispatchUs - trace.sourceUs);
+
+            handleGesture(gesture);
+            if (_bus) _bus->publish(Event::touchGesture(gesture));
+
+            // TFT_eSPI draws synchronously, so any screen change this gesture caused has
+            // been pushed by now; gestures that drew nothing have no photon latency
+            if (_display && _display->drawCount() != drawsBefore) {
+                uint32_t photonUs = _display->lastDrawDoneUs();
+                metricTouchPhotonLatency.observe(photonUs - trace.sourceUs);
+                Serial.printf("[TouchLatency] %s: sample->queue %lu us, queue %lu us, dispatch %lu us, draw %lu us, total %lu us\n",
+                              GestureEngine::name(gesture.type),
+                              (unsigned long)(trace.queuedUs - trace.sourceUs),
+                              (unsigned long)(trace.dequeuedUs - trace.queuedUs),
+                              (unsigned long)(dispatchUs - trace.dequeuedUs),
+                              (unsigned long)(photonUs - dispatchUs),
+                              (unsigned long)(photonUs - trace.sourceUs));
             }
+        }
+    }
+
+    void handleGesture(const Gesture& gesture) {
+        // Check which area the gesture started in
+        int slot = _areas.hitTest(gesture.x, gesture.y);
+        if (slot >= 0) {
+            handleAreaGesture(slot, gesture);
+            return;
+        }
+        if (_debugMode) {
+            Serial.printf("[Touch] %s at (%u,%u)\n", GestureEngine::name(gesture.type), gesture.x, gesture.y);
+        }
+    }
 
-            unsigned long holdTime = now - _pressStartMs;
-            if (_pressActive && holdTime >= 2000) {
-                _pressActive = false;
-                _pressArea = TOUCH_TITLE;
-                _pressStartMs = 0;
+    void handleAreaGesture(int slot, const Gesture& gesture) {
+        const TouchArea& area = _areas.area(slot);
 
+        // Long-press debug chime in top-left corner (2s hold)
+        if (area.id == TOUCH_DEBUG_CHIME) {
+            if (gesture.type == GESTURE_LONG_PRESS) {
                 if (_display) {
                     _display->showStatus("Playing Big Ben (debug)");
                 }
@@ -260,26 +477,12 @@ public:
                 }
             }
             return;
-        } else {
-            // Reset long-press state when other areas are tapped
-            _pressActive = false;
-            _pressArea = TOUCH_TITLE;
-            _pressStartMs = 0;
         }
 
         if (area.id == TOUCH_VERSION) {
-            // Track consecutive presses within a 500ms window
-            if (now - _lastVersionPressTime < 500) {
-                _versionPressCount++;
-            } else {
-                _versionPressCount = 1;
-            }
-            _lastVersionPressTime = now;
-
-            // On 3rd press within window, toggle debug mode
-            if (_versionPressCount >= 3) {
+            // Triple-tap toggles debug mode
+            if (gesture.type == GESTURE_TRIPLE_TAP) {
                 _debugMode = !_debugMode;
-                _versionPressCount = 0;
 
                 if (_debugMode) {
                     drawDebugOverlay();
@@ -288,18 +491,20 @@ public:
                 }
             }
         } else if (area.id == TOUCH_TITLE) {
-            // Triple-tap to toggle header text between title and copyright notice
-            if (now - _lastTitlePressTime < 500) {
-                _titlePressCount++;
-            } else {
-                _titlePressCount = 1;
+            // In debug mode, a long-press on the title starts touch calibration
+            if (gesture.type == GESTURE_LONG_PRESS && _debugMode) {
+                startCalibration();
+                return;
             }
-            _lastTitlePressTime = now;
 
-            Serial.printf("Title pressed (%d/3)\n", _titlePressCount);
+            // Triple-tap to toggle header text between title and copyright notice
+            int taps = gesture.type == GESTURE_TAP ? 1
+                     : gesture.type == GESTURE_DOUBLE_TAP ? 2
+                     : gesture.type == GESTURE_TRIPLE_TAP ? 3 : 0;
+            if (taps == 0) return;
+            Serial.printf("Title pressed (%d/3)\n", taps);
 
-            if (_titlePressCount >= 3) {
-                _titlePressCount = 0;
+            if (taps == 3) {
                 _titleIsCopyright = !_titleIsCopyright;
 
                 if (_titleIsCopyright) {
@@ -315,6 +520,19 @@ public:
                     drawDebugOverlay();
                 }
             }
+        } else if (area.id == TOUCH_STATUS && gesture.type == GESTURE_LONG_PRESS && _debugMode) {
+            // In debug mode, a long-press on the status bar starts/stops the trace recorder
+            if (_recorder.isRecording()) {
+                _recorder.stop();
+                _display->showStatus(String("Touch trace saved: ") + _recorder.sampleCount() + " readings");
+            } else if (_recorder.start(_matrix)) {
+                _display->showStatus("Recording touch trace (long-press here to stop)");
+            } else {
+                _display->showStatus("Touch trace unavailable");
+            }
+        } else if (_debugMode) {
+            // Regions without an action yet: report hits so the layout can be checked
+            Serial.printf("[Touch] %s on %s (slot %d)\n", GestureEngine::name(gesture.type), area.label, slot);
         }
     }
 
@@ -326,10 +544,25 @@ public:
         return uxQueueMessagesWaiting(_eventQueue) > 0;
     }
 
-    // Add a new touch area dynamically
-    void addTouchArea(uint16_t x1, uint16_t y1, uint16_t x2, uint16_t y2, 
-                      const char* label, TouchAreaId id) {
-        // Note: Would need to expand _touchAreas or use a vector
-        // For now, fixed at 1 area for simplicity
+    // Register an extra touch area; returns its slot (for removal/enabling) or -1 if full
+    int addTouchArea(uint16_t x1, uint16_t y1, uint16_t x2, uint16_t y2,
+                     const char* label, TouchAreaId id, uint8_t pages = PAGE_CLOCK) {
+        return _areas.add(x1, y1, x2, y2, label, id, pages);
+    }
+
+    void removeTouchArea(int slot) {
+        _areas.remove(slot);
+    }
+
+    void setTouchAreaEnabled(int slot, bool enabled) {
+        _areas.setEnabled(slot, enabled);
+    }
+
+    // Switch the live set of regions to another UI page
+    void setPage(uint8_t page) {
+        _areas.setPage(page);
+        if (_debugMode) {
+            drawDebugOverlay();
+        }
     }
 };
@@ -0,0 +1,109 @@
+#pragma once
+#include <Arduino.h>
+#include <FS.h>
+#include <LittleFS.h>
+#include <atomic>
+#include "SpscRing.h"
+#include "TouchCalibration.h"
+
+// Records touch sampling's raw XPT2046 readings to a text file on the LittleFS partition,
+// for replaying through the same filter/event/gesture pipeline on the host
+// (tools/touch_replay.cpp). The sensor hub task only pushes into a lock-free ring;
+// loop() drains it to the file, so flash writes never stall sampling.
+//
+// File format, one record per line:
+//   # comment
+//   M a b c d e f          calibration matrix in use (Q16, see TouchCalibration.h)
+//   D us                   pen-down IRQ edge, starts a burst
+//   S x y z pen us         one reading: raw coordinates, pressure, PENIRQ low (1/0)
+class TouchRecorder {
+public:
+    static constexpr const char* PATH = "/touchtrace.txt";
+    static const size_t MAX_FILE_BYTES = 256 * 1024;  // ~40 s of continuous touching
+
+    struct Sample {
+        char kind;  // 'D' or 'S'
+        bool pen;
+        int16_t x, y, z;
+        uint32_t us;
+    };
+
+private:
+    SpscRing<Sample, 64> _ring;  // ~320 ms of readings at 200 Hz between loop() passes
+    std::atomic<bool> _recording{false};
+    std::atomic<uint32_t> _dropped{0};
+    bool _mounted = false;
+    File _file;
+    uint32_t _samples = 0;
+
+    void drain() {
+        Sample s;
+        while (_ring.pop(s)) {
+            if (s.kind == 'D') {
+                _file.printf("D %lu\n", (unsigned long)s.us);
+            } else {
+                _file.printf("S %d %d %d %d %lu\n", s.x, s.y, s.z, s.pen ? 1 : 0, (unsigned long)s.us);
+                _samples++;
+            }
+        }
+    }
+
+public:
+    void begin() {
+        // Format on first use: the partition ships empty
+        _mounted = LittleFS.begin(true);
+        if (!_mounted) {
+            Serial.println("[TouchTrace] LittleFS mount failed; recording unavailable");
+        }
+    }
+
+    // Loop side. Overwrites the previous trace.
+    bool start(const TouchMatrix& matrix) {
+        if (!_mounted || _recording) return false;
+        _file = LittleFS.open(PATH, "w");
+        if (!_file) {
+            Serial.println("[TouchTrace] Cannot create trace file");
+            return false;
+        }
+        _file.printf("# TouchClock touch trace v1\n");
+        _file.printf("M %ld %ld %ld %ld %ld %ld\n", (long)matrix.a, (long)matrix.b, (long)matrix.c,
+                     (long)matrix.d, (long)matrix.e, (long)matrix.f);
+        Sample stale;
+        while (_ring.pop(stale)) {}  // left behind by the previous stop()
+        _samples = 0;
+        _dropped = 0;
+        _recording = true;
+        Serial.printf("[TouchTrace] Recording to %s\n", PATH);
+        return true;
+    }
+
+    void stop() {
+        if (!_recording) return;
+        _recording = false;
+        drain();  // the task may still push one last reading; it is simply left behind
+        _file.close();
+        Serial.printf("[TouchTrace] Saved %lu readings to %s (%lu dropped)\n",
+                      (unsigned long)_samples, PATH, (unsigned long)_dropped.load());
+    }
+
+    // Loop side: write out what touch sampling recorded
+    void update() {
+        if (!_recording) return;
+        drain();
+        if (_file.size() >= MAX_FILE_BYTES) {
+            Serial.println("[TouchTrace] File size limit reached");
+            stop();
+        }
+    }
+
+    // Sensor hub side
+    void record(char kind, int16_t x, int16_t y, int16_t z, bool pen, uint32_t us) {
+        if (!_recording.load(std::memory_order_relaxed)) return;
+        if (!_ring.push({kind, pen, x, y, z, us})) {
+            _dropped.fetch_add(1, std::memory_order_relaxed);
+        }
+    }
+
+    bool isRecording() const { return _recording; }
+    uint32_t sampleCount() const { return _samples; }
+};
@@ -0,0 +1,131 @@
+#pragma once
+#include <stdint.h>
+
+// UI pages a touch region can belong to (bitmask, so a region may sit on several)
+enum UiPage : uint8_t {
+    PAGE_CLOCK = 1 << 0,     // main clock/weather screen
+    PAGE_SETTINGS = 1 << 1,  // reserved for on-device settings pages
+    PAGE_ALL = 0xFF
+};
+
+struct TouchArea {
+    uint16_t x1, y1;     // Top-left (inclusive)
+    uint16_t x2, y2;     // Bottom-right (inclusive)
+    const char* label;   // Debug label (string literal; not copied)
+    uint8_t id;          // Application identifier (TouchAreaId)
+    uint8_t pages;       // UiPage bits this region is live on
+    bool enabled;
+};
+
+// Fixed-capacity registry of touch regions with a coarse grid index. The screen is cut into
+// GRID_COLS x GRID_ROWS cells; each cell keeps a bitmask of the regions overlapping it, and
+// a second mask tracks which regions are live (enabled and on the current page). A hit test
+// is one cell lookup and an AND, then an exact rectangle check on the few candidates left,
+// so its cost does not grow with the number of registered regions.
+//
+// Slots are stable handles: remove() frees a slot without moving the others. Where regions
+// overlap, the lowest slot wins (registration order). No heap, no platform calls.
+class TouchRegistry {
+public:
+    static constexpr uint8_t CAPACITY = 32;  // one bit per slot in a uint32_t mask
+    static constexpr uint8_t GRID_COLS = 8;
+    static constexpr uint8_t GRID_ROWS = 6;
+    static constexpr uint16_t SCREEN_W = 320;
+    static constexpr uint16_t SCREEN_H = 240;
+    static constexpr uint16_t CELL_W = SCREEN_W / GRID_COLS;  // 40 px
+    static constexpr uint16_t CELL_H = SCREEN_H / GRID_ROWS;  // 40 px
+
+private:
+    TouchArea _areas[CAPACITY];
+    uint32_t _used = 0;     // occupied slots
+    uint32_t _live = 0;     // occupied, enabled and on the current page
+    uint32_t _cells[GRID_ROWS][GRID_COLS] = {};
+    uint8_t _page = PAGE_CLOCK;
+
+    static uint16_t clampX(uint16_t x) { return x < SCREEN_W ? x : SCREEN_W - 1; }
+    static uint16_t clampY(uint16_t y) { return y < SCREEN_H ? y : SCREEN_H - 1; }
+
+    void index(uint8_t slot, bool set) {
+        const TouchArea& a = _areas[slot];
+        uint32_t bit = 1UL << slot;
+        for (uint8_t row = clampY(a.y1) / CELL_H; row <= clampY(a.y2) / CELL_H; row++) {
+            for (uint8_t col = clampX(a.x1) / CELL_W; col <= clampX(a.x2) / CELL_W; col++) {
+                if (set) {
+                    _cells[row][col] |= bit;
+                } else {
+                    _cells[row][col] &= ~bit;
+                }
+            }
+        }
+    }
+
+    void updateLive(uint8_t slot) {
+        uint32_t bit = 1UL << slot;
+        const TouchArea& a = _areas[slot];
+        if ((_used & bit) && a.enabled && (a.pages & _page)) {
+            _live |= bit;
+        } else {
+            _live &= ~bit;
+        }
+    }
+
+public:
+    // Returns the slot, or -1 if the registry is full or the rectangle is inverted
+    int add(uint16_t x1, uint16_t y1, uint16_t x2, uint16_t y2, const char* label, uint8_t id,
+            uint8_t pages = PAGE_CLOCK) {
+        if (x2 < x1 || y2 < y1 || _used == 0xFFFFFFFFUL) return -1;
+        uint8_t slot = (uint8_t)__builtin_ctz(~_used);
+        _areas[slot] = {x1, y1, x2, y2, label, id, pages, true};
+        _used |= 1UL << slot;
+        index(slot, true);
+        updateLive(slot);
+        return slot;
+    }
+
+    void remove(int slot) {
+        if (!isUsed(slot)) return;
+        index((uint8_t)slot, false);
+        _used &= ~(1UL << slot);
+        updateLive((uint8_t)slot);
+    }
+
+    void setEnabled(int slot, bool enabled) {
+        if (!isUsed(slot)) return;
+        _areas[slot].enabled = enabled;
+        updateLive((uint8_t)slot);
+    }
+
+    // Enable or disable every region with this id (e.g. all six forecast slots share one)
+    void setEnabledById(uint8_t id, bool enabled) {
+        for (uint32_t m = _used; m; m &= m - 1) {
+            uint8_t slot = (uint8_t)__builtin_ctz(m);
+            if (_areas[slot].id == id) setEnabled(slot, enabled);
+        }
+    }
+
+    void setPage(uint8_t page) {
+        _page = page;
+        for (uint32_t m = _used; m; m &= m - 1) {
+            updateLive((uint8_t)__builtin_ctz(m));
+        }
+    }
+
+    uint8_t page() const { return _page; }
+
+    // Slot of the live region under (x, y), or -1
+    int hitTest(uint16_t x, uint16_t y) const {
+        if (x >= SCREEN_W || y >= SCREEN_H) return -1;
+        for (uint32_t m = _cells[y / CELL_H][x / CELL_W] & _live; m; m &= m - 1) {
+            uint8_t slot = (uint8_t)__builtin_ctz(m);
+            const TouchArea& a = _areas[slot];
+            if (x >= a.x1 && x <= a.x2 && y >= a.y1 && y <= a.y2) return slot;
+        }
+        return -1;
+    }
+
+    bool isUsed(int slot) const { return slot >= 0 && slot < CAPACITY && (_used & (1UL << slot)); }
+    bool isLive(int slot) const { return slot >= 0 && slot < CAPACITY && (_live & (1UL << slot)); }
+    const TouchArea& area(int slot) const { return _areas[slot]; }
+    uint32_t liveMask() const { return _live; }
+    uint8_t count() const { return (uint8_t)__builtin_popcount(_used); }
+};
@@ -0,0 +1,74 @@
+#pragma once
+#include <stdint.h>
+#include <stdlib.h>
+#include "TouchEvent.h"
+#include "TouchFilter.h"
+
+// Turns the readings of one pen-down burst into raw press/move/release events. The touch
+// task feeds it every 5 ms; tools/touch_replay.cpp feeds it recorded readings, so both run
+// the same filtering and event decisions. No platform calls.
+//
+// The press is reported once the filter has a firm, settled reading; a touch that never
+// gets there (IRQ glitch, brushing the panel) produces no events at all.
+class TouchSampler {
+public:
+    static const uint8_t RELEASE_SAMPLES = 2;       // consecutive pen-up samples to release
+    static const uint16_t MOVE_THRESHOLD_RAW = 32;  // ~3 px; smaller moves are not reported
+
+private:
+    TouchFilter _filter;
+    uint32_t _downUs = 0;
+    uint16_t _lastX = 0, _lastY = 0;
+    uint8_t _upSamples = 0;
+
+    static void fill(RawTouch& out, TouchEventType type, uint16_t x, uint16_t y, uint32_t us) {
+        out.type = type;
+        out.x = x;
+        out.y = y;
+        out.timestampUs = us;
+        out.queuedUs = 0;
+    }
+
+public:
+    // New burst after the pen-down edge at downUs
+    void begin(uint32_t downUs) {
+        _filter.reset();
+        _downUs = downUs;
+        _upSamples = 0;
+    }
+
+    // One reading (z is 0 when the controller sees no touch); true with an event to queue
+    bool sample(int16_t x, int16_t y, int16_t z, bool penDown, uint32_t nowUs, RawTouch& out) {
+        bool wasPressed = _filter.isPressed();
+        uint16_t fx, fy;
+        if (!_filter.add(x, y, z, fx, fy)) {
+            // Before the press only a lifted pen ends the burst; a light touch keeps sampling
+            if (wasPressed || !penDown) _upSamples++;
+            return false;
+        }
+        _upSamples = 0;
+        if (!wasPressed) {
+            _lastX = fx;
+            _lastY = fy;
+            fill(out, TOUCH_PRESS, fx, fy, _downUs);
+            return true;
+        }
+        if (abs((int)fx - _lastX) >= MOVE_THRESHOLD_RAW || abs((int)fy - _lastY) >= MOVE_THRESHOLD_RAW) {
+            _lastX = fx;
+            _lastY = fy;
+            fill(out, TOUCH_MOVE, fx, fy, nowUs);
+            return true;
+        }
+        return false;
+    }
+
+    // The burst is over once the pen has read as up RELEASE_SAMPLES times in a row
+    bool done() const { return _upSamples >= RELEASE_SAMPLES; }
+
+    // After done(): the release at the last reported position, if there was a press
+    bool finish(uint32_t nowUs, RawTouch& out) {
+        if (!_filter.isPressed()) return false;
+        fill(out, TOUCH_RELEASE, _lastX, _lastY, nowUs);
+        return true;
+    }
+};
@@ -0,0 +1,15 @@
+#include "Wavetable.h"
+#if __has_include(<esp_attr.h>)
+#include <esp_attr.h>
+#else
+#define DRAM_ATTR  // host tools
+#endif
+
+// Generated entirely by the compiler; these fail to build if the tables are not constant
+static_assert(SineTable<256>().data[64] == 32767 && SineTable<256>().data[192] == -32767, "sine table");
+static_assert(SineTable<1024>().data[256] == 32767 && SineTable<1024>().data[1024] == 0, "sine table");
+
+// Read by the render task on every sample: keep it in DRAM, never behind the flash cache
+DRAM_ATTR const SineTable<256> sineTable256;
+// Only the host benchmark reads this one; in flash it costs no DRAM and the linker drops it
+const SineTable<1024> sineTable1024;
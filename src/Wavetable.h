@@ -0,0 +1,94 @@
+#pragma once
+#include <stddef.h>
+#include <stdint.h>
+
+// Compile-time generated Q15 sine tables and an interpolating lookup for the audio path.
+// Tables are built by a constexpr constructor (no boot-time maths). Only the 256-entry
+// table the bell synth renders from is placed in DRAM, so rendering never waits on the
+// flash cache; the 1024-entry one is only read by tools/wavetable_bench.cpp and stays in
+// flash on the board. Each table carries one guard entry so interpolation never needs to
+// wrap the index.
+namespace wavetable_detail {
+
+constexpr double kPi = 3.14159265358979323846;
+
+// sin(x) for |x| <= pi/2 by Taylor series to x^17 (error < 1e-9); std::sin is not constexpr
+constexpr double sinQuarter(double x) {
+    double term = x;
+    double sum = x;
+    for (int n = 1; n <= 8; n++) {
+        term *= -x * x / ((2 * n) * (2 * n + 1));
+        sum += term;
+    }
+    return sum;
+}
+
+constexpr int16_t roundQ15(double v) {
+    return (int16_t)(v >= 0 ? v * 32767.0 + 0.5 : v * 32767.0 - 0.5);
+}
+
+constexpr uint8_t log2Exact(size_t n) {
+    uint8_t bits = 0;
+    while (n > 1) {
+        n >>= 1;
+        bits++;
+    }
+    return bits;
+}
+
+}  // namespace wavetable_detail
+
+template <size_t N>
+struct SineTable {
+    static_assert(N >= 4 && (N & (N - 1)) == 0, "SineTable size must be a power of two");
+
+    int16_t data[N + 1];
+
+    // Built from one quarter wave so the table is exactly symmetric
+    constexpr SineTable() : data() {
+        for (size_t i = 0; i < N; i++) {
+            size_t q = i / (N / 4);
+            size_t r = i % (N / 4);
+            size_t k = (q & 1) ? (N / 4 - r) : r;
+            double s = wavetable_detail::sinQuarter(wavetable_detail::kPi / 2 * k / (N / 4));
+            data[i] = wavetable_detail::roundQ15(q >= 2 ? -s : s);
+        }
+        data[N] = data[0];
+    }
+};
+
+// Instances (Wavetable.cpp); add a size here and there to make it selectable. A table the
+// synth renders from needs DRAM_ATTR there: sineTable1024 has none, so selecting it for
+// BellSynth::Sine means adding it (2 KB of DRAM) or reading it through the flash cache.
+extern const SineTable<256> sineTable256;
+extern const SineTable<1024> sineTable1024;
+
+template <size_t N> struct SineTableRef;
+template <> struct SineTableRef<256> {
+    static const int16_t* data() { return sineTable256.data; }
+};
+template <> struct SineTableRef<1024> {
+    static const int16_t* data() { return sineTable1024.data; }
+};
+
+// Q15 sine lookup for a 32-bit phase accumulator, linearly interpolated
+template <size_t N>
+struct Wavetable {
+    static constexpr uint8_t BITS = wavetable_detail::log2Exact(N);
+    static constexpr uint8_t INDEX_SHIFT = 32 - BITS;
+    static_assert(INDEX_SHIFT >= 15, "Wavetable needs 15 fractional phase bits");
+
+    static inline int16_t sample(uint32_t phase) {
+        const int16_t* t = SineTableRef<N>::data();
+        uint32_t idx = phase >> INDEX_SHIFT;
+        int32_t frac = (int32_t)((phase >> (INDEX_SHIFT - 15)) & 0x7FFF);
+        int32_t a = t[idx];
+        int32_t b = t[idx + 1];
+        return (int16_t)(a + (((b - a) * frac + 0x4000) >> 15));  // rounded: no DC bias
+    }
+
+    // Nearest-lower entry, no interpolation (for comparison benchmarks)
+    static inline int16_t sampleTruncated(uint32_t phase) {
+        return SineTableRef<N>::data()[phase >> INDEX_SHIFT];
+    }
+};
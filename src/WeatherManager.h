@@ -3,10 +3,12 @@
 #include <WiFi.h>
 #include <WiFiClientSecure.h>
 #include <HTTPClient.h>
-#include <Preferences.h>
+#include "ConfigStore.h"
 #include "DisplayManager.h"
+#include "EventBus.h"
+#include "Metrics.h"
 
-// Fetch rolling weather via open-meteo (no API key). Location loaded from Preferences.
+// Fetch rolling weather via open-meteo (no API key). Location read from ConfigStore.
 // Displays 6 slots (every 2 hours) starting ~2h from now, using DisplayManager icons.
 class WeatherManager {
     // Default: London
@@ -17,7 +19,8 @@ class WeatherManager {
     float _lon = DEFAULT_LON;
     String _townName = "London";  // Town/city name from geocoding
     bool _locationLoaded = false;
-    Preferences _locPrefs;
+    ConfigStore* _config = nullptr;
+    EventBus* _bus = nullptr;  // EVENT_FORECAST_UPDATED
 
     uint8_t _codes[6] = {0, 0, 0, 0, 0, 0};
     float _temps[6] = {0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f};  // Temperature in Celsius for each slot
@@ -25,6 +28,20 @@ class WeatherManager {
     int _lastFetchDay = -1;  // tm_mday when last fetched
     int _lastRenderedStartHour = -1; // start hour used in last render
     time_t _lastFetchEpoch = 0; // epoch seconds of last successful fetch
+    bool _paused = false;       // set while offline; fetches are skipped, rendering continues
+    bool _refreshRequested = false;  // requestRefresh(): fetch once _refreshAtMs has passed
+    unsigned long _refreshAtMs = 0;
+
+    // Failed fetches back off (30 s doubling to 15 min) so an internet outage behind a working
+    // router doesn't put a DNS/TLS attempt on every loop() pass; a success resets it
+    static const uint32_t RETRY_MIN_MS = 30000;
+    static const uint32_t RETRY_MAX_MS = 900000;
+    uint32_t _retryDelayMs = 0;  // 0: last fetch succeeded (or none failed yet)
+    unsigned long _nextRetryMs = 0;
+
+    bool retryDue() const {
+        return _retryDelayMs == 0 || (long)(millis() - _nextRetryMs) >= 0;
+    }
 
     String buildTodayTomorrowUrl() {
         // Fetch from today to tomorrow (48 hourly entries)
@@ -55,15 +72,13 @@ class WeatherManager {
 
     bool ensureLocationLoaded() {
         if (_locationLoaded) return true;
-        _locPrefs.begin("location", true);
-        bool hasLat = _locPrefs.isKey("lat");
-        bool hasLon = _locPrefs.isKey("lon");
-        if (hasLat && hasLon) {
-            _lat = _locPrefs.getFloat("lat", DEFAULT_LAT);
-            _lon = _locPrefs.getFloat("lon", DEFAULT_LON);
-            _townName = _locPrefs.getString("town", "");  // Try to load saved town
-            String savedPostcode = _locPrefs.getString("postcode", "");
-            _locPrefs.end();
+        LocationConfig loc;
+        if (_config) loc = _config->location();
+        if (loc.hasCoords) {
+            _lat = loc.lat;
+            _lon = loc.lon;
+            _townName = loc.town;  // Try to use saved town
+            const String& savedPostcode = loc.postcode;
             
             // If town not saved OR equals the saved postcode (legacy), attempt reverse geocode from coordinates
             String tnTrim = _townName; tnTrim.trim();
@@ -77,9 +92,7 @@ class WeatherManager {
                     Serial.print("[WeatherManager::ensureLocationLoaded] Reverse geocode success: ");
                     Serial.println(_townName);
                     // Save the discovered town for next time
-                    _locPrefs.begin("location", false);
-                    _locPrefs.putString("town", _townName);
-                    _locPrefs.end();
+                    if (_config) _config->setTown(_townName);
                 } else {
                     Serial.println("[WeatherManager::ensureLocationLoaded] Reverse geocode failed, using placeholder");
                     _townName = "Custom Location";
@@ -88,18 +101,13 @@ class WeatherManager {
             _locationLoaded = true;
             return true;
         }
-        String postcode = _locPrefs.getString("postcode", "");
-        _locPrefs.end();
+        const String& postcode = loc.postcode;
         if (postcode.length() > 0) {
             float outLat = DEFAULT_LAT, outLon = DEFAULT_LON;
             String outTown = "London";
             if (geocodeName(postcode, outLat, outLon, outTown)) {
                 _lat = outLat; _lon = outLon; _townName = outTown; _locationLoaded = true;
-                _locPrefs.begin("location", false);
-                _locPrefs.putFloat("lat", _lat);
-                _locPrefs.putFloat("lon", _lon);
-                _locPrefs.putString("town", _townName);
-                _locPrefs.end();
+                if (_config) _config->setLocationGeocoded(postcode, _lat, _lon, _townName);
                 return true;
             }
         }
@@ -112,7 +120,15 @@ class WeatherManager {
     }
 
 public:
-    // Force reload location from preferences and update weather immediately
+    void setConfigStore(ConfigStore* config) {
+        _config = config;
+    }
+
+    void setEventBus(EventBus* bus) {
+        _bus = bus;
+    }
+
+    // Force reload location from the config store and update weather immediately
     void reloadLocation() {
         Serial.println("[WeatherManager] reloadLocation() called");
         _locationLoaded = false;
@@ -128,7 +144,22 @@ public:
         Serial.println("[WeatherManager] Next weather fetch will be forced immediately");
     }
 
+    // Pause/resume network fetches on connectivity transitions
+    void setPaused(bool paused) { _paused = paused; }
+    bool isPaused() const { return _paused; }
+
+    // Fetch from maybeRefreshRolling() once delayMs has passed rather than right now, so
+    // a caller with other network work on this loop pass doesn't stack a fetch on top
+    // A request also ends any failure backoff: it comes with a fresh link or location
+    void requestRefresh(uint32_t delayMs) {
+        _refreshRequested = true;
+        _refreshAtMs = millis() + delayMs;
+        _retryDelayMs = 0;
+    }
+
     String getTownName() const { return _townName; }
+    bool hasData() const { return _hasData; }
+    uint8_t currentCode() const { return _codes[0]; }  // first forecast slot
     float getLatitude() const { return _lat; }
     float getLongitude() const { return _lon; }
     
@@ -513,8 +544,25 @@ private:
 
 public:
     bool refresh(DisplayManager* display) {
-        if (WiFi.status() != WL_CONNECTED) return false;
+        if (_paused || WiFi.status() != WL_CONNECTED) return false;
+        _refreshRequested = false;  // this fetch answers any pending request
+
+        ScopedTimer timer(metricWeatherRefreshDuration);
+        bool ok = fetchAndRender(display);
+        (ok ? metricWeatherRefreshOk : metricWeatherRefreshFailed).inc();
+        if (ok) {
+            _retryDelayMs = 0;
+        } else {
+            _retryDelayMs = _retryDelayMs ? _retryDelayMs * 2 : RETRY_MIN_MS;
+            if (_retryDelayMs > RETRY_MAX_MS) _retryDelayMs = RETRY_MAX_MS;
+            _nextRetryMs = millis() + _retryDelayMs;
+            Serial.printf("[WeatherManager] Fetch failed, next try in %lu s\n", (unsigned long)(_retryDelayMs / 1000));
+        }
+        return ok;
+    }
 
+private:
+    bool fetchAndRender(DisplayManager* display) {
         ensureLocationLoaded();
 
         String url = buildTodayTomorrowUrl();
@@ -582,9 +630,11 @@ public:
         if (display) {
             display->showWeatherIconsWithLabelsAndTemps(_codes, _temps, startHourDisplay);
         }
+        if (_bus) _bus->publish(Event::forecastUpdated(_codes[0], (uint8_t)startHourDisplay));
         return true;
     }
 
+public:
     void show(DisplayManager* display) {
         if (_hasData && display) {
             display->showWeatherIconsWithLabelsAndTemps(_codes, _temps, _lastRenderedStartHour >= 0 ? _lastRenderedStartHour : 0);
@@ -593,7 +643,7 @@ public:
 
     void maybeRefreshDaily(const tm& timeinfo, DisplayManager* display) {
         // Fetch once per calendar day, shortly after midnight
-        if (timeinfo.tm_mday != _lastFetchDay && timeinfo.tm_hour >= 0 && timeinfo.tm_hour <= 1) {
+        if (timeinfo.tm_mday != _lastFetchDay && timeinfo.tm_hour >= 0 && timeinfo.tm_hour <= 1 && retryDue()) {
             refresh(display);
         }
     }
@@ -601,18 +651,20 @@ public:
     void maybeRefreshRolling(const tm& timeinfo, DisplayManager* display) {
         // Re-fetch at least hourly (or if missing), and re-render at each 2h boundary
         time_t nowEpoch = time(nullptr);
-        bool needsFetch = (!_hasData) || difftime(nowEpoch, _lastFetchEpoch) >= 3600;
+        bool requested = _refreshRequested && (long)(millis() - _refreshAtMs) >= 0;
+        bool needsFetch = requested || (!_hasData) || difftime(nowEpoch, _lastFetchEpoch) >= 3600;
 
         int nextStart = timeinfo.tm_hour + 2;
         if (nextStart % 2 == 1) nextStart++; // next even hour
         int nextStartDisplay = nextStart % 24;
 
-        if (needsFetch) {
+        if (needsFetch && !_paused && retryDue()) {
             refresh(display);
             return;
         }
 
-        if (nextStartDisplay != _lastRenderedStartHour) {
+        // While offline keep rolling the cached slots so labels stay current
+        if (_hasData && nextStartDisplay != _lastRenderedStartHour) {
             _lastRenderedStartHour = nextStartDisplay;
             if (display) display->showWeatherIconsWithLabelsAndTemps(_codes, _temps, nextStartDisplay);
         }
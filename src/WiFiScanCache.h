@@ -0,0 +1,192 @@
+#pragma once
+#include <Arduino.h>
+#include <WiFi.h>
+
+// Background WiFi scan engine for the provisioning API.
+// Scans are started with WiFi.scanNetworks(true) and harvested from update(), so the
+// ~2 s channel sweep never blocks loop(). Results are deduplicated by SSID (strongest
+// BSSID wins), sorted by RSSI and pre-rendered to JSON once per completed scan.
+class WiFiScanCache {
+public:
+    struct Entry {
+        char ssid[33];     // 32-byte SSID + terminator
+        int8_t rssi;
+        uint8_t channel;
+        bool secure;
+    };
+
+    static const uint8_t MAX_ENTRIES = 20;
+    static const uint32_t SCAN_INTERVAL_MS = 15000; // background cadence while enabled
+    static const uint32_t STALE_AFTER_MS = 10000;   // age at which a request triggers a refresh
+    static const uint32_t SCAN_TIMEOUT_MS = 8000;   // abandon a scan that never reports back
+    static const uint32_t RETRY_AFTER_FAIL_MS = 3000;
+
+private:
+    Entry _entries[MAX_ENTRIES];
+    uint8_t _count = 0;
+    bool _enabled = false;
+    bool _scanning = false;
+    bool _hasResults = false;
+    unsigned long _scanStartMs = 0;
+    unsigned long _lastCompleteMs = 0;
+    unsigned long _lastFailMs = 0;
+    uint32_t _lastScanDurationMs = 0;
+    uint32_t _scanCount = 0;
+    String _json = "[]";  // rendered network list, rebuilt once per completed scan
+
+    static void appendEscaped(String& out, const char* s) {
+        for (; *s; s++) {
+            if (*s == '"' || *s == '\\') {
+                out += '\\';
+                out += *s;
+            } else if ((uint8_t)*s >= 0x20) {
+                out += *s;
+            }
+        }
+    }
+
+    int findEntry(const char* ssid) const {
+        for (int i = 0; i < _count; i++) {
+            if (strcmp(_entries[i].ssid, ssid) == 0) return i;
+        }
+        return -1;
+    }
+
+    void harvest(int n) {
+        _count = 0;
+        for (int i = 0; i < n; i++) {
+            String ssid = WiFi.SSID(i);
+            if (ssid.length() == 0) continue;  // hidden network
+            int8_t rssi = (int8_t)WiFi.RSSI(i);
+
+            int idx = findEntry(ssid.c_str());
+            if (idx >= 0) {
+                // Same SSID from another BSSID: keep the strongest
+                if (rssi > _entries[idx].rssi) {
+                    _entries[idx].rssi = rssi;
+                    _entries[idx].channel = (uint8_t)WiFi.channel(i);
+                }
+                continue;
+            }
+
+            if (_count < MAX_ENTRIES) {
+                idx = _count++;
+            } else {
+                // Table full: replace the weakest entry if this one is stronger
+                idx = 0;
+                for (int j = 1; j < _count; j++) {
+                    if (_entries[j].rssi < _entries[idx].rssi) idx = j;
+                }
+                if (rssi <= _entries[idx].rssi) continue;
+            }
+
+            Entry& e = _entries[idx];
+            strncpy(e.ssid, ssid.c_str(), sizeof(e.ssid) - 1);
+            e.ssid[sizeof(e.ssid) - 1] = '\0';
+            e.rssi = rssi;
+            e.channel = (uint8_t)WiFi.channel(i);
+            e.secure = WiFi.encryptionType(i) != WIFI_AUTH_OPEN;
+        }
+
+        // Insertion sort by RSSI, strongest first (n <= MAX_ENTRIES)
+        for (int i = 1; i < _count; i++) {
+            Entry tmp = _entries[i];
+            int j = i - 1;
+            while (j >= 0 && _entries[j].rssi < tmp.rssi) {
+                _entries[j + 1] = _entries[j];
+                j--;
+            }
+            _entries[j + 1] = tmp;
+        }
+
+        _json = "[";
+        _json.reserve(_count * 48 + 2);
+        for (int i = 0; i < _count; i++) {
+            if (i > 0) _json += ",";
+            _json += "{\"ssid\":\"";
+            appendEscaped(_json, _entries[i].ssid);
+            _json += "\",\"rssi\":";
+            _json += String(_entries[i].rssi);
+            _json += ",\"ch\":";
+            _json += String(_entries[i].channel);
+            _json += ",\"secure\":";
+            _json += _entries[i].secure ? "true" : "false";
+            _json += "}";
+        }
+        _json += "]";
+    }
+
+public:
+    // Enable or disable the background cadence (scans only make sense while provisioning)
+    void setEnabled(bool enabled) {
+        _enabled = enabled;
+        if (enabled && !_hasResults) {
+            requestRefresh();
+        }
+    }
+
+    bool isEnabled() const { return _enabled; }
+
+    // Start an asynchronous scan unless one is already in flight. Never blocks.
+    bool requestRefresh() {
+        if (_scanning) return true;
+        int16_t rc = WiFi.scanNetworks(true);
+        if (rc == WIFI_SCAN_FAILED) {
+            _lastFailMs = millis();
+            Serial.println("[WiFiScan] Failed to start async scan");
+            return false;
+        }
+        _scanning = true;
+        _scanStartMs = millis();
+        return true;
+    }
+
+    // Must be called from loop(); harvests finished scans and keeps the cadence
+    void update() {
+        unsigned long now = millis();
+
+        if (_scanning) {
+            int16_t n = WiFi.scanComplete();
+            if (n >= 0) {
+                harvest(n);
+                WiFi.scanDelete();
+                _scanning = false;
+                _hasResults = true;
+                _lastCompleteMs = now;
+                _lastScanDurationMs = now - _scanStartMs;
+                _scanCount++;
+                Serial.printf("[WiFiScan] %d APs -> %u networks in %lu ms\n", n, _count, (unsigned long)_lastScanDurationMs);
+            } else if (n == WIFI_SCAN_FAILED || now - _scanStartMs > SCAN_TIMEOUT_MS) {
+                WiFi.scanDelete();
+                _scanning = false;
+                _lastFailMs = now;
+                Serial.println("[WiFiScan] Scan failed or timed out");
+            }
+            return;
+        }
+
+        if (!_enabled) return;
+        if (_lastFailMs != 0 && now - _lastFailMs < RETRY_AFTER_FAIL_MS) return;
+        if (!_hasResults || now - _lastCompleteMs >= SCAN_INTERVAL_MS) {
+            requestRefresh();
+        }
+    }
+
+    bool hasResults() const { return _hasResults; }
+    bool isScanning() const { return _scanning; }
+    bool isStale() const { return !_hasResults || ageMs() >= STALE_AFTER_MS; }
+    uint32_t ageMs() const { return _hasResults ? (uint32_t)(millis() - _lastCompleteMs) : UINT32_MAX; }
+    uint32_t lastScanDurationMs() const { return _lastScanDurationMs; }
+    uint32_t scanCount() const { return _scanCount; }
+    uint8_t count() const { return _count; }
+    const Entry& entry(uint8_t i) const { return _entries[i]; }
+
+    // Pre-rendered JSON array of {ssid, rssi, ch, secure}, strongest first
+    const String& networksJson() const { return _json; }
+
+    // Channel the SSID was last seen on, or -1 if not in the cache
+    int findChannel(const String& ssid) const {
+        int idx = findEntry(ssid.c_str());
+        return idx >= 0 ? _entries[idx].channel : -1;
+    }
+};
@@ -7,20 +7,11 @@
 #include "RGBLedManager.h"
 #include "ChimeManager.h"
 #include "WeatherManager.h"
-
-// Helper functions to avoid circular dependency between NetworkManager and WeatherManager
-void weatherManagerReload(void* mgr) {
-    if (mgr) {
-        static_cast<WeatherManager*>(mgr)->reloadLocation();
-    }
-}
-
-bool weatherManagerGeocode(void* mgr, const String& query, float& outLat, float& outLon, String& outTown) {
-    if (mgr) {
-        return static_cast<WeatherManager*>(mgr)->verifyAndGeocode(query, outLat, outLon, outTown);
-    }
-    return false;
-}
+#include "ConfigStore.h"
+#include "Metrics.h"
+#include "SensorHub.h"
+#include "EventBus.h"
+#include "PowerManager.h"
 
 // Single source of truth: app version as a constant (and backward-compatible accessor)
 static constexpr char APP_VERSION[] = "v1.0.9";
@@ -30,11 +21,25 @@ static constexpr char APP_VERSION[] = "v1.0.9";
 inline const char* appVersion() { return APP_VERSION; }
 
 // --- Objects ---
+ConfigStore configStore;  // settings cache; every manager reads NVS through it
+EventBus eventBus;        // typed events between managers and tasks
+PowerManager powerMgr;    // 80 MHz unless something holds a lock; sleeps with the screen off
+PowerStateMetric metricPowerState(powerMgr, "touchclock_power_state_seconds_total",
+    "Time spent in each power state");
 NetworkManager netMgr;
 TimeManager timeMgr; // Defaults to UK GMT/BST
 DisplayManager dispMgr;
 TouchManager touchMgr;
 RGBLedManager rgbLed;
+SensorHub sensorHub;  // touch sampling and light readings share one task
+SensorHubMetric metricSensorRuns(sensorHub, SensorHubMetric::RUNS, "touchclock_sensor_runs_total",
+    "Sensor hub callback runs per sensor");
+SensorHubMetric metricSensorBusy(sensorHub, SensorHubMetric::BUSY_SECONDS, "touchclock_sensor_busy_seconds_total",
+    "Time spent in each sensor's callback");
+SensorHubMetric metricSensorMaxRun(sensorHub, SensorHubMetric::MAX_RUN_SECONDS, "touchclock_sensor_run_max_seconds",
+    "Longest single callback run per sensor");
+SensorHubMetric metricSensorMaxLate(sensorHub, SensorHubMetric::MAX_LATE_SECONDS, "touchclock_sensor_late_max_seconds",
+    "Worst delay from a sensor's deadline to its callback starting");
 LightSensorManager lightSensor;
 ChimeManager chimeMgr;
 WeatherManager weatherMgr;
@@ -46,6 +51,136 @@ String lastDisplayedTime = "";
 String lastDisplayedDate = "";
 uint16_t lastDisplayedBrightness = 65535;  // Track brightness for display updates
 
+// --- Connectivity ---
+bool timeInitialized = false;
+
+// --- Events ---
+// Everything loop() reacts to; publishers wake the loop task instead of it polling flags
+const uint32_t LOOP_EVENTS = eventMask(EVENT_LINK_UP) | eventMask(EVENT_LINK_DOWN) |
+                             eventMask(EVENT_SCREEN_OFF) | eventMask(EVENT_SCREEN_ON) |
+                             eventMask(EVENT_LOCATION_CHANGED) | eventMask(EVENT_TIME_SYNCED) |
+                             eventMask(EVENT_FORECAST_UPDATED);
+int loopSubscriber = -1;
+
+// Light task: 5-second light average sets the LED brightness
+void onAmbientLight(uint16_t mv) {
+    rgbLed.setAmbientLight(mv);
+}
+
+// Audio task: flash the LED on every bell strike
+void onChimeStrike(void*) {
+    rgbLed.pulse();
+}
+
+// Loop task (start) / audio task (end): full clock for the synth while a chime plays
+void onChimePlayback(void*, bool playing) {
+    if (playing) {
+        powerMgr.acquire(POWER_LOCK_AUDIO);
+    } else {
+        powerMgr.release(POWER_LOCK_AUDIO);
+    }
+}
+
+// Forecast fetch after the link comes up waits this long: the timezone fetch has the
+// link-up pass to itself, and SNTP has usually answered before the labels are drawn
+const uint32_t FORECAST_AFTER_LINK_UP_MS = 1000;
+
+// Work after the link comes up: first-time NTP/timezone setup, then a forecast refresh
+void handleConnectivityResumed() {
+    weatherMgr.setPaused(false);
+    timeMgr.setPaused(false);
+    dispMgr.clearInstructions();
+    dispMgr.showStatus(String("WiFi: ") + WiFi.SSID());
+    powerMgr.applyWifiSleep();  // no modem sleep while the backlight is on (ISSUES.md)
+    if (!timeInitialized) {
+        timeMgr.begin(&dispMgr);
+        timeInitialized = true;
+        String timeStr = timeMgr.getFormattedTime();
+        String dateStr = timeMgr.getFormattedDate();
+        dispMgr.updateClock(timeStr);
+        dispMgr.updateDate(dateStr);
+        Serial.println(timeStr);
+        Serial.println(dateStr);
+    }
+    weatherMgr.requestRefresh(FORECAST_AFTER_LINK_UP_MS);
+}
+
+// Repaint every element after a full-screen takeover (touch calibration, debug overlay)
+void redrawScreen() {
+    dispMgr.clear();
+    dispMgr.updateHeaderText("TouchClock", weatherMgr.getTownName());
+    lastDisplayedTime = "";  // clock redraws on this loop pass
+    lastDisplayedDate = timeMgr.getFormattedDate();
+    dispMgr.updateDate(lastDisplayedDate);
+    weatherMgr.show(&dispMgr);
+}
+
+void handleEvent(const Event& event) {
+    switch (event.type) {
+        case EVENT_LINK_UP:
+            handleConnectivityResumed();
+            break;
+        case EVENT_LINK_DOWN:
+            weatherMgr.setPaused(true);
+            timeMgr.setPaused(true);
+            dispMgr.showStatus("WiFi lost - reconnecting...");
+            break;
+        case EVENT_SCREEN_OFF:
+            // The panel sleeps and every update only changes the display model. The LED
+            // goes dark with it so nothing keeps the chip out of light sleep.
+            dispMgr.blank();
+            rgbLed.off();
+            powerMgr.setScreenOn(false);
+            touchMgr.setPenPolling(powerMgr.isLightSleepEnabled());
+            break;
+        case EVENT_SCREEN_ON:
+            // Waking repaints the model once
+            powerMgr.setScreenOn(true);
+            touchMgr.setPenPolling(false);
+            dispMgr.wake();
+            rgbLed.on();
+            break;
+        case EVENT_LOCATION_CHANGED:
+            Serial.println("[Main Loop] Location changed, forcing weather refresh");
+            weatherMgr.reloadLocation();
+            weatherMgr.refresh(&dispMgr);
+            // Refresh timezone for new coordinates and resync time
+            timeMgr.refreshTimezone(weatherMgr.getLatitude(), weatherMgr.getLongitude(), &dispMgr);
+            break;
+        case EVENT_TIME_SYNCED:
+            // The clock may have jumped (first sync, new timezone): redraw both labels now
+            lastDisplayedTime = "";
+            lastDisplayedDate = timeMgr.getFormattedDate();
+            dispMgr.updateDate(lastDisplayedDate);
+            break;
+        case EVENT_FORECAST_UPDATED:
+            rgbLed.setWeatherCode(event.forecast.code);
+            break;
+        default:
+            break;
+    }
+}
+
+// Samples point-in-time gauges right before /api/metrics renders (runs in the loop task)
+void collectMetrics() {
+    metricUptimeSeconds.set(millis() / 1000);
+    metricHeapFree.set(ESP.getFreeHeap());
+    metricHeapMinFree.set(ESP.getMinFreeHeap());
+    metricHeapMaxAlloc.set(ESP.getMaxAllocHeap());
+    metricStackFreeLoop.set(uxTaskGetStackHighWaterMark(nullptr));
+    metricStackFreeSensors.set(sensorHub.stackHighWaterMark());
+    metricStackFreeAudio.set(chimeMgr.stackHighWaterMark());
+    // Boot benchmark until the first chime has produced real render figures
+    uint32_t cps = chimeMgr.synthCyclesPerSample();
+    metricAudioSynthCyclesPerSample.set(cps ? cps : chimeMgr.benchmarkCyclesPerSample());
+    metricWifiConnected.set(netMgr.isConnected() ? 1 : 0);
+    metricWifiRssi.set(netMgr.isConnected() ? WiFi.RSSI() : 0);
+    metricWifiReconnects.set(netMgr.reconnectCount());
+    metricWifiOutageTotalMs.set(netMgr.totalOutageMs());
+    metricWifiBootToConnectedMs.set(netMgr.bootToConnectedMs());
+    metricCpuFrequencyMhz.set(getCpuFrequencyMhz());
+}
+
 void setup() {
     Serial.begin(115200);
     Serial.println("=== Memory Diagnostics ===");
@@ -54,120 +189,108 @@ void setup() {
 #if CONFIG_SPIRAM_SUPPORT
     Serial.printf("PSRAM total/free: %u / %u\n", ESP.getPsramSize(), ESP.getFreePsram());
 #endif
+
+    // Clock policy first: everything after this may take power locks
+    powerMgr.begin();
+
+    // Read all persisted settings once, before any manager needs them
+    configStore.begin();
     
+    dispMgr.setPowerManager(&powerMgr);
     dispMgr.begin();
     dispMgr.drawStaticInterface();
     dispMgr.updateHeaderText("TouchClock");
     
-    // Initialize RGB LED manager and turn it off
+    // RGB LED stays dark until the first forecast gives it a tint
+    rgbLed.setPowerManager(&powerMgr);
     rgbLed.begin();
-    rgbLed.off();
 
-    // Initialize light sensor (runs on Core 1)
-    // Pass null callback - RGB LED is disabled for now
-    lightSensor.begin(&dispMgr, nullptr);
+    // loop() wakes early for its events (setup() runs in the loop task)
+    loopSubscriber = eventBus.subscribe("loop", LOOP_EVENTS, EventBus::notifyTask, xTaskGetCurrentTaskHandle());
 
-    // Initialize chime (default speaker pin = 26 on CYD)
+    // Light sensor readings run in the sensor hub; its average dims the LED at night
+    lightSensor.begin(&dispMgr, &sensorHub, &eventBus, onAmbientLight);
+
+    // Initialize chime (speaker on GPIO26 via I2S DAC; audio task idles until a chime)
     chimeMgr.begin();
     chimeMgr.setVolume(10);  // Set volume to 10%
+    chimeMgr.setStrikeCallback(onChimeStrike, nullptr);
+    chimeMgr.setPlaybackCallback(onChimePlayback, nullptr);
 
-    // Initialize touch manager (runs on Core 1)
-    touchMgr.begin(&dispMgr);
+    // Touch: PENIRQ wakes sampling in the sensor hub
+    touchMgr.begin(&dispMgr, &sensorHub);
     touchMgr.setChimeManager(&chimeMgr);
+    touchMgr.setConfigStore(&configStore);
+    touchMgr.setEventBus(&eventBus);
+
+    // One Core 1 task for every sensor registered above
+    sensorHub.begin();
 
     // Pass display to NetworkManager so it can show connection progress
     netMgr.setDisplay(&dispMgr);
     netMgr.setWeatherManager(&weatherMgr);
+    netMgr.setConfigStore(&configStore);
+    netMgr.setEventBus(&eventBus);
+    weatherMgr.setConfigStore(&configStore);
+    weatherMgr.setEventBus(&eventBus);
+    timeMgr.setConfigStore(&configStore);
+    timeMgr.setEventBus(&eventBus);
+    Metrics::setCollectHook(collectMetrics);
+
+    // Fetchers stay paused until the supervisor reports the link is up
+    weatherMgr.setPaused(true);
+    timeMgr.setPaused(true);
     
-    // Check if we have stored credentials first
     if (netMgr.hasStoredCredentials()) {
         dispMgr.showStatus("Connecting to WiFi...");
-    } else {
-        // Show provisioning instructions before blocking
-        dispMgr.showInstruction(String("Connect to ") + netMgr.apName() + "\nOpen a browser to configure WiFi");
-        dispMgr.showStatus("Waiting for WiFi setup...");
-    }
-    
-    // Try to connect (will use stored credentials if available, or start provisioning AP)
-    // If AP mode needed, this returns false but the HTTP server is now running
-    bool connected = netMgr.begin();
-    
-    static bool timeInitialized = false;
-    
-    // If we have stored credentials, wait for connection
-    if (!connected && netMgr.hasStoredCredentials()) {
-        // Retry connection attempt
-        unsigned long connStart = millis();
-        while (WiFi.status() != WL_CONNECTED && millis() - connStart < 30000) {
-            netMgr.update();  // Handle HTTP requests
-            delay(100);
-        }
-        connected = (WiFi.status() == WL_CONNECTED);
     }
     
-    // If connected or provisioned, proceed with initialization
-    if (connected || netMgr.isProvisioned()) {
-        dispMgr.clearInstructions();
-        if (WiFi.status() == WL_CONNECTED) {
-            dispMgr.showStatus(String("WiFi: ") + WiFi.SSID());
-            WiFi.setSleep(WIFI_PS_NONE);
-            if (!timeInitialized) {
-                timeMgr.begin(&dispMgr);
-                timeInitialized = true;
-            }
-        }
-    }
-    
-    // Initialize display and weather even if WiFi not ready yet
-    if (!timeInitialized && WiFi.status() == WL_CONNECTED) {
-        timeMgr.begin(&dispMgr);
-        timeInitialized = true;
-        weatherMgr.refresh(&dispMgr);
-    }
-    
-    if (timeInitialized) {
-        String timeStr = timeMgr.getFormattedTime();
-        String dateStr = timeMgr.getFormattedDate();
-        dispMgr.updateClock(timeStr);
-        dispMgr.updateDate(dateStr);
-        Serial.println(timeStr);
-        Serial.println(dateStr);
-    }
+    // Non-blocking: connects with stored credentials or starts the provisioning AP.
+    // Progress, retries and AP fallback are driven from netMgr.update() in loop().
+    netMgr.begin();
 }
 
 void loop() {
     // No LVGL — standard loop timing only
+    uint32_t loopStartUs = micros();
     
-    // Check if screen is off and wake on any touch
-    static unsigned long lastTouchCheckTime = 0;
-    if (!lightSensor.isScreenOn() && (millis() - lastTouchCheckTime > 100)) {
-        // Sample touch to detect if user touched (simple polling)
-        if (touchMgr.hasPendingEvents()) {
-            lightSensor.wakeScreenFromTouch();
-            lastTouchCheckTime = millis();
-        }
-    }
-
     // Pump touch events from queue (non-LVGL)
     touchMgr.update();
+    // Debug mode also streams light readings for tools/light_replay.cpp
+    lightSensor.setTrace(touchMgr.isDebugMode());
 
     // Update non-blocking chime audio generation
     chimeMgr.update();
 
-    // Update network server (handle HTTP requests from provisioning or config pages)
+    // LED keyframes: the hardware fades between them on its own
+    rgbLed.update();
+
+    // Update network server and connectivity supervisor (never blocks)
     netMgr.update();
 
-    // Keep attempting NTP sync until successful
-    timeMgr.maybeEnsureSynced(&dispMgr);
+    // Screen, link, location, time and forecast changes from every task
+    Event event;
+    while (eventBus.poll(loopSubscriber, event)) {
+        handleEvent(event);
+    }
 
-    // Check if location was updated via config page - force immediate weather refresh
-    if (netMgr.checkAndClearLocationUpdated()) {
-        Serial.println("[Main Loop] Location updated flag detected, forcing weather refresh");
-        weatherMgr.refresh(&dispMgr);
-        // Refresh timezone for new coordinates and resync time
-        timeMgr.refreshTimezone(weatherMgr.getLatitude(), weatherMgr.getLongitude(), &dispMgr);
+    // Write back settings changes once they have settled
+    configStore.update();
+
+    // Touch calibration owns the screen until it finishes
+    if (touchMgr.checkAndClearRedrawNeeded()) {
+        redrawScreen();
+    }
+    if (touchMgr.isCalibrating()) {
+        metricLoopDuration.observe(micros() - loopStartUs);
+        powerMgr.update();
+        EventBus::waitNotified(PowerManager::LOOP_WAIT_MS);
+        return;
     }
 
+    // Keep attempting NTP sync until successful
+    timeMgr.maybeEnsureSynced(&dispMgr);
+
     // Get current time with millisecond precision
     unsigned long currentMillis = millis();
     
@@ -218,7 +341,11 @@ void loop() {
             String newStatus;
             switch (statusIndex) {
                 case 0:
-                    newStatus = String("Connected to: ") + WiFi.SSID() + " - IP: " + WiFi.localIP().toString();
+                    if (netMgr.isConnected()) {
+                        newStatus = String("Connected to: ") + WiFi.SSID() + " - IP: " + WiFi.localIP().toString();
+                    } else {
+                        newStatus = String("WiFi: ") + netMgr.connectivityStateName();
+                    }
                     break;
                 case 1:
                     newStatus = timeMgr.isSynced() ? String("Time from: ") + timeMgr.getNtpServer() : "WARNING: Time sync FAILED!";
@@ -237,6 +364,10 @@ void loop() {
         lastDisplayedTown = currentTown;
         dispMgr.updateHeaderText("TouchClock", currentTown);
     }
-    
-    delay(5);
+
+    metricLoopDuration.observe(micros() - loopStartUs);
+    // Drop the clock if nothing needs it, then wait: 5 ms with the screen on, up to the next
+    // second with it off, or until an event is published
+    powerMgr.update();
+    EventBus::waitNotified(powerMgr.loopWaitMs());
 }
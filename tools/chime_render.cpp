@@ -0,0 +1,326 @@
+// Offline render of the hourly chimes through the real ChimeManager code path.
+//
+//   g++ -O2 -std=gnu++17 -Ihal/native -Isrc tools/chime_render.cpp src/ChimeManager.cpp
+//       src/BellSynth.cpp src/Wavetable.cpp src/Metrics.cpp hal/native/hal_native.cpp -o chime_render
+//   ./chime_render [--out DIR] [--quarters] [--volume PCT] [--verbose]
+//
+// For every hour of the day (and each quarter with --quarters) the clock is set two seconds
+// before the slot on a virtual timeline, maybeChime() is called once per audio block exactly
+// as loop() would, and blocks are pulled through ChimeManager::render() the way the audio
+// task does. Each slot reports:
+//   strikes   - strikes found in the output vs. the number the program should play
+//   onset     - max / mean distance of each strike's first audible sample from its
+//               place on the bytecode schedule (ms)
+//   length    - time from the first onset until render() reported the end, vs. the
+//               programme length without ring-out (chime::programDurationMs)
+//   clips     - samples saturated by the synth, and 8-bit DAC codes pinned at 0 or 255
+//   cost      - host ns per sample for render(), and the synth's own cycles/sample figure
+// With --out, each slot is also written as an 8-bit mono WAV of the DAC codes the speaker
+// would receive. The exit status is non-zero if any slot misses a strike, clips, or is off
+// by more than the onset tolerance, or never reports its finish back to loop().
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+#include "ChimeManager.h"
+#include "hal_native.h"
+
+static const uint32_t SAMPLE_RATE = AudioOutput::SAMPLE_RATE;
+static const size_t BLOCK = AudioOutput::BLOCK_FRAMES;
+static const uint32_t LEAD_IN_MS = 2000;       // simulated time before the slot starts
+static const uint32_t MAX_SLOT_MS = 60000;     // longest render per slot
+static const double ONSET_TOLERANCE_MS = 1.0;  // about one 1 kHz period
+
+// Expected strike times (ms from program start), walked from the bytecode independently of
+// ChimeSequencer so the two implementations check each other
+static std::vector<uint32_t> expectedOnsetsMs(const ChimeOp* op, uint8_t strikeCount) {
+    std::vector<uint32_t> onsets;
+    uint32_t t = 0, unit = 600, gapMs = 80;
+    for (; op->code != ChimeOp::END; op++) {
+        switch (op->code) {
+            case ChimeOp::DURATION: unit = op->value; break;
+            case ChimeOp::GAP: gapMs = op->value; break;
+            case ChimeOp::NOTE:
+                onsets.push_back(t);
+                t += unit * op->arg + gapMs;
+                break;
+            case ChimeOp::STRIKES:
+                for (int i = 0; i < (op->arg ? op->arg : strikeCount); i++) {
+                    onsets.push_back(t);
+                    t += unit + gapMs;
+                }
+                break;
+            case ChimeOp::REST: t += op->value; break;
+            default: break;
+        }
+    }
+    return onsets;
+}
+
+// The same program cut off after its first `keep` strikes (NOTE = one strike, STRIKES = n)
+static std::vector<ChimeOp> prefixProgram(const ChimeOp* op, uint8_t strikeCount, size_t keep) {
+    std::vector<ChimeOp> out;
+    for (; op->code != ChimeOp::END && keep > 0; op++) {
+        if (op->code == ChimeOp::NOTE) {
+            keep--;
+        } else if (op->code == ChimeOp::STRIKES) {
+            size_t n = std::min<size_t>(op->arg ? op->arg : strikeCount, keep);
+            keep -= n;
+            if (n == 0) continue;
+            out.push_back(chime::strikes(op->value, (uint8_t)n));
+            continue;
+        }
+        out.push_back(*op);
+    }
+    out.push_back(chime::end());
+    return out;
+}
+
+static void referenceStrike(void* ctx, uint16_t hz, float ring, uint16_t offset) {
+    static_cast<BellSynth*>(ctx)->strike(hz, 1.0f, ring, offset);
+}
+
+// Onset of each strike as it appears in the output. The render is deterministic, so the
+// output of the program cut off just before strike k is identical to the full output up
+// to the sample where strike k starts to sound; the first sample that differs is its
+// onset. Unlike an energy detector this is not fooled by beating between ringing voices.
+// Each new voice starts at phase 0, so the first audible sample is 1-2 samples after the
+// scheduled one (<0.1 ms). Returns -1 for a strike that never appears.
+static std::vector<int64_t> measureOnsets(const std::vector<int16_t>& pcm, size_t start,
+                                          const ChimeOp* program, uint8_t strikeCount,
+                                          const std::vector<uint32_t>& expectedMs, uint8_t volume) {
+    std::vector<int64_t> onsets;
+    int16_t block[BLOCK];
+    for (size_t k = 0; k < expectedMs.size(); k++) {
+        std::vector<ChimeOp> prefix = prefixProgram(program, strikeCount, k);
+        BellSynth synth;
+        synth.begin(SAMPLE_RATE, BLOCK);
+        synth.setVolume(volume);
+        ChimeSequencer sequencer;
+        sequencer.begin(SAMPLE_RATE, referenceStrike, &synth);
+        sequencer.start(prefix.data(), 0);
+
+        // Search up to a whole tolerance window past the expected onset
+        size_t limit = start + (size_t)((uint64_t)expectedMs[k] * SAMPLE_RATE / 1000) + SAMPLE_RATE / 20;
+        int64_t onset = -1;
+        for (size_t pos = start; pos < limit && pos + BLOCK <= pcm.size() && onset < 0; pos += BLOCK) {
+            sequencer.advance(BLOCK);
+            synth.render(block, BLOCK);
+            for (size_t i = 0; i < BLOCK; i++) {
+                if (block[i] != pcm[pos + i]) {
+                    onset = (int64_t)(pos + i);
+                    break;
+                }
+            }
+        }
+        onsets.push_back(onset);
+    }
+    return onsets;
+}
+
+static bool writeWav(const std::string& path, const std::vector<uint8_t>& codes) {
+    FILE* f = fopen(path.c_str(), "wb");
+    if (!f) return false;
+    auto u32 = [f](uint32_t v) { fwrite(&v, 4, 1, f); };
+    auto u16 = [f](uint16_t v) { fwrite(&v, 2, 1, f); };
+    uint32_t dataBytes = (uint32_t)codes.size();
+    fwrite("RIFF", 1, 4, f);
+    u32(36 + dataBytes);
+    fwrite("WAVEfmt ", 1, 8, f);
+    u32(16);
+    u16(1);            // PCM
+    u16(1);            // mono
+    u32(SAMPLE_RATE);
+    u32(SAMPLE_RATE);  // byte rate
+    u16(1);            // block align
+    u16(8);            // 8-bit unsigned, same offset-binary coding as the DAC
+    fwrite("data", 1, 4, f);
+    u32(dataBytes);
+    fwrite(codes.data(), 1, codes.size(), f);
+    fclose(f);
+    return true;
+}
+
+struct SlotResult {
+    size_t expected = 0;
+    size_t detected = 0;
+    double maxErrorMs = 0;
+    double meanErrorMs = 0;
+    uint32_t lengthMs = 0;
+    uint32_t programMs = 0;
+    uint32_t synthClips = 0;
+    uint32_t dacClips = 0;
+    double nsPerSample = 0;
+    uint32_t cyclesPerSample = 0;
+    bool ok = true;
+};
+
+static const ChimeOp* programFor(int hour, int quarter, bool quarters, uint8_t& strikes) {
+    strikes = 0;
+    if (hour < 8 || hour >= 22) return nullptr;
+    if (quarter == 0) {
+        strikes = (uint8_t)(((hour + 11) % 12) + 1);
+        return chime::WESTMINSTER_HOUR;
+    }
+    if (!quarters) return nullptr;
+    static const ChimeOp* const QUARTER_PROGRAMS[] = {
+        nullptr, chime::WESTMINSTER_QUARTER, chime::WESTMINSTER_HALF, chime::WESTMINSTER_THREE_QUARTER
+    };
+    return QUARTER_PROGRAMS[quarter];
+}
+
+static SlotResult renderSlot(int hour, int quarter, bool quarters, uint8_t volume,
+                             std::vector<uint8_t>& codes) {
+    SlotResult r;
+    uint8_t strikes = 0;
+    const ChimeOp* program = programFor(hour, quarter, quarters, strikes);
+
+    ChimeManager chime;
+    chime.setVolume(volume);
+    chime.begin();
+    chime.setQuarterChimes(quarters);
+
+    // Virtual wall clock: slot start minus the lead-in
+    int slotSec = hour * 3600 + quarter * 15 * 60;
+    uint64_t renderedSamples = 0;
+    uint64_t renderNs = 0;
+    int64_t startSample = -1;  // block in which the audio side picked the program up
+    int64_t endSample = -1;
+    std::vector<int16_t> pcm;
+    int16_t block[BLOCK];
+
+    uint64_t maxSamples = (uint64_t)(LEAD_IN_MS + MAX_SLOT_MS) * SAMPLE_RATE / 1000;
+    halSetMicros(0);
+    while (renderedSamples < maxSamples) {
+        uint64_t nowMs = renderedSamples * 1000 / SAMPLE_RATE;
+        int wall = slotSec - (int)(LEAD_IN_MS / 1000) + (int)(nowMs / 1000);
+        wall = (wall + 86400) % 86400;
+        tm t = {};
+        t.tm_hour = wall / 3600;
+        t.tm_min = (wall / 60) % 60;
+        t.tm_sec = wall % 60;
+        chime.maybeChime(t);
+        chime.update();
+
+        bool wasIdle = startSample < 0;
+        bool pending = chime.isPlaying();
+        auto t0 = std::chrono::steady_clock::now();
+        bool more = chime.render(block, BLOCK);
+        renderNs += (uint64_t)std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now() - t0).count();
+        if (wasIdle && pending) startSample = (int64_t)renderedSamples;
+
+        pcm.insert(pcm.end(), block, block + BLOCK);
+        renderedSamples += BLOCK;
+        halAdvanceMicros((uint64_t)BLOCK * 1000000 / SAMPLE_RATE);
+
+        if (startSample >= 0 && !more) {
+            endSample = (int64_t)renderedSamples;
+            break;
+        }
+        // Nothing scheduled: a few seconds past the slot is enough to show silence
+        if (!program && nowMs > LEAD_IN_MS + 3000) break;
+    }
+    chime.update();  // collect the finish report, as the next loop() would
+
+    codes.resize(pcm.size());
+    for (size_t i = 0; i < pcm.size(); i++) {
+        codes[i] = AudioOutput::dacCode(pcm[i]);
+        if (codes[i] == 0 || codes[i] == 255) r.dacClips++;
+    }
+    r.synthClips = chime.clipCount();
+    r.nsPerSample = renderedSamples ? (double)renderNs / renderedSamples : 0;
+    r.cyclesPerSample = chime.synthCyclesPerSample();
+
+    if (!program) {
+        // Quiet slot: nothing may start and the output must stay at mid-scale
+        bool silent = true;
+        for (int16_t v : pcm) silent = silent && v == 0;
+        r.ok = startSample < 0 && silent;
+        return r;
+    }
+    if (startSample < 0) {
+        r.ok = false;
+        return r;
+    }
+
+    std::vector<uint32_t> expected = expectedOnsetsMs(program, strikes);
+    r.expected = expected.size();
+    r.programMs = chime::programDurationMs(program, strikes);
+    r.lengthMs = endSample >= 0 ? (uint32_t)((endSample - startSample) * 1000 / SAMPLE_RATE) : 0;
+
+    std::vector<int64_t> onsets = measureOnsets(pcm, (size_t)startSample, program, strikes, expected, volume);
+    double sumError = 0;
+    for (size_t k = 0; k < expected.size(); k++) {
+        if (onsets[k] < 0) continue;
+        double want = (double)startSample + (double)((uint64_t)expected[k] * SAMPLE_RATE / 1000);
+        double errorMs = std::fabs((double)onsets[k] - want) * 1000.0 / SAMPLE_RATE;
+        r.detected++;
+        r.maxErrorMs = std::max(r.maxErrorMs, errorMs);
+        sumError += errorMs;
+    }
+    r.meanErrorMs = r.detected ? sumError / r.detected : 0;
+
+    r.ok = r.detected == r.expected && r.maxErrorMs <= ONSET_TOLERANCE_MS &&
+           r.synthClips == 0 && r.dacClips == 0 && endSample >= 0 && r.lengthMs >= r.programMs &&
+           !chime.isPlaying();
+    return r;
+}
+
+int main(int argc, char** argv) {
+    std::string outDir;
+    bool quarters = false;
+    bool verbose = false;
+    int volume = 5;
+    for (int i = 1; i < argc; i++) {
+        if (!strcmp(argv[i], "--out") && i + 1 < argc) {
+            outDir = argv[++i];
+        } else if (!strcmp(argv[i], "--quarters")) {
+            quarters = true;
+        } else if (!strcmp(argv[i], "--volume") && i + 1 < argc) {
+            volume = atoi(argv[++i]);
+        } else if (!strcmp(argv[i], "--verbose")) {
+            verbose = true;
+        } else {
+            fprintf(stderr, "usage: %s [--out DIR] [--quarters] [--volume PCT] [--verbose]\n", argv[0]);
+            return 2;
+        }
+    }
+
+    halUseVirtualClock(true);
+    halSetSerialOutput(verbose ? stderr : nullptr);
+
+    printf("Chime render: %lu Hz, %u-frame blocks, volume %d%%, onset tolerance %.1f ms\n\n",
+           (unsigned long)SAMPLE_RATE, (unsigned)BLOCK, volume, ONSET_TOLERANCE_MS);
+    printf("slot   strikes  onset max/mean ms  length/program ms  clips synth/dac  ns/sample  cyc/sample\n");
+
+    int failures = 0;
+    for (int hour = 0; hour < 24; hour++) {
+        for (int quarter = 0; quarter < (quarters ? 4 : 1); quarter++) {
+            std::vector<uint8_t> codes;
+            SlotResult r = renderSlot(hour, quarter, quarters, (uint8_t)volume, codes);
+            if (!r.ok) failures++;
+
+            printf("%02d:%02d  %3zu/%-3zu  %8.2f / %-6.2f  %7lu / %-7lu  %6lu / %-6lu  %9.1f  %10lu  %s\n",
+                   hour, quarter * 15, r.detected, r.expected, r.maxErrorMs, r.meanErrorMs,
+                   (unsigned long)r.lengthMs, (unsigned long)r.programMs,
+                   (unsigned long)r.synthClips, (unsigned long)r.dacClips,
+                   r.nsPerSample, (unsigned long)r.cyclesPerSample, r.ok ? "ok" : "FAIL");
+
+            if (!outDir.empty()) {
+                char name[32];
+                snprintf(name, sizeof(name), "/chime_%02d%02d.wav", hour, quarter * 15);
+                if (!writeWav(outDir + name, codes)) {
+                    fprintf(stderr, "Cannot write %s%s\n", outDir.c_str(), name);
+                    return 2;
+                }
+            }
+        }
+    }
+
+    printf("\n%s (%d failing slot%s)\n", failures ? "FAIL" : "OK", failures, failures == 1 ? "" : "s");
+    return failures ? 1 : 0;
+}
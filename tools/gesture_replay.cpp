@@ -0,0 +1,228 @@
+// Replays touch traces through GestureEngine on the host.
+//
+//   g++ -O2 -std=gnu++17 -Isrc tools/gesture_replay.cpp -o gesture_replay
+//   ./gesture_replay trace.log      # replay a recorded trace (or - for stdin)
+//   ./gesture_replay --selftest     # scripted traces with known answers
+//
+// Trace lines are "<P|M|R> x y timestamp_us", optionally prefixed with "[TouchTrace]" so the
+// serial log of a device in touch debug mode (triple-tap the version label) can be fed in
+// unchanged; other lines are ignored. Between events the engine is ticked every 5 ms, like
+// loop() does on the device, so long-presses fire at the same point they would there.
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <vector>
+#include "GestureEngine.h"
+
+static const uint32_t TICK_US = 5000;
+
+struct Replay {
+    GestureEngine engine;
+    std::vector<Gesture> gestures;
+    uint32_t nowUs = 0;
+    bool started = false;
+
+    void drain() {
+        Gesture g;
+        while (engine.poll(g)) gestures.push_back(g);
+    }
+
+    void advanceTo(uint32_t us) {
+        if (started) {
+            // Signed distance so traces may cross the 32-bit micros() wrap
+            while ((int32_t)(us - nowUs) > (int32_t)TICK_US) {
+                nowUs += TICK_US;
+                engine.tick(nowUs);
+                drain();
+            }
+        }
+        nowUs = us;
+        started = true;
+    }
+
+    void event(TouchEventType type, uint16_t x, uint16_t y, uint32_t us) {
+        advanceTo(us);
+        engine.feed({type, x, y, us});
+        drain();
+    }
+
+    void finish(uint32_t idleUs = 3000000) {
+        advanceTo(nowUs + idleUs);
+        engine.tick(nowUs);
+        drain();
+    }
+};
+
+static void printGestures(const std::vector<Gesture>& gestures, uint32_t originUs) {
+    for (const Gesture& g : gestures) {
+        printf("%10.3f ms  %-11s at (%3u,%3u)", (uint32_t)(g.timestampUs - originUs) / 1000.0,
+               GestureEngine::name(g.type), g.x, g.y);
+        if (g.dx || g.dy) printf("  d=(%d,%d)", g.dx, g.dy);
+        printf("\n");
+    }
+}
+
+static int replayFile(const char* path) {
+    FILE* f = strcmp(path, "-") == 0 ? stdin : fopen(path, "r");
+    if (!f) {
+        fprintf(stderr, "Cannot open %s\n", path);
+        return 2;
+    }
+    Replay replay;
+    uint32_t originUs = 0;
+    size_t events = 0;
+    char line[256];
+    while (fgets(line, sizeof(line), f)) {
+        const char* p = strstr(line, "[TouchTrace]");
+        p = p ? p + strlen("[TouchTrace]") : line;
+        char kind;
+        unsigned x, y;
+        unsigned long us;
+        if (sscanf(p, " %c %u %u %lu", &kind, &x, &y, &us) != 4) continue;
+        const char* types = "PMR";
+        const char* t = strchr(types, kind);
+        if (!t || kind == '\0') continue;
+        if (events++ == 0) originUs = (uint32_t)us;
+        replay.event((TouchEventType)(t - types), (uint16_t)x, (uint16_t)y, (uint32_t)us);
+    }
+    if (f != stdin) fclose(f);
+    replay.finish();
+
+    printf("%zu events -> %zu gestures\n", events, replay.gestures.size());
+    printGestures(replay.gestures, originUs);
+    return 0;
+}
+
+// --- Scripted traces ---
+
+struct Script {
+    Replay replay;
+    uint32_t t;
+
+    explicit Script(uint32_t startUs = 1000000) : t(startUs) {}
+
+    void wait(uint32_t ms) { t += ms * 1000; }
+
+    void tap(uint16_t x, uint16_t y, uint32_t holdMs = 80) {
+        replay.event(TOUCH_PRESS, x, y, t);
+        wait(holdMs);
+        replay.event(TOUCH_RELEASE, x, y, t);
+    }
+
+    void hold(uint16_t x, uint16_t y, uint32_t ms, uint16_t jitter = 0) {
+        replay.event(TOUCH_PRESS, x, y, t);
+        for (uint32_t elapsed = 0; elapsed < ms; elapsed += 50) {
+            wait(50);
+            if (jitter) replay.event(TOUCH_MOVE, x + (elapsed / 50 % 2) * jitter, y, t);
+        }
+        replay.event(TOUCH_RELEASE, x, y, t);
+    }
+
+    // Straight drag in `steps` 5 ms samples
+    void drag(uint16_t x0, uint16_t y0, uint16_t x1, uint16_t y1, uint32_t ms) {
+        replay.event(TOUCH_PRESS, x0, y0, t);
+        uint32_t steps = ms / 5;
+        for (uint32_t i = 1; i <= steps; i++) {
+            wait(5);
+            replay.event(TOUCH_MOVE, (uint16_t)(x0 + ((int)x1 - x0) * (int)i / (int)steps),
+                         (uint16_t)(y0 + ((int)y1 - y0) * (int)i / (int)steps), t);
+        }
+        replay.event(TOUCH_RELEASE, x1, y1, t);
+    }
+};
+
+struct Case {
+    const char* name;
+    void (*run)(Script&);
+    std::vector<GestureType> expected;
+};
+
+static int selfTest() {
+    const Case cases[] = {
+        {"single tap", [](Script& s) { s.tap(100, 100); }, {GESTURE_TAP}},
+        {"double tap", [](Script& s) { s.tap(100, 100); s.wait(150); s.tap(102, 99); },
+         {GESTURE_TAP, GESTURE_DOUBLE_TAP}},
+        {"triple tap", [](Script& s) { for (int i = 0; i < 3; i++) { s.tap(100, 100); s.wait(150); } },
+         {GESTURE_TAP, GESTURE_DOUBLE_TAP, GESTURE_TRIPLE_TAP}},
+        {"four taps start over", [](Script& s) { for (int i = 0; i < 4; i++) { s.tap(100, 100); s.wait(150); } },
+         {GESTURE_TAP, GESTURE_DOUBLE_TAP, GESTURE_TRIPLE_TAP, GESTURE_TAP}},
+        {"taps too slow", [](Script& s) { s.tap(100, 100); s.wait(600); s.tap(100, 100); },
+         {GESTURE_TAP, GESTURE_TAP}},
+        {"taps too far apart", [](Script& s) { s.tap(100, 100); s.wait(100); s.tap(200, 100); },
+         {GESTURE_TAP, GESTURE_TAP}},
+        {"long press", [](Script& s) { s.hold(30, 20, 2500); }, {GESTURE_LONG_PRESS}},
+        {"long press with jitter", [](Script& s) { s.hold(30, 20, 2500, 4); }, {GESTURE_LONG_PRESS}},
+        {"short hold is a tap", [](Script& s) { s.hold(30, 20, 1500); }, {GESTURE_TAP}},
+        {"tap after long press", [](Script& s) { s.hold(30, 20, 2200); s.wait(100); s.tap(30, 20); },
+         {GESTURE_LONG_PRESS, GESTURE_TAP}},
+        {"swipe left", [](Script& s) { s.drag(250, 120, 100, 125, 200); }, {GESTURE_SWIPE_LEFT}},
+        {"swipe right", [](Script& s) { s.drag(100, 120, 250, 110, 200); }, {GESTURE_SWIPE_RIGHT}},
+        {"swipe up", [](Script& s) { s.drag(160, 200, 165, 60, 250); }, {GESTURE_SWIPE_UP}},
+        {"swipe down", [](Script& s) { s.drag(160, 60, 150, 200, 250); }, {GESTURE_SWIPE_DOWN}},
+        {"slow drag", [](Script& s) { s.drag(100, 120, 250, 120, 1500); }, {}},
+        {"diagonal drag", [](Script& s) { s.drag(100, 60, 200, 160, 200); }, {}},
+        {"short drag", [](Script& s) { s.drag(100, 120, 130, 120, 100); }, {}},
+        {"drag does not count as a tap", [](Script& s) { s.tap(100, 100); s.wait(100); s.drag(100, 100, 160, 100, 100); s.wait(100); s.tap(100, 100); },
+         {GESTURE_TAP, GESTURE_SWIPE_RIGHT, GESTURE_TAP}},
+    };
+
+    int failures = 0;
+    auto check = [&failures](const char* name, const std::vector<Gesture>& got,
+                             const std::vector<GestureType>& want, uint32_t origin) {
+        bool ok = got.size() == want.size();
+        for (size_t i = 0; ok && i < got.size(); i++) ok = got[i].type == want[i];
+        printf("%-34s %s\n", name, ok ? "ok" : "FAIL");
+        if (!ok) {
+            failures++;
+            printf("  expected:");
+            for (GestureType t : want) printf(" %s", GestureEngine::name(t));
+            printf("\n  got:\n");
+            printGestures(got, origin);
+        }
+    };
+
+    for (const Case& c : cases) {
+        Script s;
+        uint32_t origin = s.t;
+        c.run(s);
+        s.replay.finish();
+        check(c.name, s.replay.gestures, c.expected, origin);
+    }
+
+    // micros() wraps every ~71.6 minutes; a triple tap and a long press across the wrap
+    {
+        Script s(0xFFFFFFFFu - 300000);
+        uint32_t origin = s.t;
+        for (int i = 0; i < 3; i++) {
+            s.tap(100, 100);
+            s.wait(150);
+        }
+        s.hold(30, 20, 2500);
+        s.replay.finish();
+        check("across the micros() wrap", s.replay.gestures,
+              {GESTURE_TAP, GESTURE_DOUBLE_TAP, GESTURE_TRIPLE_TAP, GESTURE_LONG_PRESS}, origin);
+    }
+
+    // The long press must fire while the pen is down, not on release
+    {
+        Script s;
+        s.hold(30, 20, 3000);
+        s.replay.finish();
+        const std::vector<Gesture>& g = s.replay.gestures;
+        uint32_t firedAfterMs = g.empty() ? 0 : (g[0].timestampUs - 1000000) / 1000;
+        bool ok = g.size() == 1 && firedAfterMs >= 2000 && firedAfterMs <= 2000 + TICK_US / 1000;
+        printf("%-34s %s (fired %u ms after press)\n", "long press fires while held", ok ? "ok" : "FAIL",
+               (unsigned)firedAfterMs);
+        if (!ok) failures++;
+    }
+
+    printf("\n%s (%d failing case%s)\n", failures ? "FAIL" : "OK", failures, failures == 1 ? "" : "s");
+    return failures ? 1 : 0;
+}
+
+int main(int argc, char** argv) {
+    if (argc == 2 && strcmp(argv[1], "--selftest") == 0) return selfTest();
+    if (argc == 2) return replayFile(argv[1]);
+    fprintf(stderr, "usage: %s <trace.log | -> | --selftest\n", argv[0]);
+    return 2;
+}
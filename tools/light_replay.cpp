@@ -0,0 +1,213 @@
+// Replays ambient light readings through the firmware's light model (AmbientLight.h):
+// rolling averages, the adaptive baseline and bright-light detection, one reading every
+// 500 ms exactly as the sensor hub feeds it.
+//
+//   g++ -O2 -std=gnu++17 -Isrc tools/light_replay.cpp -o light_replay
+//   ./light_replay serial.log          # replay [LightTrace] lines (or - for stdin)
+//   ./light_replay --selftest          # synthetic traces with known answers
+//
+// In touch debug mode (triple-tap the version label) the light sensor prints every reading
+// as "[LightTrace] <mV> base <mV>"; capture the serial log and replay it here. Lines that
+// are just a number are accepted too, other lines are ignored.
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <utility>
+#include <vector>
+#include "AmbientLight.h"
+
+struct Result {
+    std::vector<size_t> brightAt;  // reading index of each BRIGHT_LIGHT event
+    size_t calibratedAt = 0;
+    uint16_t finalBaseline = 0;
+};
+
+static Result run(const std::vector<uint16_t>& mv, bool verbose) {
+    Result r;
+    if (mv.empty()) return r;
+    AmbientLight light;
+    light.begin(mv[0]);
+    for (size_t i = 0; i < mv.size(); i++) {
+        AmbientLight::Event e = light.add(mv[i]);
+        double t = i * AmbientLight::SAMPLE_INTERVAL_MS / 1000.0;
+        switch (e) {
+            case AmbientLight::CALIBRATED:
+                r.calibratedAt = i;
+                if (verbose) printf("%8.1f s  calibrated: baseline %u mV, threshold %u mV\n", t, light.baseline(), light.threshold());
+                break;
+            case AmbientLight::BRIGHT_LIGHT:
+                r.brightAt.push_back(i);
+                if (verbose) printf("%8.1f s  BRIGHT LIGHT at %u mV (baseline %u mV)\n", t, light.median(), light.baseline());
+                break;
+            case AmbientLight::BRIGHT_LIGHT_GONE:
+                if (verbose) printf("%8.1f s  bright light gone at %u mV\n", t, light.median());
+                break;
+            default:
+                break;
+        }
+    }
+    r.finalBaseline = light.baseline();
+    if (verbose) {
+        printf("\n%zu readings (%.1f s), %zu bright-light event%s, final baseline %u mV\n", mv.size(),
+               mv.size() * AmbientLight::SAMPLE_INTERVAL_MS / 1000.0, r.brightAt.size(),
+               r.brightAt.size() == 1 ? "" : "s", r.finalBaseline);
+    }
+    return r;
+}
+
+static int replayFile(const char* path) {
+    FILE* f = strcmp(path, "-") == 0 ? stdin : fopen(path, "r");
+    if (!f) {
+        perror(path);
+        return 1;
+    }
+    std::vector<uint16_t> mv;
+    char line[256];
+    while (fgets(line, sizeof(line), f)) {
+        const char* p = strstr(line, "[LightTrace]");
+        p = p ? p + strlen("[LightTrace]") : line;
+        char* end;
+        long v = strtol(p, &end, 10);
+        if (end != p && v >= 0 && v <= 3300) mv.push_back((uint16_t)v);
+    }
+    if (f != stdin) fclose(f);
+    if (mv.empty()) {
+        fprintf(stderr, "%s: no light readings found\n", path);
+        return 1;
+    }
+    run(mv, true);
+    return 0;
+}
+
+// Synthetic traces: n readings at 500 ms with a little deterministic ADC noise
+struct Synth {
+    std::vector<uint16_t> mv;
+    uint32_t seed = 7;
+
+    int noise(int amp) {
+        seed = seed * 1103515245u + 12345u;
+        return (int)((seed >> 16) % (2 * amp + 1)) - amp;
+    }
+
+    void hold(int level, size_t n, int amp = 15) {
+        for (size_t i = 0; i < n; i++) mv.push_back((uint16_t)(level + noise(amp)));
+    }
+
+    void ramp(int from, int to, size_t n) {
+        for (size_t i = 0; i < n; i++) mv.push_back((uint16_t)(from + (to - from) * (int)i / (int)n + noise(10)));
+    }
+};
+
+static int selfTest() {
+    int failures = 0;
+    auto check = [&](const char* name, bool ok, const char* detail = "") {
+        printf("%-34s %s%s\n", name, ok ? "ok" : "FAIL", detail);
+        if (!ok) failures++;
+    };
+
+    {
+        Synth s;
+        s.hold(1800, 600);  // 5 minutes of a steady room
+        Result r = run(s.mv, false);
+        check("steady room: no events", r.brightAt.empty());
+        check("calibrates after 10 s", r.calibratedAt == AmbientLight::CALIBRATION_SAMPLES - 1);
+    }
+    {
+        Synth s;
+        s.hold(1800, 60);
+        s.hold(400, 6);  // flashlight for 3 s
+        s.hold(1800, 60);
+        Result r = run(s.mv, false);
+        check("3 s flashlight: one event", r.brightAt.size() == 1);
+    }
+    {
+        Synth s;
+        s.hold(1800, 60);
+        s.hold(400, 2);  // 1 s sweep past the sensor
+        s.hold(1800, 60);
+        check("1 s flash: no event", run(s.mv, false).brightAt.empty());
+    }
+    {
+        // Dawn: the divider falls to 40% over 30 minutes. A baseline fixed at startup
+        // would have blanked the screen half way through.
+        Synth s;
+        s.hold(2000, 40);
+        s.ramp(2000, 800, 3600);
+        s.hold(800, 120);
+        Result r = run(s.mv, false);
+        char detail[48];
+        snprintf(detail, sizeof(detail), " (baseline %u mV)", r.finalBaseline);
+        check("slow daylight drift: no event", r.brightAt.empty(), detail);
+        check("baseline follows the drift", r.finalBaseline < 1000, detail);
+    }
+    {
+        // A light held right at the threshold: readings wander across it while it stays on
+        Synth s;
+        s.hold(1800, 60);
+        for (int i = 0; i < 40; i++) s.hold(i % 3 ? 850 : 1000, 1, 5);
+        s.hold(1800, 60);
+        check("flicker at threshold: one event", run(s.mv, false).brightAt.size() == 1);
+    }
+    {
+        // Single-reading glitches every few seconds
+        Synth s;
+        s.hold(1800, 40);
+        for (int i = 0; i < 20; i++) {
+            s.hold(1800, 5);
+            s.hold(100, 1, 0);
+        }
+        check("single-sample spikes: no event", run(s.mv, false).brightAt.empty());
+    }
+    {
+        // Window statistics against brute force over a random walk
+        Synth s;
+        s.hold(1500, 1, 0);
+        for (int i = 1; i < 500; i++) {
+            int v = s.mv.back() + s.noise(120);
+            s.mv.push_back((uint16_t)(v < 0 ? 0 : v > 3300 ? 3300 : v));
+        }
+        AmbientLight light;
+        light.begin(s.mv[0]);
+        std::vector<uint16_t> seen;  // begin() pre-fills the averages with the first reading
+        for (int i = 0; i < 20; i++) seen.push_back(s.mv[0]);
+        bool avgOk = true, rangeOk = true, medianOk = true;
+        for (size_t i = 0; i < s.mv.size(); i++) {
+            light.add(s.mv[i]);
+            seen.push_back(s.mv[i]);
+            size_t n = seen.size();
+            long sum5 = 0, sum10 = 0;
+            for (size_t k = n - 10; k < n; k++) sum5 += seen[k];
+            for (size_t k = n - 20; k < n; k++) sum10 += seen[k];
+            if (light.average5s() != (sum5 + 5) / 10 || light.average10s() != (sum10 + 10) / 20) avgOk = false;
+
+            size_t from = i + 1 >= 20 ? i + 1 - 20 : 0;  // min/max/median only see real readings
+            uint16_t lo = 0xFFFF, hi = 0;
+            for (size_t k = from; k <= i; k++) {
+                if (s.mv[k] < lo) lo = s.mv[k];
+                if (s.mv[k] > hi) hi = s.mv[k];
+            }
+            if (light.min10s() != lo || light.max10s() != hi) rangeOk = false;
+
+            if (i >= 4) {
+                uint16_t last[5];
+                for (int k = 0; k < 5; k++) last[k] = s.mv[i - 4 + k];
+                for (int a = 1; a < 5; a++)
+                    for (int b = a; b > 0 && last[b - 1] > last[b]; b--) std::swap(last[b - 1], last[b]);
+                if (light.median() != last[2]) medianOk = false;
+            }
+        }
+        check("5 s / 10 s averages match", avgOk);
+        check("10 s min/max match", rangeOk);
+        check("5-reading median matches", medianOk);
+    }
+
+    printf("\n%s (%d failing case%s)\n", failures ? "FAIL" : "OK", failures, failures == 1 ? "" : "s");
+    return failures ? 1 : 0;
+}
+
+int main(int argc, char** argv) {
+    if (argc == 2 && strcmp(argv[1], "--selftest") == 0) return selfTest();
+    if (argc == 2) return replayFile(argv[1]);
+    fprintf(stderr, "usage: %s <serial.log | -> | --selftest\n", argv[0]);
+    return 2;
+}
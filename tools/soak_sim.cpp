@@ -0,0 +1,587 @@
+// Time-warp soak run: the whole firmware (setup(), loop() and every task) for weeks of
+// simulated time in a minute or two, on the native HAL's virtual clock.
+//
+//   g++ -O2 -std=gnu++17 -Ihal/native -Isrc -DTFT_BL=21 -DTOUCH_CS=33 tools/soak_sim.cpp
+//       src/*.cpp hal/native/hal_*.cpp -lpthread -o soak_sim
+//   ./soak_sim [--days N] [--start "YYYY-MM-DD HH:MM"] [--tz POSIX-TZ] [--step MS]
+//              [--drift PPM] [--http-ms MS] [--outage "DAY HH:MM MINUTES wifi|internet"]...
+//              [--no-outages] [--light MV] [--fixtures DIR] [--serial] [--trace]
+//
+// Tasks run in lockstep with loop() (see halRunTasks), so a run is repeatable: the same
+// arguments give the same report. Each loop() pass is followed by a delay up to --step
+// (1 s by default, the clock's own redraw rate), during which the sensor and audio tasks
+// run as due. Real time is --start in the --tz zone; the board's clock drifts against it by
+// --drift ppm until SNTP corrects it. timeapi.io answers with --tz's offsets at the moment
+// of the request; other fetches come from hal/native/fixtures (found from this file's
+// compiled path, or --fixtures) and take --http-ms.
+//
+// Without --outage (or --no-outages) the run scripts three outages: WiFi down for 45 min
+// in an afternoon, the internet gone for 3 h overnight behind a working router, and WiFi
+// down for 30 min across midnight. The light sensor follows a day/night cycle unless
+// --light fixes it.
+//
+// One row per local day:
+//   loops     - loop() passes
+//   draws     - DisplayManager draw calls pushed to the panel / absorbed while asleep
+//   wx ok/err - forecast refreshes (WeatherManager::refresh) by result
+//   tz        - timezone lookups that reached timeapi.io
+//   http      - every HTTP GET attempted
+//   ntp ok/err- TimeManager sync attempts by result; sntp = SNTP requests on the wire
+//   reconn    - WiFi reconnects
+//   chime s   - seconds of audio sent to the DAC
+//   sensor    - sensor hub callback runs
+//   heap      - C++ heap high-water for the day, and bytes live at 03:00 (KB)
+// Then heap by task. The exit status is non-zero if the displayed clock was ever more
+// than 2 s from local time, the date label missed a midnight, a day passed without a
+// forecast, or the 03:00 heap grew by more than 2 KB between the second and last days.
+#include <atomic>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <new>
+#include <string>
+#include <vector>
+#include <Preferences.h>
+#include <unistd.h>
+#include "AudioOutput.h"
+#include "Metrics.h"
+#include "SensorHub.h"
+#include "hal_native.h"
+
+// --- The firmware (main.cpp) ---
+void setup();
+void loop();
+void collectMetrics();
+extern String lastDisplayedTime;
+extern String lastDisplayedDate;
+extern SensorHub sensorHub;
+
+// --- Heap accounting by task ---
+// Every C++ allocation carries a small header naming the task that made it, so live bytes
+// and high-water marks can be split by FreeRTOS task (lockstep runs one at a time).
+static const size_t HEAP_HEADER = 16;
+static const int HEAP_SLOTS = 8;
+
+struct HeapSlot {
+    std::atomic<const void*> task{nullptr};
+    std::atomic<int64_t> live{0};
+    std::atomic<int64_t> peak{0};
+    std::atomic<uint64_t> allocs{0};
+};
+static HeapSlot s_heapSlots[HEAP_SLOTS];
+static std::atomic<int64_t> s_heapLive{0};
+static std::atomic<int64_t> s_heapPeak{0};
+static std::atomic<int64_t> s_heapDayPeak{0};
+
+static void raise(std::atomic<int64_t>& mark, int64_t value) {
+    int64_t old = mark.load(std::memory_order_relaxed);
+    while (value > old && !mark.compare_exchange_weak(old, value, std::memory_order_relaxed)) {}
+}
+
+static int heapSlot() {
+    const void* task = xTaskGetCurrentTaskHandle();
+    for (int i = 0; i < HEAP_SLOTS - 1; i++) {
+        const void* owner = s_heapSlots[i].task.load(std::memory_order_relaxed);
+        if (owner == task) return i;
+        if (!owner && s_heapSlots[i].task.compare_exchange_strong(owner, task)) return i;
+        if (owner == task) return i;
+    }
+    return HEAP_SLOTS - 1;  // overflow bucket
+}
+
+static void* trackedAlloc(size_t n) {
+    uint8_t* p = (uint8_t*)malloc(n + HEAP_HEADER);
+    if (!p) return nullptr;
+    int slot = heapSlot();
+    ((size_t*)p)[0] = n;
+    ((size_t*)p)[1] = (size_t)slot;
+    HeapSlot& s = s_heapSlots[slot];
+    s.allocs.fetch_add(1, std::memory_order_relaxed);
+    raise(s.peak, s.live.fetch_add((int64_t)n, std::memory_order_relaxed) + (int64_t)n);
+    int64_t live = s_heapLive.fetch_add((int64_t)n, std::memory_order_relaxed) + (int64_t)n;
+    raise(s_heapPeak, live);
+    raise(s_heapDayPeak, live);
+    return p + HEAP_HEADER;
+}
+
+static void trackedFree(void* ptr) {
+    if (!ptr) return;
+    uint8_t* p = (uint8_t*)ptr - HEAP_HEADER;
+    size_t n = ((size_t*)p)[0];
+    s_heapSlots[((size_t*)p)[1]].live.fetch_sub((int64_t)n, std::memory_order_relaxed);
+    s_heapLive.fetch_sub((int64_t)n, std::memory_order_relaxed);
+    free(p);
+}
+
+void* operator new(size_t n) {
+    void* p = trackedAlloc(n);
+    if (!p) throw std::bad_alloc();
+    return p;
+}
+void* operator new[](size_t n) { return operator new(n); }
+void* operator new(size_t n, const std::nothrow_t&) noexcept { return trackedAlloc(n); }
+void* operator new[](size_t n, const std::nothrow_t&) noexcept { return trackedAlloc(n); }
+void operator delete(void* p) noexcept { trackedFree(p); }
+void operator delete[](void* p) noexcept { trackedFree(p); }
+void operator delete(void* p, size_t) noexcept { trackedFree(p); }
+void operator delete[](void* p, size_t) noexcept { trackedFree(p); }
+
+// --- Local time in the simulated zone ---
+// The firmware owns the process TZ (configTime() sets it); borrow it briefly. Lockstep means
+// no firmware thread is running while the harness does this.
+static std::string s_tz = "GMT0BST,M3.5.0/1,M10.5.0";
+
+static void withZone(const char* zone, void (*fn)(void*), void* ctx) {
+    static char saved[128];  // not on the heap: the harness stays out of the heap figures
+    const char* current = getenv("TZ");
+    if (current) snprintf(saved, sizeof(saved), "%s", current);
+    setenv("TZ", zone, 1);
+    tzset();
+    fn(ctx);
+    if (current) {
+        setenv("TZ", saved, 1);
+    } else {
+        unsetenv("TZ");
+    }
+    tzset();
+}
+
+struct LocalQuery {
+    time_t t;
+    struct tm tm;
+};
+
+static struct tm localIn(time_t t) {
+    LocalQuery q = {t, {}};
+    withZone(s_tz.c_str(), [](void* p) {
+        LocalQuery* q = static_cast<LocalQuery*>(p);
+        localtime_r(&q->t, &q->tm);
+    }, &q);
+    return q.tm;
+}
+
+static time_t makeLocal(struct tm tm) {
+    LocalQuery q = {0, tm};
+    q.tm.tm_isdst = -1;
+    withZone(s_tz.c_str(), [](void* p) {
+        LocalQuery* q = static_cast<LocalQuery*>(p);
+        q->t = mktime(&q->tm);
+    }, &q);
+    return q.t;
+}
+
+// --- Network script ---
+struct Outage {
+    time_t start, end;
+    bool internetOnly;  // router up, upstream down
+};
+
+static bool parseOutage(const char* spec, time_t day0, std::vector<Outage>& out) {
+    int day, hh, mm, minutes;
+    char kind[16] = "wifi";
+    if (sscanf(spec, "%d %d:%d %d %15s", &day, &hh, &mm, &minutes, kind) < 4) return false;
+    struct tm tm = localIn(day0);
+    tm.tm_mday += day;
+    tm.tm_hour = hh;
+    tm.tm_min = mm;
+    tm.tm_sec = 0;
+    time_t start = makeLocal(tm);
+    out.push_back({start, start + minutes * 60, strcmp(kind, "internet") == 0});
+    return true;
+}
+
+// First instant after `from` (within a year, on the hour) where the zone enters or leaves
+// DST, formatted the way timeapi.io writes dstStart/dstEnd; "" if there is none
+static std::string nextDstChange(time_t from, bool entering) {
+    bool was = localIn(from).tm_isdst > 0;
+    for (time_t t = from - from % 3600 + 3600; t < from + 366 * 86400; t += 3600) {
+        bool is = localIn(t).tm_isdst > 0;
+        if (is != was) {
+            if (is == entering) {
+                struct tm utc;
+                gmtime_r(&t, &utc);
+                char buf[32];
+                strftime(buf, sizeof(buf), "%Y-%m-%dT%H:%M:%SZ", &utc);
+                return buf;
+            }
+            was = is;
+        }
+    }
+    return "";
+}
+
+// timeapi.io's answer for the simulated zone at this moment; everything else from fixtures
+static uint32_t s_tzFetches = 0;
+
+static int soakHttp(const char* url, String& body, void*) {
+    if (!strstr(url, "://timeapi.io/")) return 0;
+    s_tzFetches++;
+    time_t now = halRealTime();
+    struct tm local = localIn(now);
+    struct tm jan = local, jul = local;
+    jan.tm_mon = 0;
+    jul.tm_mon = 6;
+    jan.tm_mday = jul.tm_mday = 15;
+    long janOff = localIn(makeLocal(jan)).tm_gmtoff;
+    long julOff = localIn(makeLocal(jul)).tm_gmtoff;
+    long stdOff = janOff < julOff ? janOff : julOff;
+    long dstOff = janOff < julOff ? julOff : janOff;
+    // The DST interval in force or coming next, like timeapi.io
+    std::string start, end;
+    if (stdOff != dstOff) {
+        // One already in force started within the last year
+        start = nextDstChange(local.tm_isdst > 0 ? now - 366 * 86400 : now, true);
+        end = nextDstChange(now, false);
+    }
+    char buf[640];
+    snprintf(buf, sizeof(buf),
+             "{\"timeZone\":\"Simulated\",\"currentUtcOffset\":{\"seconds\":%ld},"
+             "\"standardUtcOffset\":{\"seconds\":%ld},\"hasDayLightSaving\":%s,"
+             "\"isDayLightSavingActive\":%s,\"dstInterval\":{\"dstOffsetToUtc\":{\"seconds\":%ld},"
+             "\"dstStart\":\"%s\",\"dstEnd\":\"%s\"}}",
+             local.tm_gmtoff, stdOff, stdOff != dstOff ? "true" : "false", local.tm_isdst > 0 ? "true" : "false",
+             dstOff, start.c_str(), end.c_str());
+    body = String(buf);
+    return 200;
+}
+
+// Light sensor: reads lower when brighter. Night 2800 mV, day 1000 mV, hour-long ramps at
+// 07:00 and 19:00.
+static uint16_t daylightMv(const struct tm& tm) {
+    double h = tm.tm_hour + tm.tm_min / 60.0;
+    double day;
+    if (h < 6.5 || h >= 19.5) {
+        day = 0;
+    } else if (h < 7.5) {
+        day = h - 6.5;
+    } else if (h < 18.5) {
+        day = 1;
+    } else {
+        day = 19.5 - h;
+    }
+    return (uint16_t)(2800 - 1800 * day);
+}
+
+// --- Counters ---
+struct Totals {
+    uint64_t loops;
+    uint32_t draws, skipped;
+    uint32_t wxOk, wxErr, tz, http;
+    uint32_t ntpOk, ntpErr, sntp;
+    int32_t reconnects;
+    uint64_t dacFrames;
+    uint32_t sensorRuns;
+};
+
+static Totals snapshot(uint64_t loops) {
+    Totals t = {};
+    collectMetrics();  // gauges are only sampled when /api/metrics renders
+    t.loops = loops;
+    t.draws = metricSpiDrawDuration.count();
+    t.skipped = metricDisplayDrawsSkipped.value();
+    t.wxOk = metricWeatherRefreshOk.value();
+    t.wxErr = metricWeatherRefreshFailed.value();
+    t.tz = s_tzFetches;
+    t.http = halHttpRequestCount();
+    t.ntpOk = metricNtpSyncOk.value();
+    t.ntpErr = metricNtpSyncFailed.value();
+    t.sntp = halSntpRequestCount();
+    t.reconnects = metricWifiReconnects.value();
+    t.dacFrames = halDacStats().frames;
+    for (uint8_t i = 0; i < sensorHub.count(); i++) t.sensorRuns += sensorHub.stats(i).runs;
+    return t;
+}
+
+struct DayRow {
+    struct tm date;
+    Totals delta;
+    int64_t heapPeak, heapAt3;
+};
+
+static int secondsOfDay(const char* hhmmss) {
+    int h, m, s;
+    if (sscanf(hhmmss, "%d:%d:%d", &h, &m, &s) != 3) return -1;
+    return h * 3600 + m * 60 + s;
+}
+
+// hal/native/fixtures relative to this file as it was compiled
+static std::string fixturesBesideSource() {
+    std::string src = __FILE__;
+    size_t slash = src.rfind('/');
+    return (slash == std::string::npos ? std::string(".") : src.substr(0, slash)) + "/../hal/native/fixtures";
+}
+
+static void usage() {
+    fprintf(stderr,
+            "usage: soak_sim [--days N] [--start \"YYYY-MM-DD HH:MM\"] [--tz POSIX-TZ] [--step MS]\n"
+            "                [--drift PPM] [--http-ms MS] [--outage \"DAY HH:MM MINUTES wifi|internet\"]...\n"
+            "                [--no-outages] [--light MV] [--fixtures DIR] [--serial] [--trace]\n");
+}
+
+int main(int argc, char** argv) {
+    int days = 30;
+    std::string start = "2026-10-20 06:00";  // spans the end of BST in the UK and the US
+    uint32_t stepMs = 1000;
+    int32_t driftPpm = 20;
+    uint32_t httpMs = 800;
+    int lightMv = -1;
+    bool serial = false, trace = false, noOutages = false;
+    std::vector<std::string> outageSpecs;
+    std::string fixtures = fixturesBesideSource();
+
+    for (int i = 1; i < argc; i++) {
+        std::string a = argv[i];
+        bool hasValue = i + 1 < argc;
+        if (a == "--days" && hasValue) {
+            days = atoi(argv[++i]);
+        } else if (a == "--start" && hasValue) {
+            start = argv[++i];
+        } else if (a == "--tz" && hasValue) {
+            s_tz = argv[++i];
+        } else if (a == "--step" && hasValue) {
+            stepMs = (uint32_t)atol(argv[++i]);
+        } else if (a == "--drift" && hasValue) {
+            driftPpm = atoi(argv[++i]);
+        } else if (a == "--http-ms" && hasValue) {
+            httpMs = (uint32_t)atol(argv[++i]);
+        } else if (a == "--outage" && hasValue) {
+            outageSpecs.push_back(argv[++i]);
+        } else if (a == "--no-outages") {
+            noOutages = true;
+        } else if (a == "--light" && hasValue) {
+            lightMv = atoi(argv[++i]);
+        } else if (a == "--fixtures" && hasValue) {
+            fixtures = argv[++i];
+        } else if (a == "--serial") {
+            serial = true;
+        } else if (a == "--trace") {
+            trace = true;
+        } else {
+            usage();
+            return 2;
+        }
+    }
+    if (days <= 0 || stepMs < 10) {
+        usage();
+        return 2;
+    }
+
+    struct tm startTm = {};
+    if (sscanf(start.c_str(), "%d-%d-%d %d:%d", &startTm.tm_year, &startTm.tm_mon, &startTm.tm_mday,
+               &startTm.tm_hour, &startTm.tm_min) != 5) {
+        usage();
+        return 2;
+    }
+    startTm.tm_year -= 1900;
+    startTm.tm_mon -= 1;
+    time_t startEpoch = makeLocal(startTm);
+
+    if (outageSpecs.empty() && !noOutages) {
+        outageSpecs = {"3 14:00 45 wifi", "9 02:30 180 internet", "17 23:50 30 wifi"};
+    }
+    if (noOutages) outageSpecs.clear();
+    std::vector<Outage> outages;
+    for (const auto& spec : outageSpecs) {
+        if (!parseOutage(spec.c_str(), startEpoch, outages)) {
+            usage();
+            return 2;
+        }
+    }
+
+    // --- Boot ---
+    halUseVirtualClock(true);
+    halSetRealTime(startEpoch);
+    halSetClockDriftPpm(driftPpm);
+    halSetSerialOutput(serial ? stderr : nullptr);
+    if (trace) halSetTrace(stderr);
+    if (!halSetHttpFixtures(fixtures.c_str())) {
+        // Every forecast would 404 and the report would blame the firmware
+        fprintf(stderr, "soak_sim: no fixtures directory at %s (run from the repo root or pass --fixtures)\n",
+                fixtures.c_str());
+        return 2;
+    }
+    halSetHttpHandler(soakHttp, nullptr);
+    halSetHttpLatencyMs(httpMs);
+    halAddAccessPoint("SoakNet", "soak-pass");
+    {
+        Preferences prefs;
+        prefs.begin("wifi", false);
+        prefs.putString("ssid", "SoakNet");
+        prefs.putString("pass", "soak-pass");
+        prefs.end();
+    }
+    halSetAdcMilliVolts(6, (uint16_t)(lightMv >= 0 ? lightMv : daylightMv(localIn(startEpoch))));
+
+    printf("Soak: %d days from %s (TZ %s), %u ms steps, drift %d ppm, HTTP %u ms, %zu outage%s\n", days,
+           start.c_str(), s_tz.c_str(), stepMs, driftPpm, httpMs, outages.size(), outages.size() == 1 ? "" : "s");
+    for (const auto& o : outages) {
+        struct tm a = localIn(o.start);
+        printf("  outage: %s from %02d-%02d %02d:%02d for %ld min\n", o.internetOnly ? "internet" : "WiFi",
+               a.tm_mon + 1, a.tm_mday, a.tm_hour, a.tm_min, (long)(o.end - o.start) / 60);
+    }
+
+    std::vector<DayRow> rows;
+    rows.reserve(days + 2);  // allocated up front so the harness adds nothing to the heap trend
+
+    halRunTasks(true);
+    setup();
+
+    // --- Run ---
+    const uint64_t endUs = (uint64_t)days * 86400 * 1000000;
+    uint64_t loops = 0;
+    Totals dayStart = snapshot(0);
+    struct tm today = localIn(startEpoch);
+    int64_t heapAt3 = -1;
+    long gmtOffset = today.tm_gmtoff;
+    int lastMinute = -1;
+
+    double wrongClockSec = 0, maxWallErrorSec = 0;
+    time_t firstWrong = 0;
+    int midnights = 0, dateMisses = 0;
+    time_t midnightAt = 0;
+    char dateBefore[64] = "";
+
+    while (halMicros() < endUs) {
+        time_t now = halRealTime();
+
+        bool linkUp = true, internetUp = true;
+        for (const auto& o : outages) {
+            if (now < o.start || now >= o.end) continue;
+            if (o.internetOnly) {
+                internetUp = false;
+            } else {
+                linkUp = false;
+            }
+        }
+        halSetWifiLink(linkUp);
+        halSetInternet(internetUp);
+
+        uint64_t passStart = halMicros();
+        char labelBefore[64];
+        snprintf(labelBefore, sizeof(labelBefore), "%s", lastDisplayedDate.c_str());
+        loop();
+        loops++;
+
+        // Local time in the simulated zone; the offset only changes at DST transitions
+        now = halRealTime();
+        time_t nowWall = time(nullptr);
+        double wallError = fabs((double)(nowWall - now));
+        if (wallError > maxWallErrorSec && halWallClockSet()) maxWallErrorSec = wallError;
+        struct tm local;
+        int minute = (int)(now / 60);
+        if (minute != lastMinute) {
+            lastMinute = minute;
+            local = localIn(now);
+            gmtOffset = local.tm_gmtoff;
+            if (lightMv < 0) halSetAdcMilliVolts(6, daylightMv(local));
+        }
+        time_t localEpoch = now + gmtOffset;
+        gmtime_r(&localEpoch, &local);
+
+        // Clock face vs local time
+        int shown = secondsOfDay(lastDisplayedTime.c_str());
+        if (shown >= 0) {
+            int diff = shown - (local.tm_hour * 3600 + local.tm_min * 60 + local.tm_sec);
+            if (diff > 43200) diff -= 86400;
+            if (diff < -43200) diff += 86400;
+            if (abs(diff) > 2) {
+                if (!firstWrong) firstWrong = now;
+                wrongClockSec += stepMs / 1000.0;
+            }
+        }
+
+        // Midnight: the date label must change within a minute
+        if (midnightAt && strcmp(lastDisplayedDate.c_str(), dateBefore) != 0) midnightAt = 0;
+        if (midnightAt && now - midnightAt > 60) {
+            dateMisses++;
+            midnightAt = 0;
+        }
+
+        if (local.tm_hour == 3 && heapAt3 < 0) heapAt3 = s_heapLive;
+
+        if (local.tm_yday != today.tm_yday) {
+            Totals t = snapshot(loops);
+            Totals d = {t.loops - dayStart.loops, t.draws - dayStart.draws, t.skipped - dayStart.skipped,
+                        t.wxOk - dayStart.wxOk, t.wxErr - dayStart.wxErr, t.tz - dayStart.tz,
+                        t.http - dayStart.http, t.ntpOk - dayStart.ntpOk, t.ntpErr - dayStart.ntpErr,
+                        t.sntp - dayStart.sntp, t.reconnects - dayStart.reconnects,
+                        t.dacFrames - dayStart.dacFrames, t.sensorRuns - dayStart.sensorRuns};
+            rows.push_back({today, d, s_heapDayPeak, heapAt3});
+            dayStart = t;
+            today = local;
+            heapAt3 = -1;
+            s_heapDayPeak = s_heapLive.load();
+            midnights++;
+            midnightAt = now;
+            memcpy(dateBefore, labelBefore, sizeof(dateBefore));
+        }
+
+        uint64_t elapsed = halMicros() - passStart;
+        if (elapsed < stepMs * 1000ULL) delayMicroseconds((uint32_t)(stepMs * 1000ULL - elapsed));
+    }
+
+    // --- Report ---
+    printf("\nday          loops  draws/skip   wx ok/err  tz   http  ntp ok/err  sntp  reconn  chime s  sensor  heap peak/03:00 KB\n");
+    bool missedForecast = false;
+    for (size_t i = 0; i < rows.size(); i++) {
+        const DayRow& r = rows[i];
+        const Totals& d = r.delta;
+        char date[16];
+        strftime(date, sizeof(date), "%a %m-%d", &r.date);
+        char at3[16] = "-";
+        if (r.heapAt3 >= 0) snprintf(at3, sizeof(at3), "%.1f", r.heapAt3 / 1024.0);
+        printf("%-10s %7llu  %5u/%-5u %5u/%-5u %3u %6u  %4u/%-5u %5u  %6d  %7.0f  %6u  %6.1f / %s\n", date,
+               (unsigned long long)d.loops, d.draws, d.skipped, d.wxOk, d.wxErr, d.tz, d.http, d.ntpOk, d.ntpErr,
+               d.sntp, d.reconnects, d.dacFrames / (double)AudioOutput::SAMPLE_RATE, d.sensorRuns,
+               r.heapPeak / 1024.0, at3);
+        // The first (partial) day may start late; every later day needs a forecast
+        if (i > 0 && d.wxOk == 0) missedForecast = true;
+    }
+
+    printf("\nheap by task       allocs        live      peak\n");
+    for (int i = 0; i < HEAP_SLOTS; i++) {
+        const HeapSlot& s = s_heapSlots[i];
+        const void* task = s.task.load();
+        if (!task && !s.allocs) continue;
+        const char* name = i == HEAP_SLOTS - 1 ? "(other)" : pcTaskGetName((TaskHandle_t)task);
+        printf("%-16s %10llu  %8lld  %8lld\n", name, (unsigned long long)s.allocs.load(), (long long)s.live.load(),
+               (long long)s.peak.load());
+    }
+    printf("total            %10s  %8lld  %8lld\n", "", (long long)s_heapLive.load(), (long long)s_heapPeak.load());
+
+    int failures = 0;
+    printf("\n");
+    if (wrongClockSec > 0) {
+        struct tm w = localIn(firstWrong);
+        char when[32];
+        strftime(when, sizeof(when), "%m-%d %H:%M", &w);
+        printf("FAIL clock face off by more than 2 s for %.0f min in total, first at %s\n", wrongClockSec / 60, when);
+        failures++;
+    } else {
+        printf("ok   clock face within 2 s of local time (wall clock error max %.0f s)\n", maxWallErrorSec);
+    }
+    if (dateMisses) {
+        printf("FAIL date label late at %d of %d midnights\n", dateMisses, midnights);
+        failures++;
+    } else {
+        printf("ok   date label changed within a minute at all %d midnights\n", midnights);
+    }
+    if (missedForecast) {
+        printf("FAIL a full day passed without a successful forecast refresh\n");
+        failures++;
+    } else {
+        printf("ok   forecast refreshed every day\n");
+    }
+    if (rows.size() >= 3 && rows[1].heapAt3 >= 0 && rows.back().heapAt3 >= 0) {
+        int64_t growth = rows.back().heapAt3 - rows[1].heapAt3;
+        bool leak = growth > 2048;
+        printf("%s heap at 03:00 changed by %+lld bytes from day 2 to day %zu\n", leak ? "FAIL" : "ok  ",
+               (long long)growth, rows.size());
+        if (leak) failures++;
+    }
+
+    printf("\n%s (%d failing check%s)\n", failures ? "FAIL" : "OK", failures, failures == 1 ? "" : "s");
+    fflush(stdout);
+    _exit(failures ? 1 : 0);  // task threads are parked mid-call; skip static destructors
+}
@@ -0,0 +1,318 @@
+// Replays raw touch traces recorded on the device through the firmware's touch pipeline:
+// TouchSampler (pressure gate, median + IIR filter, press/move/release decisions), the
+// calibration matrix and GestureEngine, exactly as the sensor hub and loop() run them.
+//
+//   g++ -O2 -std=gnu++17 -Isrc tools/touch_replay.cpp -o touch_replay
+//   ./touch_replay touchtrace.txt            # replay a trace (or - for stdin)
+//   ./touch_replay --bench touchtrace.txt    # also time the pipeline per reading
+//   ./touch_replay --selftest                # synthetic traces with known answers
+//
+// Record a trace in touch debug mode (triple-tap the version label) by long-pressing the
+// status bar, touch away, long-press it again, then fetch it from /api/touch/trace. The
+// format is described in src/TouchRecorder.h.
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+#include "GestureEngine.h"
+#include "TouchCalibration.h"
+#include "TouchSampler.h"
+
+static const uint32_t TICK_US = 5000;
+
+struct Reading {
+    char kind;  // 'D' or 'S'
+    int16_t x, y, z;
+    bool pen;
+    uint32_t us;
+};
+
+struct Trace {
+    TouchMatrix matrix = TouchCalibration::fromRange(200, 3700, 240, 3800);  // firmware default
+    std::vector<Reading> readings;
+};
+
+struct Result {
+    std::vector<TouchEvent> events;
+    std::vector<Gesture> gestures;
+    std::vector<uint32_t> pressDelayUs;  // pen-down edge to the reading that produced the press
+    size_t bursts = 0;
+};
+
+// Same order of operations as the device: the task runs the sampler on each reading and
+// queues events; loop() calibrates them, feeds the engine and ticks it every ~5 ms
+class Pipeline {
+    TouchSampler _sampler;
+    GestureEngine _engine;
+    TouchMatrix _matrix;
+    Result* _out;
+    bool _inBurst = false;
+    bool _started = false;
+    uint32_t _nowUs = 0;
+    uint32_t _downUs = 0;
+
+    void drain() {
+        Gesture g;
+        while (_engine.poll(g)) {
+            if (_out) _out->gestures.push_back(g);
+        }
+    }
+
+    void advanceTo(uint32_t us) {
+        if (_started) {
+            while ((int32_t)(us - _nowUs) > (int32_t)TICK_US) {
+                _nowUs += TICK_US;
+                _engine.tick(_nowUs);
+                drain();
+            }
+        }
+        _nowUs = us;
+        _started = true;
+        _engine.tick(_nowUs);
+        drain();
+    }
+
+    void deliver(const RawTouch& raw, uint32_t sampleUs) {
+        TouchEvent e;
+        e.type = raw.type;
+        e.timestampUs = raw.timestampUs;
+        TouchCalibration::apply(_matrix, raw.x, raw.y, e.x, e.y);
+        if (_out) {
+            _out->events.push_back(e);
+            if (raw.type == TOUCH_PRESS) _out->pressDelayUs.push_back(sampleUs - _downUs);
+        }
+        _engine.feed(e);
+        drain();
+    }
+
+    void endBurst(uint32_t us) {
+        RawTouch raw;
+        if (_sampler.finish(us, raw)) deliver(raw, us);
+        _inBurst = false;
+    }
+
+public:
+    Pipeline(const TouchMatrix& matrix, Result* out) : _matrix(matrix), _out(out) {}
+
+    void feed(const Reading& r) {
+        if (r.kind == 'D') {
+            if (_inBurst) endBurst(r.us);  // truncated burst (recording stopped mid-touch)
+            _sampler.begin(r.us);
+            _downUs = r.us;
+            _inBurst = true;
+            if (_out) _out->bursts++;
+            return;
+        }
+        if (!_inBurst) return;
+        advanceTo(r.us);
+        RawTouch raw;
+        if (_sampler.sample(r.x, r.y, r.z, r.pen, r.us, raw)) deliver(raw, r.us);
+        if (_sampler.done()) endBurst(r.us);
+    }
+
+    void finish() {
+        if (_inBurst) endBurst(_nowUs);
+        advanceTo(_nowUs + 3000000);
+    }
+};
+
+static Result run(const Trace& trace) {
+    Result result;
+    Pipeline pipeline(trace.matrix, &result);
+    for (const Reading& r : trace.readings) pipeline.feed(r);
+    pipeline.finish();
+    return result;
+}
+
+static bool load(const char* path, Trace& trace) {
+    FILE* f = strcmp(path, "-") == 0 ? stdin : fopen(path, "r");
+    if (!f) {
+        fprintf(stderr, "Cannot open %s\n", path);
+        return false;
+    }
+    char line[256];
+    while (fgets(line, sizeof(line), f)) {
+        long m[6];
+        int x, y, z, pen;
+        unsigned long us;
+        if (line[0] == 'M' && sscanf(line + 1, "%ld %ld %ld %ld %ld %ld", &m[0], &m[1], &m[2], &m[3], &m[4], &m[5]) == 6) {
+            trace.matrix = {(int32_t)m[0], (int32_t)m[1], (int32_t)m[2], (int32_t)m[3], (int32_t)m[4], (int32_t)m[5]};
+        } else if (line[0] == 'D' && sscanf(line + 1, "%lu", &us) == 1) {
+            trace.readings.push_back({'D', 0, 0, 0, true, (uint32_t)us});
+        } else if (line[0] == 'S' && sscanf(line + 1, "%d %d %d %d %lu", &x, &y, &z, &pen, &us) == 5) {
+            trace.readings.push_back({'S', (int16_t)x, (int16_t)y, (int16_t)z, pen != 0, (uint32_t)us});
+        }
+    }
+    if (f != stdin) fclose(f);
+    return true;
+}
+
+static void printGestures(const std::vector<Gesture>& gestures, uint32_t originUs) {
+    for (const Gesture& g : gestures) {
+        printf("%10.3f ms  %-11s at (%3u,%3u)", (uint32_t)(g.timestampUs - originUs) / 1000.0,
+               GestureEngine::name(g.type), g.x, g.y);
+        if (g.dx || g.dy) printf("  d=(%d,%d)", g.dx, g.dy);
+        printf("\n");
+    }
+}
+
+static int replayFile(const char* path, bool bench) {
+    Trace trace;
+    if (!load(path, trace)) return 2;
+    Result result = run(trace);
+    uint32_t originUs = trace.readings.empty() ? 0 : trace.readings[0].us;
+
+    printf("%zu readings in %zu bursts -> %zu events -> %zu gestures\n", trace.readings.size() - result.bursts,
+           result.bursts, result.events.size(), result.gestures.size());
+    if (!result.pressDelayUs.empty()) {
+        uint64_t sum = 0;
+        uint32_t lo = UINT32_MAX, hi = 0;
+        for (uint32_t d : result.pressDelayUs) {
+            sum += d;
+            if (d < lo) lo = d;
+            if (d > hi) hi = d;
+        }
+        printf("pen-down to press: min %.1f ms, mean %.1f ms, max %.1f ms\n", lo / 1000.0,
+               sum / 1000.0 / result.pressDelayUs.size(), hi / 1000.0);
+    }
+    printGestures(result.gestures, originUs);
+
+    if (bench && !trace.readings.empty()) {
+        const int reps = 200;
+        auto t0 = std::chrono::steady_clock::now();
+        for (int i = 0; i < reps; i++) {
+            Pipeline pipeline(trace.matrix, nullptr);
+            for (const Reading& r : trace.readings) pipeline.feed(r);
+            pipeline.finish();
+        }
+        double ns = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - t0).count();
+        printf("pipeline: %.1f ns per reading (host, %d passes)\n", ns / reps / trace.readings.size(), reps);
+    }
+    return 0;
+}
+
+// --- Synthetic traces ---
+
+// Draws readings the way the XPT2046 produces them: +/-noise around the true position,
+// 5 ms apart, then two pen-up readings. Positions are in screen pixels, converted to raw
+// units with the inverse of the default matrix.
+struct Synth {
+    Trace trace;
+    uint32_t t = 1000000;
+    uint32_t seed = 12345;
+    int noise = 12;  // raw counts, ~1 px
+
+    int rnd(int span) {
+        seed = seed * 1103515245u + 12345u;
+        return span ? (int)((seed >> 16) % (2 * span + 1)) - span : 0;
+    }
+    static int16_t rawX(double px) { return (int16_t)(200 + px * 3500 / 320); }
+    static int16_t rawY(double py) { return (int16_t)(240 + py * 3560 / 240); }
+
+    void wait(uint32_t ms) { t += ms * 1000; }
+
+    // A stroke from (x0,y0) to (x1,y1) over ms; spikeEvery > 0 injects a wild reading
+    void stroke(double x0, double y0, double x1, double y1, uint32_t ms, int16_t z = 900, int spikeEvery = 0) {
+        trace.readings.push_back({'D', 0, 0, 0, true, t});
+        uint32_t n = ms / 5 + 1;
+        for (uint32_t i = 0; i < n; i++) {
+            double f = n > 1 ? (double)i / (n - 1) : 0;
+            int16_t x = (int16_t)(rawX(x0 + (x1 - x0) * f) + rnd(noise));
+            int16_t y = (int16_t)(rawY(y0 + (y1 - y0) * f) + rnd(noise));
+            if (spikeEvery && (int)(i % spikeEvery) == spikeEvery - 1) x = (int16_t)(x + 900);
+            trace.readings.push_back({'S', x, y, z, true, t});
+            wait(5);
+        }
+        for (int i = 0; i < 2; i++) {
+            trace.readings.push_back({'S', 0, 0, 0, false, t});
+            wait(5);
+        }
+    }
+    void tap(double x, double y, uint32_t ms = 80) { stroke(x, y, x, y, ms); }
+
+    // PENIRQ edge with nothing readable behind it
+    void glitch() {
+        trace.readings.push_back({'D', 0, 0, 0, true, t});
+        for (int i = 0; i < 2; i++) {
+            trace.readings.push_back({'S', 0, 0, 0, false, t});
+            wait(5);
+        }
+    }
+};
+
+struct Case {
+    const char* name;
+    void (*run)(Synth&);
+    std::vector<GestureType> expected;
+    int maxMoves;  // -1: don't care
+};
+
+static int selfTest() {
+    const Case cases[] = {
+        {"tap", [](Synth& s) { s.tap(160, 120); }, {GESTURE_TAP}, 0},
+        {"noisy tap stays still", [](Synth& s) { s.noise = 25; s.tap(160, 120, 300); }, {GESTURE_TAP}, 0},
+        {"spikes are rejected", [](Synth& s) { s.stroke(160, 120, 160, 120, 300, 900, 7); }, {GESTURE_TAP}, 0},
+        {"light brush is gated", [](Synth& s) { s.stroke(160, 120, 160, 120, 200, 350); }, {}, 0},
+        {"IRQ glitch", [](Synth& s) { s.glitch(); }, {}, 0},
+        {"triple tap", [](Synth& s) { for (int i = 0; i < 3; i++) { s.tap(300, 27); s.wait(150); } },
+         {GESTURE_TAP, GESTURE_DOUBLE_TAP, GESTURE_TRIPLE_TAP}, 0},
+        {"long press", [](Synth& s) { s.tap(30, 20, 2500); }, {GESTURE_LONG_PRESS}, 0},
+        {"swipe left", [](Synth& s) { s.stroke(250, 120, 100, 125, 200); }, {GESTURE_SWIPE_LEFT}, -1},
+        {"swipe up", [](Synth& s) { s.stroke(160, 200, 165, 60, 250); }, {GESTURE_SWIPE_UP}, -1},
+    };
+
+    int failures = 0;
+    for (const Case& c : cases) {
+        Synth s;
+        c.run(s);
+        Result r = run(s.trace);
+        int moves = 0;
+        for (const TouchEvent& e : r.events) moves += e.type == TOUCH_MOVE;
+        bool ok = r.gestures.size() == c.expected.size() && (c.maxMoves < 0 || moves <= c.maxMoves);
+        for (size_t i = 0; ok && i < r.gestures.size(); i++) ok = r.gestures[i].type == c.expected[i];
+        printf("%-28s %s\n", c.name, ok ? "ok" : "FAIL");
+        if (!ok) {
+            failures++;
+            printf("  %zu events (%d moves); expected:", r.events.size(), moves);
+            for (GestureType t : c.expected) printf(" %s", GestureEngine::name(t));
+            printf("\n  got:\n");
+            printGestures(r.gestures, 1000000);
+        }
+    }
+
+    // Position accuracy through filter and default calibration
+    {
+        Synth s;
+        s.noise = 25;
+        s.tap(300, 27, 150);
+        Result r = run(s.trace);
+        bool ok = r.gestures.size() == 1 && abs(r.gestures[0].x - 300) <= 2 && abs(r.gestures[0].y - 27) <= 2;
+        printf("%-28s %s (at %u,%u)\n", "tap lands on target", ok ? "ok" : "FAIL",
+               r.gestures.empty() ? 0 : r.gestures[0].x, r.gestures.empty() ? 0 : r.gestures[0].y);
+        if (!ok) failures++;
+    }
+
+    // The press must not wait for the median window to fill
+    {
+        Synth s;
+        s.tap(160, 120);
+        Result r = run(s.trace);
+        uint32_t delay = r.pressDelayUs.empty() ? UINT32_MAX : r.pressDelayUs[0];
+        bool ok = delay <= (TouchFilter::SETTLE_SAMPLES + 1) * TICK_US;
+        printf("%-28s %s (%.1f ms)\n", "press reported promptly", ok ? "ok" : "FAIL", delay / 1000.0);
+        if (!ok) failures++;
+    }
+
+    printf("\n%s (%d failing case%s)\n", failures ? "FAIL" : "OK", failures, failures == 1 ? "" : "s");
+    return failures ? 1 : 0;
+}
+
+int main(int argc, char** argv) {
+    if (argc == 2 && strcmp(argv[1], "--selftest") == 0) return selfTest();
+    if (argc == 3 && strcmp(argv[1], "--bench") == 0) return replayFile(argv[2], true);
+    if (argc == 2) return replayFile(argv[1], false);
+    fprintf(stderr, "usage: %s [--bench] <touchtrace.txt | -> | --selftest\n", argv[0]);
+    return 2;
+}